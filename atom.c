@@ -0,0 +1,283 @@
+/** Projekt IFJ2023
+ * @file atom.c
+ * @brief Tabuľka atómov - jedinečné (internované) kópie identifikátorov a kódových mien
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atom.h"
+#include "strR.h"
+#include "mem.h"
+
+/**
+ * @brief Blok pamäte, do ktorého sa za sebou ukladajú atómy
+ */
+typedef struct atom_block {
+    struct atom_block *next;    ///< predchádzajúci (plný) blok
+    size_t size;                ///< veľkosť poľa data
+    size_t used;                ///< počet obsadených bajtov
+    _Alignas(atom_T) char data[];
+} atomBlock_T;
+
+/**
+ * @brief Tabuľka atómov
+ * @details Rozptylová tabuľka slots (otvorené adresovanie, lineárne skúšanie) je zaplnená najviac
+ * do polovice. Atómy sa nikdy neodstraňujú, preto sa pri zväčšení iba presunú ukazatele.
+ */
+static struct {
+    atom_T **slots;         ///< rozptylová tabuľka, NULL značí voľné miesto
+    size_t size;            ///< počet položiek tabuľky, mocnina dvojky
+    size_t used;            ///< počet atómov
+    atomBlock_T *blocks;    ///< aktuálne plnený blok, ostatné sú za ním
+    atom_T **by_id;         ///< atómy v poradí vytvorenia, index je atom->id
+    size_t by_id_size;      ///< alokovaná kapacita poľa by_id
+} pool = {NULL, 0, 0, NULL, NULL, 0};
+
+/**
+ * @brief Ukončí prekladač pri chybe alokácie
+ */
+static void AtomAllocError(const char *fn) {
+    fprintf(stderr, "%s() memory allocation error\n", fn);
+    exit(99);
+}
+
+/**
+ * @brief Vráti index atómu s daným textom alebo index voľnej položky, kam by patril
+ */
+static size_t AtomSlot(const char *text, size_t len, unsigned long hash) {
+    size_t mask = pool.size - 1;
+    size_t index = hash & mask;
+    while (pool.slots[index] != NULL) {
+        atom_T *atom = pool.slots[index];
+        if (atom->hash == hash && atom->len == len && memcmp(atom->text, text, len) == 0) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+/**
+ * @brief Zdvojnásobí rozptylovú tabuľku, prípadne ju vytvorí
+ */
+static void AtomPoolGrow() {
+    size_t new_size = pool.size == 0 ? ATOM_POOL_INIT_SIZE : 2 * pool.size;
+    atom_T **new_slots = memCalloc(MEM_ATOM, new_size, sizeof(atom_T *));
+    if (new_slots == NULL) AtomAllocError("AtomPoolGrow");
+
+    for (size_t i = 0; i < pool.size; i++) {
+        if (pool.slots[i] == NULL) continue;
+        size_t index = pool.slots[i]->hash & (new_size - 1);
+        while (new_slots[index] != NULL) {
+            index = (index + 1) & (new_size - 1);
+        }
+        new_slots[index] = pool.slots[i];
+    }
+
+    memFree(MEM_ATOM, pool.slots);
+    pool.slots = new_slots;
+    pool.size = new_size;
+}
+
+/**
+ * @brief Určí druh kódového mena podľa prefixu dĺžky prefix_len pred znakom '@'
+ */
+static atomKind_T AtomClassifyCode(const char *text, size_t prefix_len) {
+#define ATOM_PREFIX(word, kind) return memcmp(text, word, prefix_len) == 0 ? kind : ATOM_ID
+    switch (prefix_len) {
+    case 2:
+        if (text[1] != 'F') break;
+        switch (text[0]) {
+        case 'G': return ATOM_VAR_GF;
+        case 'L': return ATOM_VAR_LF;
+        case 'T': return ATOM_VAR_TF;
+        }
+        break;
+    case 3:
+        if (text[0] == 'i') ATOM_PREFIX("int", ATOM_CONST_INT);
+        ATOM_PREFIX("nil", ATOM_CONST_NIL);
+    case 4: ATOM_PREFIX("bool", ATOM_CONST_BOOL);
+    case 5: ATOM_PREFIX("float", ATOM_CONST_FLOAT);
+    case 6: ATOM_PREFIX("string", ATOM_CONST_STRING);
+    }
+#undef ATOM_PREFIX
+    return ATOM_ID;
+}
+
+/**
+ * @brief Určí druh atómu podľa jeho textu
+ * @details Identifikátory neobsahujú '@', text so znakom '@' je preto kódové meno. Slová sa rozlíšia podľa dĺžky a prvého znaku, zvyšok textu sa porovná najviac s jedným kandidátom.
+ */
+static atomKind_T AtomClassify(const char *text, size_t len) {
+    const char *at = memchr(text, '@', len);
+    if (at != NULL) return AtomClassifyCode(text, at - text);
+#define ATOM_WORD(word, kind) return memcmp(text, word, len) == 0 ? kind : ATOM_ID
+    switch (len) {
+    case 2:
+        if (text[0] == 'i') ATOM_WORD("if", ATOM_KW_IF);
+        break;
+    case 3:
+        switch (text[0]) {
+        case 'I': ATOM_WORD("Int", ATOM_KW_INT);
+        case 'l': ATOM_WORD("let", ATOM_KW_LET);
+        case 'n': ATOM_WORD("nil", ATOM_KW_NIL);
+        case 'o': ATOM_WORD("ord", ATOM_BIF_ORD);
+        case 'v': ATOM_WORD("var", ATOM_KW_VAR);
+        case 'c': ATOM_WORD("chr", ATOM_BIF_CHR);
+        }
+        break;
+    case 4:
+        switch (text[0]) {
+        case 'e': ATOM_WORD("else", ATOM_KW_ELSE);
+        case 'f': ATOM_WORD("func", ATOM_KW_FUNC);
+        }
+        break;
+    case 5:
+        switch (text[0]) {
+        case 'w':
+            if (text[1] == 'h') ATOM_WORD("while", ATOM_KW_WHILE);
+            ATOM_WORD("write", ATOM_BIF_WRITE);
+        }
+        break;
+    case 6:
+        switch (text[0]) {
+        case 'D': ATOM_WORD("Double", ATOM_KW_DOUBLE);
+        case 'r': ATOM_WORD("return", ATOM_KW_RETURN);
+        case 'S': ATOM_WORD("String", ATOM_KW_STRING);
+        case 'l': ATOM_WORD("length", ATOM_BIF_LENGTH);
+        }
+        break;
+    case 7:
+        if (text[0] == 'r') ATOM_WORD("readInt", ATOM_BIF_READINT);
+        break;
+    case 9:
+        if (text[0] == 's') ATOM_WORD("substring", ATOM_BIF_SUBSTRING);
+        break;
+    case 10:
+        switch (text[0]) {
+        case 'r':
+            if (text[4] == 'S') ATOM_WORD("readString", ATOM_BIF_READSTRING);
+            ATOM_WORD("readDouble", ATOM_BIF_READDOUBLE);
+        case 'I': ATOM_WORD("Int2Double", ATOM_BIF_INT2DOUBLE);
+        case 'D': ATOM_WORD("Double2Int", ATOM_BIF_DOUBLE2INT);
+        }
+        break;
+    }
+#undef ATOM_WORD
+    return ATOM_ID;
+}
+
+/**
+ * @brief Vyhradí miesto pre atóm s textom dĺžky len
+ */
+static atom_T *AtomAlloc(size_t len) {
+    // zarovnanie, aby ďalší atóm v bloku začínal na správnej adrese
+    size_t need = (sizeof(atom_T) + len + 1 + _Alignof(atom_T) - 1) & ~(_Alignof(atom_T) - 1);
+    atomBlock_T *block = pool.blocks;
+    if (block == NULL || block->size - block->used < need) {
+        size_t size = need > ATOM_POOL_BLOCK_SIZE ? need : ATOM_POOL_BLOCK_SIZE;
+        block = memMalloc(MEM_ATOM, sizeof(atomBlock_T) + size);
+        if (block == NULL) AtomAllocError("AtomIntern");
+        block->next = pool.blocks;
+        block->size = size;
+        block->used = 0;
+        pool.blocks = block;
+    }
+    atom_T *atom = (atom_T *)(block->data + block->used);
+    block->used += need;
+    return atom;
+}
+
+atom_T *AtomIntern(const char *text) {
+    return AtomInternHashed(text, strlen(text), StrHash(text));
+}
+
+atom_T *AtomInternHashed(const char *text, size_t len, unsigned long hash) {
+    if (2 * (pool.used + 1) > pool.size) {
+        AtomPoolGrow();
+    }
+
+    size_t index = AtomSlot(text, len, hash);
+    if (pool.slots[index] != NULL) {
+        return pool.slots[index];
+    }
+
+    atom_T *atom = AtomAlloc(len);
+    atom->hash = hash;
+    atom->len = len;
+    atom->kind = AtomClassify(text, len);
+    memcpy(atom->text, text, len);
+    atom->text[len] = '\0';
+
+    if (pool.used == pool.by_id_size) {
+        pool.by_id_size = pool.by_id_size == 0 ? ATOM_POOL_INIT_SIZE : 2 * pool.by_id_size;
+        atom_T **by_id = memRealloc(MEM_ATOM, pool.by_id, pool.by_id_size * sizeof(atom_T *));
+        if (by_id == NULL) AtomAllocError("AtomIntern");
+        pool.by_id = by_id;
+    }
+    atom->id = pool.used;
+    pool.by_id[atom->id] = atom;
+
+    pool.slots[index] = atom;
+    pool.used++;
+    return atom;
+}
+
+atom_T *AtomFind(const char *text, unsigned long hash) {
+    if (pool.slots == NULL) {
+        return NULL;
+    }
+    return pool.slots[AtomSlot(text, strlen(text), hash)];
+}
+
+atom_T *AtomById(unsigned int id) {
+    return pool.by_id[id];
+}
+
+void AtomPoolDestroy() {
+    while (pool.blocks != NULL) {
+        atomBlock_T *next = pool.blocks->next;
+        memFree(MEM_ATOM, pool.blocks);
+        pool.blocks = next;
+    }
+    memFree(MEM_ATOM, pool.slots);
+    memFree(MEM_ATOM, pool.by_id);
+    pool.slots = NULL;
+    pool.size = 0;
+    pool.used = 0;
+    pool.by_id = NULL;
+    pool.by_id_size = 0;
+}
+
+void AtomListInit(atomList_T *list) {
+    list->items = NULL;
+    list->used = 0;
+    list->size = 0;
+}
+
+void AtomListAppend(atomList_T *list, atom_T *atom) {
+    if (list->used == list->size) {
+        list->size = list->size == 0 ? 4 : 2 * list->size;
+        list->items = memRealloc(MEM_ATOM, list->items, list->size * sizeof(atom_T *));
+        if (list->items == NULL) AtomAllocError("AtomListAppend");
+    }
+    list->items[list->used++] = atom;
+}
+
+bool AtomListHasDuplicates(atomList_T *list, atom_T *ignore) {
+    for (size_t i = 0; i < list->used; i++) {
+        if (list->items[i] == ignore) continue;
+        for (size_t j = i + 1; j < list->used; j++) {
+            if (list->items[i] == list->items[j]) return true;
+        }
+    }
+    return false;
+}
+
+void AtomListDestroy(atomList_T *list) {
+    memFree(MEM_ATOM, list->items);
+    AtomListInit(list);
+}
+
+/* Koniec súboru atom.c */
@@ -0,0 +1,138 @@
+/** Projekt IFJ2023
+ * @file atom.h
+ * @brief Tabuľka atómov - jedinečné (internované) kópie identifikátorov a kódových mien
+ */
+
+#ifndef _ATOM_H_
+#define _ATOM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ATOM_POOL_INIT_SIZE 1024     ///< počiatočná veľkosť rozptylovej tabuľky atómov, mocnina dvojky
+#define ATOM_POOL_BLOCK_SIZE 65536   ///< minimálna veľkosť bloku, do ktorého sa ukladajú atómy
+
+/**
+ * @brief Druh atómu, určený jediný raz pri jeho vytvorení
+ * @details Kľúčové slová (vrátane názvov typov) a názvy vstavaných funkcií majú vlastný druh, kódové mená
+ * cieľového kódu (napr. "GF@x$1", "int@5") druh podľa rámca, resp. typu konštanty. Ďalšie fázy prekladu preto namiesto porovnávania reťazcov iba rozvetvia výpočet podľa druhu atómu.
+ */
+typedef enum atom_kinds {
+    ATOM_ID = 0,            ///< obyčajný identifikátor alebo kódové meno
+    // kľúčové slová
+    ATOM_KW_DOUBLE,
+    ATOM_KW_ELSE,
+    ATOM_KW_FUNC,
+    ATOM_KW_IF,
+    ATOM_KW_INT,
+    ATOM_KW_LET,
+    ATOM_KW_NIL,
+    ATOM_KW_RETURN,
+    ATOM_KW_STRING,
+    ATOM_KW_VAR,
+    ATOM_KW_WHILE,
+    // vstavané funkcie
+    ATOM_BIF_READSTRING,
+    ATOM_BIF_READINT,
+    ATOM_BIF_READDOUBLE,
+    ATOM_BIF_WRITE,
+    ATOM_BIF_INT2DOUBLE,
+    ATOM_BIF_DOUBLE2INT,
+    ATOM_BIF_LENGTH,
+    ATOM_BIF_SUBSTRING,
+    ATOM_BIF_ORD,
+    ATOM_BIF_CHR,
+    // kódové mená cieľového kódu, poradie rovnaké ako frames a const_kinds v generator.h
+    ATOM_VAR_GF,            ///< premenná "GF@..."
+    ATOM_VAR_LF,
+    ATOM_VAR_TF,
+    ATOM_CONST_INT,         ///< konštanta "int@..."
+    ATOM_CONST_FLOAT,
+    ATOM_CONST_STRING,
+    ATOM_CONST_BOOL,
+    ATOM_CONST_NIL
+} atomKind_T;
+
+#define ATOM_IS_KEYWORD(kind) ((kind) >= ATOM_KW_DOUBLE && (kind) <= ATOM_KW_WHILE)    ///< atóm je kľúčové slovo
+#define ATOM_IS_BIF(kind) ((kind) >= ATOM_BIF_READSTRING && (kind) <= ATOM_BIF_CHR)   ///< atóm je názov vstavanej funkcie
+#define ATOM_IS_VAR(kind) ((kind) >= ATOM_VAR_GF && (kind) <= ATOM_VAR_TF)            ///< atóm je premenná cieľového kódu
+#define ATOM_IS_CONST(kind) ((kind) >= ATOM_CONST_INT && (kind) <= ATOM_CONST_NIL)    ///< atóm je konštanta cieľového kódu
+
+/**
+ * @brief Atóm - jediná kópia reťazca v celom prekladači
+ * @details Rovnaký text je vždy uložený v tom istom atóme, dva atómy sú preto zhodné práve vtedy,
+ * keď sú zhodné ich ukazatele. Atóm je platný až do zavolania AtomPoolDestroy.
+ */
+typedef struct atom {
+    unsigned long hash; ///< StrHash(text)
+    size_t len;         ///< dĺžka textu bez znaku \0
+    atomKind_T kind;    ///< druh atómu
+    unsigned int id;    ///< poradie vytvorenia atómu, viď. AtomById
+    char text[];        ///< text atómu ukončený znakom \0
+} atom_T;
+
+/**
+ * @brief Dynamické pole atómov
+ */
+typedef struct atom_list {
+    atom_T **items; ///< atómy v poradí vloženia
+    size_t used;    ///< počet atómov
+    size_t size;    ///< alokovaná kapacita poľa
+} atomList_T;
+
+/**
+ * @brief Vráti atóm s daným textom, ak ešte neexistuje, vytvorí ho
+ * @param text reťazec ukončený znakom \0
+ */
+atom_T *AtomIntern(const char *text);
+
+/**
+ * @brief AtomIntern s už známou dĺžkou a rozptylovou hodnotou textu
+ * @details Text sa číta iba pri porovnaní s atómom s rovnakou rozptylovou hodnotou, prípadne pri kopírovaní.
+ * @param len dĺžka textu
+ * @param hash StrHash(text)
+ */
+atom_T *AtomInternHashed(const char *text, size_t len, unsigned long hash);
+
+/**
+ * @brief Vyhľadá atóm s daným textom bez jeho vytvorenia
+ * @param hash StrHash(text)
+ * @return atóm alebo NULL, ak taký text ešte nebol internovaný
+ */
+atom_T *AtomFind(const char *text, unsigned long hash);
+
+/**
+ * @brief Vráti atóm podľa poradia jeho vytvorenia
+ * @details Index zaberá menej miesta ako ukazateľ, generátor si ho preto ukladá do operandov inštrukcií.
+ * @param id atom->id existujúceho atómu
+ */
+atom_T *AtomById(unsigned int id);
+
+/**
+ * @brief Uvoľní všetky atómy, predtým vrátené ukazatele prestávajú byť platné
+ */
+void AtomPoolDestroy();
+
+/**
+ * @brief Inicializuje prázdne pole atómov
+ */
+void AtomListInit(atomList_T *list);
+
+/**
+ * @brief Pridá atóm na koniec poľa
+ */
+void AtomListAppend(atomList_T *list, atom_T *atom);
+
+/**
+ * @brief Zistí, či sa v poli opakuje niektorý atóm, atóm ignore sa nekontroluje
+ * @param ignore atóm, ktorý sa smie opakovať (napr. "_"), alebo NULL
+ */
+bool AtomListHasDuplicates(atomList_T *list, atom_T *ignore);
+
+/**
+ * @brief Uvoľní pole, samotné atómy ostávajú v tabuľke atómov
+ */
+void AtomListDestroy(atomList_T *list);
+
+#endif // ifndef _ATOM_H_
+/* Koniec súboru atom.h */
@@ -50,11 +50,7 @@ char *string_codes[] = {
  * @param string připojovaný řetězec
  */
 void strAdd(str_T * dest, char * string) {
-    str_T str;
-    StrInit(&str);
-    StrFillWith(&str, string);
-    StrCat(dest, &str);
-    StrDestroy(&str);
+    StrCatString(dest, string);
 }
 
 str_T strEncode(char * string) {
@@ -0,0 +1,251 @@
+/** Projekt IFJ2023
+ * @file emit.c
+ * @brief Výstup cieľového kódu cez veľké vyrovnávacie pamäte
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+#include "emit.h"
+#include "parser.h"
+#include "mem.h"
+
+/**
+ * @brief Cieľ zápisu, súbor so svojimi vyrovnávacími pamäťami
+*/
+typedef struct {
+    int fd;                         ///< výstupný súbor
+    bool file;                      ///< fd bol otvorený cez emitOpen alebo emitSpillBegin
+    char *buffers[EMIT_BUFFERS];    ///< vyrovnávacie pamäte, alokované pri prvom použití
+    size_t current;                 ///< index plnenej vyrovnávacej pamäte
+    size_t fill;                    ///< počet bajtov v plnenej vyrovnávacej pamäti
+    size_t bytes;                   ///< počet bajtov odovzdaných na výstup
+} emitTarget_T;
+
+/// Výstup prekladača
+static emitTarget_T out = {STDOUT_FILENO, false, {NULL}, 0, 0, 0};
+
+/// Odkladací súbor pre kód hlavného tela, vytvorený pri prvom použití
+static emitTarget_T spill = {-1, false, {NULL}, 0, 0, 0};
+
+/// Cieľ, do ktorého práve smeruje emitText
+static emitTarget_T *target = &out;
+
+static struct timespec start;   ///< čas prvého zápisu na výstup
+static double seconds = 0.0;    ///< trvanie výstupu, známe po emitClose
+
+/**
+ * @brief Ukončí prekladač pri chybe zápisu alebo alokácie
+*/
+static void emitError(const char *fn, const char *what) {
+    fprintf(stderr, "%s() %s\n", fn, what);
+    exit(COMPILER_ERROR);
+}
+
+/**
+ * @brief Začne nový výstup do súboru fd
+*/
+static void emitStart(int fd, bool file) {
+    out.fd = fd;
+    out.file = file;
+    out.current = 0;
+    out.fill = 0;
+    out.bytes = 0;
+    seconds = 0.0;
+    target = &out;
+}
+
+void emitInit() {
+    emitStart(STDOUT_FILENO, false);
+}
+
+bool emitOpen(const char *path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    emitStart(fd, true);
+    return true;
+}
+
+void emitReserve(size_t expected) {
+    // predalokovanie nie je podporované všetkými súborovými systémami, zápis funguje aj bez neho
+    if (out.file && expected > 0) posix_fallocate(out.fd, 0, (off_t)expected);
+}
+
+/**
+ * @brief Zapíše vyrovnávacie pamäte cieľa t jedným volaním writev
+*/
+static void emitFlushTarget(emitTarget_T *t) {
+    struct iovec iov[EMIT_BUFFERS];
+    int count = 0;
+    for (size_t i = 0; i <= t->current && i < EMIT_BUFFERS; i++) {
+        size_t len = i < t->current ? EMIT_BUFFER_SIZE : t->fill;
+        if (len == 0) continue;
+        iov[count].iov_base = t->buffers[i];
+        iov[count].iov_len = len;
+        count++;
+    }
+
+    // writev môže zapísať iba časť, zvyšok sa zapíše ďalším volaním
+    struct iovec *next = iov;
+    while (count > 0) {
+        ssize_t written = writev(t->fd, next, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            emitError("emitFlush", strerror(errno));
+        }
+        while (count > 0 && (size_t)written >= next->iov_len) {
+            written -= next->iov_len;
+            next++;
+            count--;
+        }
+        if (count > 0) {
+            next->iov_base = (char *)next->iov_base + written;
+            next->iov_len -= written;
+        }
+    }
+    t->current = 0;
+    t->fill = 0;
+}
+
+/**
+ * @brief Uvoľní vyrovnávacie pamäte cieľa t
+*/
+static void emitFreeTarget(emitTarget_T *t) {
+    for (size_t i = 0; i < EMIT_BUFFERS; i++) {
+        memFree(MEM_EMIT, t->buffers[i]);
+        t->buffers[i] = NULL;
+    }
+}
+
+void emitFlush() {
+    emitFlushTarget(target);
+}
+
+void emitText(const char *text, size_t len) {
+    emitTarget_T *t = target;
+    if (t == &out && out.bytes == 0) clock_gettime(CLOCK_MONOTONIC, &start);
+    t->bytes += len;
+    while (len > 0) {
+        if (t->fill == EMIT_BUFFER_SIZE) {
+            if (t->current + 1 == EMIT_BUFFERS) emitFlushTarget(t);
+            else {
+                t->current++;
+                t->fill = 0;
+            }
+        }
+        if (t->buffers[t->current] == NULL) {
+            t->buffers[t->current] = memMalloc(MEM_EMIT, EMIT_BUFFER_SIZE);
+            if (t->buffers[t->current] == NULL) emitError("emitText", "memory allocation error");
+        }
+        size_t chunk = EMIT_BUFFER_SIZE - t->fill;
+        if (chunk > len) chunk = len;
+        memcpy(t->buffers[t->current] + t->fill, text, chunk);
+        t->fill += chunk;
+        text += chunk;
+        len -= chunk;
+    }
+}
+
+void emitString(const char *text) {
+    emitText(text, strlen(text));
+}
+
+void emitSpillBegin() {
+    if (!spill.file) {
+        // nepomenovaný súbor, po skončení prekladača zanikne
+        FILE *f = tmpfile();
+        if (f == NULL) emitError("emitSpillBegin", strerror(errno));
+        spill.fd = dup(fileno(f));
+        fclose(f);
+        if (spill.fd < 0) emitError("emitSpillBegin", strerror(errno));
+        spill.file = true;
+    }
+    target = &spill;
+}
+
+void emitSpillEnd() {
+    emitFlushTarget(&spill);
+    // do ďalšieho použitia odkladacieho súboru netreba držať jeho vyrovnávacie pamäte
+    emitFreeTarget(&spill);
+    target = &out;
+}
+
+size_t emitSpillBytes() {
+    return spill.bytes;
+}
+
+void emitSpillCopy() {
+    if (!spill.file) return;
+    if (lseek(spill.fd, 0, SEEK_SET) < 0) emitError("emitSpillCopy", strerror(errno));
+    // obsah sa číta priamo do vyrovnávacích pamätí výstupu
+    size_t left = spill.bytes;
+    while (left > 0) {
+        if (out.fill == EMIT_BUFFER_SIZE) {
+            if (out.current + 1 == EMIT_BUFFERS) emitFlushTarget(&out);
+            else {
+                out.current++;
+                out.fill = 0;
+            }
+        }
+        if (out.buffers[out.current] == NULL) {
+            out.buffers[out.current] = memMalloc(MEM_EMIT, EMIT_BUFFER_SIZE);
+            if (out.buffers[out.current] == NULL) emitError("emitSpillCopy", "memory allocation error");
+        }
+        size_t chunk = EMIT_BUFFER_SIZE - out.fill;
+        if (chunk > left) chunk = left;
+        ssize_t got = read(spill.fd, out.buffers[out.current] + out.fill, chunk);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) emitError("emitSpillCopy", got < 0 ? strerror(errno) : "unexpected end of file");
+        out.fill += (size_t)got;
+        out.bytes += (size_t)got;
+        left -= (size_t)got;
+    }
+    close(spill.fd);
+    spill = (emitTarget_T){-1, false, {NULL}, 0, 0, 0};
+}
+
+void emitClose() {
+    emitFlushTarget(&out);
+    if (out.file) {
+        // predalokovaný súbor môže byť dlhší ako výstup
+        if (ftruncate(out.fd, (off_t)out.bytes) != 0 || close(out.fd) != 0) {
+            emitError("emitClose", strerror(errno));
+        }
+        out.fd = STDOUT_FILENO;
+        out.file = false;
+    }
+    emitFreeTarget(&out);
+    if (spill.file) {
+        emitFreeTarget(&spill);
+        close(spill.fd);
+        spill = (emitTarget_T){-1, false, {NULL}, 0, 0, 0};
+    }
+    target = &out;
+    if (out.bytes == 0) return;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+size_t emitBytes() {
+    return out.bytes;
+}
+
+void emitReport() {
+    double mb = (double)out.bytes / (1024.0 * 1024.0);
+    fprintf(stderr, "emit: %zu bytes in %.6f s", out.bytes, seconds);
+    if (seconds > 0.0) fprintf(stderr, " (%.1f MB/s)", mb / seconds);
+    fprintf(stderr, "\n");
+}
+
+/* Koniec súboru emit.c */
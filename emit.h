@@ -0,0 +1,94 @@
+/** Projekt IFJ2023
+ * @file emit.h
+ * @brief Výstup cieľového kódu cez veľké vyrovnávacie pamäte
+ */
+
+#ifndef _EMIT_H_
+#define _EMIT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define EMIT_BUFFER_SIZE 65536  ///< veľkosť jednej vyrovnávacej pamäte
+#define EMIT_BUFFERS 16         ///< počet vyrovnávacích pamätí zapísaných jedným volaním writev
+
+/**
+ * Text sa kopíruje do vyrovnávacích pamätí veľkosti EMIT_BUFFER_SIZE. Keď sú všetky EMIT_BUFFERS plné,
+ * zapíšu sa naraz jedným volaním writev, pri riadku kódu sa teda nič nealokuje ani nevolá systém.
+ *
+ * @brief Nasmeruje výstup na štandardný výstup
+*/
+void emitInit();
+
+/**
+ * @brief Nasmeruje výstup do súboru, súbor sa vytvorí alebo skráti
+ * @param path cesta k výstupnému súboru
+ * @return true v prípade úspechu, inak false (chyba je vypísaná na stderr)
+*/
+bool emitOpen(const char *path);
+
+/**
+ * Súbor z emitOpen sa predalokuje, aby sa pri zápise nezväčšoval po malých častiach,
+ * pri emitClose sa skráti na skutočne zapísanú dĺžku. Pri štandardnom výstupe nerobí nič.
+ *
+ * @brief Vyhradí miesto pre očakávanú veľkosť výstupu
+ * @param expected odhad veľkosti výstupu v bajtoch
+*/
+void emitReserve(size_t expected);
+
+/**
+ * @brief Pridá na výstup len bajtov textu
+*/
+void emitText(const char *text, size_t len);
+
+/**
+ * @brief Pridá na výstup reťazec ukončený znakom \0
+*/
+void emitString(const char *text);
+
+/**
+ * Kód hlavného tela je hotový skôr, ako je známe, čo mu na výstupe predchádza (funkcie, pomocné premenné).
+ * Kým sa nezavolá emitSpillEnd, emitText zapisuje do dočasného súboru, ktorý sa neskôr vloží na výstup
+ * cez emitSpillCopy.
+ *
+ * @brief Presmeruje zápis do odkladacieho súboru, pri prvom volaní ho vytvorí
+*/
+void emitSpillBegin();
+
+/**
+ * @brief Zapíše obsah vyrovnávacích pamätí do odkladacieho súboru a vráti zápis na výstup
+*/
+void emitSpillEnd();
+
+/**
+ * @brief Počet bajtov zapísaných do odkladacieho súboru
+*/
+size_t emitSpillBytes();
+
+/**
+ * @brief Pridá na výstup celý obsah odkladacieho súboru a súbor zruší
+*/
+void emitSpillCopy();
+
+/**
+ * @brief Zapíše obsah vyrovnávacích pamätí na výstup
+*/
+void emitFlush();
+
+/**
+ * @brief Zapíše zvyšok výstupu, uzavrie súbor z emitOpen, zruší odkladací súbor a uvoľní vyrovnávacie pamäte
+*/
+void emitClose();
+
+/**
+ * @brief Počet bajtov odovzdaných na výstup od emitInit alebo emitOpen
+*/
+size_t emitBytes();
+
+/**
+ * @brief Vypíše na stderr objem výstupu, čas od prvého zápisu po emitClose a priepustnosť v MB/s
+*/
+void emitReport();
+
+#endif // ifndef _EMIT_H_
+/* Koniec súboru emit.h */
@@ -6,16 +6,22 @@
  */
 
 #include "stdio.h"
+#include <limits.h>
+#include <math.h>
 #include "exp.h"
 #include "strR.h"
 #include "symtable.h"
 #include "generator.h"
 #include "logErr.h"
+#include "timer.h"
+#include "mem.h"
 
 
 /** Počas syntaktickej analýzy označuje, že ešte nebol spracovaný žiadny token*/
 #define NO_PREV -1
 
+bool exp_three_address = false;
+
 /**************************************************************************************************
 * Štruktúry
 **************************************************************************************************/
@@ -26,8 +32,9 @@ typedef struct parsed_token
 {
     int type;       // typ tokenu
     char st_type;   // typ premennej, používa hodnoty SYM_TYPE_XXX
-    str_T id;       // názov identifikátoru, zároveň kľúč v tabuľke
-    str_T codename; // identifikátor v cieľovom kóde
+    atom_T *id;       // názov identifikátoru, zároveň kľúč v tabuľke, NULL ak token nie je identifikátor
+    atom_T *codename; // identifikátor v cieľovom kóde, NULL pri operátore
+    bool pushed;    // hodnota operandu už je v cieľovom kóde vložená na zásobník
     int ln;         // riadok tokenu
     int col;        // pozícia prvého charakteru tokenu v riadku
 } ptoken_T;
@@ -52,7 +59,7 @@ typedef struct stack
 */
 bool stack_init( stack_t *stack ) {
 
-    stack->array = calloc(16, sizeof(ptoken_T*)); // Alokácia pamäte pre pole
+    stack->array = memCalloc(MEM_EXPRESSION, 16, sizeof(ptoken_T*)); // Alokácia pamäte pre pole
 	if(stack->array == NULL){ // Alokácia pamäte zlyhala
         return false;
 	}
@@ -80,7 +87,7 @@ ptoken_T *stack_top(stack_t *stack){
 int stack_push_ptoken(stack_t *stack, ptoken_T *token){
     if(stack->capacity == stack->size){         // Ak je zásobník plný
         stack->capacity = stack->capacity*2;    // Zdvojnásobenie kapacity
-        stack->array = realloc(stack->array, stack->capacity*sizeof(token_T));
+        stack->array = memRealloc(MEM_EXPRESSION, stack->array, stack->capacity*sizeof(token_T));
 
         if(stack->array == NULL){ // Realokácia pamäte zlyhala
             fprintf(stderr, "memory reallocation error\n");
@@ -103,7 +110,7 @@ int stack_push_token(stack_t *stack, token_T *token){
 
     if(token->type == ID) // Ak je token identifikátor, musíme ho vyhľadať v tabuľke symbolov
     {
-        symtabData = SymTabLookup(&symt, StrRead(&(token->atr))); // Získanie dát o premennej z tabuľky symbolov
+        symtabData = SymTabLookupAtom(&symt, token->atom); // Získanie dát o premennej z tabuľky symbolov
 
         if(symtabData == NULL){ // Premenná nebola deklarovaná
             logErrCodeAnalysis(SEM_ERR_UNDEF, token->ln, token->col,"variable was not declared");
@@ -115,34 +122,32 @@ int stack_push_token(stack_t *stack, token_T *token){
         }
     }
 
-    ptoken_T *parsed_token = malloc(sizeof(ptoken_T)); // Nový parsed token
+    ptoken_T *parsed_token = memMalloc(MEM_EXPRESSION, sizeof(ptoken_T)); // Nový parsed token
     if(parsed_token == NULL){
         fprintf(stderr, "memory allocation error\n");
         return COMPILER_ERROR;
     }
     
-    str_T id, codename;     // Reťazce pre identifikátor a názov premennej/konštanty v cieľovom kóde
-    StrInit(&id);           // Inicializácia id
-    StrInit(&codename);     // Inicializácia codename
-    StrFillWith(&id, token->atr.data); // Vloženie názvu premennej do id
-
-    parsed_token->id = id;              // Id parsed tokenu
+    parsed_token->id = token->atom;     // Id parsed tokenu
     parsed_token->type = token->type;   // Typ tokenu
+    parsed_token->pushed = false;       // Operand sa na zásobník vloží až pri jeho použití
     parsed_token->ln = token->ln;       // Riadok tokenu
     parsed_token->col = token->col;     // Pozícia v riadku tokenu
 
     if(token->type == ID) // Operand je premenná
     {
         parsed_token->st_type = symtabData->type; // Identikátor v cieľovom kóde z tabuľky symbolov
-        StrFillWith(&codename, StrRead(&(symtabData->codename))); 
-        parsed_token->codename = codename; // Identifikátor v cieľovom kóde
+        parsed_token->codename = symtabData->codename; // Identifikátor v cieľovom kóde
     }
 
     if(token->type == INT_CONST || token->type == DOUBLE_CONST || token->type == STRING_CONST || token->type == NIL)// Operand je konštanta
     {
+        str_T codename;
+        StrInit(&codename);
         genConstVal(token->type, StrRead(&(tkn->atr)), &codename); // Získanie identifikátoru v cieľovom kóde pre konštantu
 
-        parsed_token->codename = codename; // Identifikátor v cieľovom kóde
+        parsed_token->codename = AtomIntern(StrRead(&codename)); // Identifikátor v cieľovom kóde
+        StrDestroy(&codename);
         switch (parsed_token->type){
         case INT_CONST:
              parsed_token->st_type = 'i';
@@ -166,7 +171,7 @@ int stack_push_token(stack_t *stack, token_T *token){
     token->type != STRING_CONST && token->type != NIL && token->type != ID) // Token je operátor
     {
         parsed_token->st_type = '0';        // Typ premennej (operátor nemá typ premennej)
-        parsed_token->codename = codename;  // Prázdný inicializovaný StrR
+        parsed_token->codename = NULL;      // Operátor nemá identifikátor v cieľovom kóde
     }
     
     return stack_push_ptoken(stack, parsed_token); // Vloženie parsed tokenu na zásobník a vrátenie return value
@@ -191,9 +196,7 @@ void stack_pop_destroy(stack_t *stack){
     element = stack_top(stack); // Odstraňujeme prvok z vrcholu
     if(element != NULL)         // Prevencia double free
     {
-        StrDestroy(&(element->id));         // Odstránenie strR id
-        StrDestroy(&(element->codename));   // Odstránenie strR codename
-        free(element);                      // Uvoľenie pamäte alokovanej pre prvok
+        memFree(MEM_EXPRESSION, element);                      // Uvoľenie pamäte alokovanej pre prvok
     }
     stack_pop(stack); // Odstránenie prvku zo zásobníka
 }
@@ -206,11 +209,11 @@ void stack_clear(stack_t *stack){
         
         while(stack->size > 0)      // Kým sa nevymažú všetky položky
         {
-            free(stack_top(stack)); // Odstránenie alokovanej pamäti prvku
+            memFree(MEM_EXPRESSION, stack_top(stack)); // Odstránenie alokovanej pamäti prvku
             stack_pop(stack);       // Odstránenie prvku zo zásobníka
         }
     }
-    free(stack->array);             // Uvoľnenie alokovanej pamäti zoznamu
+    memFree(MEM_EXPRESSION, stack->array);             // Uvoľnenie alokovanej pamäti zoznamu
     stack->size = 0;
 }
 
@@ -224,7 +227,7 @@ void stack_dispose(stack_t *stack){
         {
             stack_pop_destroy(stack);   // Odstránenie prvku zo zásobníka a vymazanie
         }
-        free(stack->array);             // Uvoľnenie alokovanej pamäti zoznamu
+        memFree(MEM_EXPRESSION, stack->array);             // Uvoľnenie alokovanej pamäti zoznamu
     }
 
     stack->capacity = stack->size = 0;  // Veľkosť a kapacita = 0
@@ -239,17 +242,26 @@ void stack_dispose(stack_t *stack){
 **/
 void int2double(ptoken_T *var_a, ptoken_T *var_b){
 
+    if(exp_three_address){ // Int medzivýsledok je v pomocnej premennej, konvertuje sa na mieste
+        if(var_a->type == INT_CONST){
+            genCodeAtoms(INS_INT2FLOAT, var_a->codename, var_a->codename, NULL);
+        }
+        if(var_b->type == INT_CONST){
+            genCodeAtoms(INS_INT2FLOAT, var_b->codename, var_b->codename, NULL);
+        }
+        return;
+    }
     if(var_a->type == INT_CONST){   // Int konštanta je na zásobníku druhá z vrchu
-        genCode("POPS","GF@!tmp2", NULL, NULL);             // Popnutie double premennej
-        genCode("POPS","GF@!tmp1", NULL, NULL);             // Popnutie int premennej
-        genCode("INT2FLOAT", "GF@!tmp3", "GF@!tmp1", NULL); // Konverzia int na double
-        genCode("PUSHS", "GF@!tmp3", NULL, NULL);           // Pushnutie konvertovanej premennej späť na zásobník
-        genCode("PUSHS", "GF@!tmp2", NULL, NULL);           // Pushnutie double premennej späť na zásobník
+        genCode(INS_POPS,"GF@!tmp2", NULL, NULL);             // Popnutie double premennej
+        genCode(INS_POPS,"GF@!tmp1", NULL, NULL);             // Popnutie int premennej
+        genCode(INS_INT2FLOAT, "GF@!tmp3", "GF@!tmp1", NULL); // Konverzia int na double
+        genCode(INS_PUSHS, "GF@!tmp3", NULL, NULL);           // Pushnutie konvertovanej premennej späť na zásobník
+        genCode(INS_PUSHS, "GF@!tmp2", NULL, NULL);           // Pushnutie double premennej späť na zásobník
     }
     if(var_b->type == INT_CONST){ // Int konštanta je na vrchole zásobníku
-        genCode("POPS","GF@!tmp1", NULL, NULL);             // Popnutie int premennej
-        genCode("INT2FLOAT", "GF@!tmp3", "GF@!tmp1", NULL); // Konverzia int na double
-        genCode("PUSHS", "GF@!tmp3", NULL, NULL);           // Pushnutie konvertovanej premennej späť na zásobník
+        genCode(INS_POPS,"GF@!tmp1", NULL, NULL);             // Popnutie int premennej
+        genCode(INS_INT2FLOAT, "GF@!tmp3", "GF@!tmp1", NULL); // Konverzia int na double
+        genCode(INS_PUSHS, "GF@!tmp3", NULL, NULL);           // Pushnutie konvertovanej premennej späť na zásobník
     }
 }
 
@@ -456,12 +468,12 @@ void endParse_syn(stack_t *stack, stack_t *postfixExpr){
     stack_dispose(postfixExpr);
 }
 /**
- * @brief Funkcia zavolaná pred ukončením parseExpression počas sémantickej analýzy
- * @details Vyprázdni zásobníky a uvoľní alokovanú pamäť každej položky v zásobníku
+ * @brief Funkcia zavolaná pred ukončením eval_postfix
+ * @details Vyprázdni zásobník operandov a uvoľní alokovanú pamäť každej jeho položky,
+ * postfixový výraz uvoľní až volajúci
 **/
-void endParse_sem(stack_t *stack, stack_t *postfixExpr){
+void endParse_sem(stack_t *stack){
     stack_clear(stack);
-    stack_dispose(postfixExpr);
 }
 
 /**
@@ -557,20 +569,405 @@ void copy_data(ptoken_T *source, ptoken_T *destination){
     destination->type = source->type;
     destination->codename = source->codename; 
     destination->id = source->id; 
+    destination->pushed = source->pushed;
     destination->ln = source->ln;
     destination->col = source->col;
 }
 
+/**************************************************************************************************
+* Vyhodnotenie konštánt počas prekladu
+**************************************************************************************************/
+
+/**
+ * @brief Vygeneruje vloženie odložených operandov na zásobník v cieľovom kóde
+ * @details Operandy sa na zásobník vkladajú až pri ich použití. Odložené operandy preto tvoria vrchol
+ * zásobníka stack a vkladajú sa zdola nahor, za nimi var_a a var_b (ak nie sú NULL), ktoré už boli
+ * zo zásobníka stack vybrané.
+**/
+void push_operands(stack_t *stack, ptoken_T *var_a, ptoken_T *var_b){
+    int first = stack->size;
+    while(first > 0 && !stack->array[first - 1]->pushed){ // Nájdenie najnižšieho odloženého operandu
+        first--;
+    }
+    for(int i = first; i < stack->size; i++){
+        genCodeAtoms(INS_PUSHS, stack->array[i]->codename, NULL, NULL);
+        stack->array[i]->pushed = true;
+    }
+    if(var_a != NULL && !var_a->pushed){
+        genCodeAtoms(INS_PUSHS, var_a->codename, NULL, NULL);
+        var_a->pushed = true;
+    }
+    if(var_b != NULL && !var_b->pushed){
+        genCodeAtoms(INS_PUSHS, var_b->codename, NULL, NULL);
+        var_b->pushed = true;
+    }
+}
+
+/**
+ * @brief Overuje, či je operand medzivýsledok trojadresného kódu uložený v pomocnej premennej
+**/
+bool is_temp(ptoken_T *op){
+    return strncmp(op->codename->text, VAR_TMP_PREFIX, strlen(VAR_TMP_PREFIX)) == 0;
+}
+
+/**
+ * Zásobníkový kód vloží odložené operandy a vygeneruje stack_ins, trojadresný kód zapíše
+ * výsledok tac_ins do pomocnej premennej podľa pozície var_a na zásobníku operandov.
+ * Konkatenácia nemá zásobníkovú inštrukciu, pri tac_ins == INS_CONCAT sa stack_ins ignoruje.
+ *
+ * @brief Vygeneruje binárnu operáciu, ktorej výsledok nahradí operand var_a
+ * @param stack zásobník operandov, z ktorého už boli var_a a var_b vybrané
+ * @param negate výsledok operácie sa ešte zneguje
+**/
+void gen_operation(stack_t *stack, ptoken_T *var_a, ptoken_T *var_b, ins_code_T stack_ins, ins_code_T tac_ins, bool negate){
+    if(exp_three_address){
+        atom_T *result = genExpTemp(stack->size);
+        genCodeAtoms(tac_ins, result, var_a->codename, var_b->codename);
+        if(negate){
+            genCodeAtoms(INS_NOT, result, result, NULL);
+        }
+        var_a->codename = result;
+        return;
+    }
+    push_operands(stack, var_a, var_b);
+    if(tac_ins == INS_CONCAT){
+        genCode(INS_POPS,"GF@!tmp2", NULL, NULL);                 // Popnutie reťazca do pomocnej premennej
+        genCode(INS_POPS,"GF@!tmp1", NULL, NULL);                 // Popnutie reťazca do pomocnej premennej
+        genCode(INS_CONCAT, "GF@!tmp3", "GF@!tmp1", "GF@!tmp2");  // Konkatenácia reťazcov
+        genCode(INS_PUSHS, "GF@!tmp3", NULL, NULL);               // Pushnutie konkatenovaného reťazca na stack
+    }
+    else{
+        genCode(stack_ins, NULL, NULL, NULL);
+    }
+    if(negate){
+        genCode(INS_NOTS, NULL, NULL, NULL);
+    }
+}
+
+/**
+ * @brief Overuje, či je operand konštanta, ktorej hodnota ešte nebola vložená na zásobník
+ * @returns true ak je možné s hodnotou operandu počítať počas prekladu, inak false
+**/
+bool is_pending_const(ptoken_T *op){
+    return !op->pushed && !is_temp(op) && (op->type == INT_CONST || op->type == DOUBLE_CONST ||
+        op->type == STRING_CONST || op->type == NIL || op->type == BOOL_CONST);
+}
+
+/**
+ * @brief Vráti hodnotu konštanty v tvare cieľového kódu bez prefixu typu, napr. "42" pre "int@42"
+**/
+const char *const_value(ptoken_T *op){
+    return strchr(op->codename->text, '@') + 1;
+}
+
+/**
+ * @brief Nastaví operand na konštantu vypočítanú počas prekladu
+ * @param type typ konštanty (INT_CONST, DOUBLE_CONST, STRING_CONST alebo BOOL_CONST)
+ * @param st_type typ výsledku, SYM_TYPE_XXX
+ * @param value hodnota konštanty v tvare, ktorý očakáva genConstVal
+**/
+void set_const(ptoken_T *op, int type, char st_type, char *value){
+    str_T codename;
+    StrInit(&codename);
+    genConstVal(type, value, &codename);
+    op->codename = AtomIntern(StrRead(&codename));
+    StrDestroy(&codename);
+    op->type = type;
+    op->st_type = st_type;
+    op->pushed = false;
+}
+
+/**
+ * Implicitná konverzia celočíselného literálu, ktorý je operandom spolu s Double, sa vykoná už počas prekladu.
+ * Ak už literál bol vložený na zásobník alebo je medzivýsledkom, konverziu vygeneruje int2double.
+ *
+ * @brief Prevedie odloženú Int konštantu na Double konštantu, ak je druhý operand typu Double
+**/
+void int_const2double(ptoken_T *var_a, ptoken_T *var_b){
+    ptoken_T *ops[2] = {var_a, var_b};
+    for(int i = 0; i < 2; i++){
+        ptoken_T *other = ops[1 - i];
+        if(ops[i]->type == INT_CONST && is_pending_const(ops[i]) && (other->type == DOUBLE_CONST || other->st_type == 'd')){
+            char value[64];
+            snprintf(value, sizeof(value), "%a", (double)strtoll(const_value(ops[i]), NULL, 10));
+            set_const(ops[i], DOUBLE_CONST, 'd', value);
+        }
+    }
+}
+
+/**
+ * @brief Dekóduje reťazcovú konštantu cieľového kódu (escape sekvencie \ddd)
+ * @returns true ak reťazec obsahuje iba ASCII znaky, inak false, pretože ich poradie určuje až interpret
+**/
+bool decode_ascii_const(const char *value, str_T *decoded){
+    for(const char *c = value; *c != '\0'; c++){
+        int byte = (unsigned char)*c;
+        if(*c == '\\'){ // Escape sekvencia \ddd
+            byte = (c[1] - '0') * 100 + (c[2] - '0') * 10 + (c[3] - '0');
+            c += 3;
+        }
+        if(byte >= 128){
+            return false;
+        }
+        StrAppend(decoded, (char)byte);
+    }
+    return true;
+}
+
+/**
+ * Delenie nulou, pretečenie a výsledky mimo konečných čísel Double sa nepočítajú,
+ * chybu či výsledok musí určiť interpret.
+ *
+ * @brief Vypočíta aritmetickú operáciu alebo konkatenáciu konštánt počas prekladu, výsledok zapíše do var_a
+ * @returns true ak bol výsledok vypočítaný, inak false a operáciu treba vygenerovať
+**/
+bool fold_arithmetic(ptoken_T *var_a, ptoken_T *var_b, int operator){
+    if(!is_pending_const(var_a) || !is_pending_const(var_b) || var_a->type != var_b->type){
+        return false;
+    }
+    char value[64];
+
+    if(var_a->type == INT_CONST){
+        long long a = strtoll(const_value(var_a), NULL, 10);
+        long long b = strtoll(const_value(var_b), NULL, 10);
+        long long result;
+        switch(operator){
+        case OP_PLUS:
+            if(__builtin_add_overflow(a, b, &result)) return false;
+            break;
+        case OP_MINUS:
+            if(__builtin_sub_overflow(a, b, &result)) return false;
+            break;
+        case OP_MUL:
+            if(__builtin_mul_overflow(a, b, &result)) return false;
+            break;
+        case OP_DIV: // IDIV zaokrúhľuje smerom k -nekonečnu
+            if(b == 0 || (a == LLONG_MIN && b == -1)) return false;
+            result = a / b;
+            if(a % b != 0 && ((a < 0) != (b < 0))) result--;
+            break;
+        default:
+            return false;
+        }
+        snprintf(value, sizeof(value), "%lld", result);
+        set_const(var_a, INT_CONST, 'i', value);
+        return true;
+    }
+    if(var_a->type == DOUBLE_CONST){
+        double a = strtod(const_value(var_a), NULL);
+        double b = strtod(const_value(var_b), NULL);
+        double result;
+        switch(operator){
+        case OP_PLUS:
+            result = a + b;
+            break;
+        case OP_MINUS:
+            result = a - b;
+            break;
+        case OP_MUL:
+            result = a * b;
+            break;
+        case OP_DIV:
+            if(b == 0.0) return false;
+            result = a / b;
+            break;
+        default:
+            return false;
+        }
+        if(!isfinite(result)) return false;
+        snprintf(value, sizeof(value), "%a", result);
+        set_const(var_a, DOUBLE_CONST, 'd', value);
+        return true;
+    }
+    if(var_a->type == STRING_CONST && operator == OP_PLUS){
+        // Zakódovanie znakov je nezávislé od okolia, konkatenácia zakódovaných reťazcov je zakódovaná konkatenácia
+        str_T codename;
+        StrInit(&codename);
+        StrCatString(&codename, var_a->codename->text);
+        StrCatString(&codename, (char *)const_value(var_b));
+        var_a->codename = AtomIntern(StrRead(&codename));
+        StrDestroy(&codename);
+        var_a->st_type = 's';
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Vypočíta porovnanie konštánt počas prekladu, výsledok (bool konštantu) zapíše do var_a
+ * @returns true ak bol výsledok vypočítaný, inak false a porovnanie treba vygenerovať
+**/
+bool fold_relational(ptoken_T *var_a, ptoken_T *var_b, int operator){
+    if(!is_pending_const(var_a) || !is_pending_const(var_b) || var_a->type != var_b->type){
+        return false;
+    }
+    int cmp; // < 0, 0 alebo > 0 podľa vzťahu var_a a var_b
+
+    switch(var_a->type){
+    case INT_CONST:;
+        long long ia = strtoll(const_value(var_a), NULL, 10);
+        long long ib = strtoll(const_value(var_b), NULL, 10);
+        cmp = (ia > ib) - (ia < ib);
+        break;
+    case DOUBLE_CONST:;
+        double da = strtod(const_value(var_a), NULL);
+        double db = strtod(const_value(var_b), NULL);
+        cmp = (da > db) - (da < db);
+        break;
+    case STRING_CONST:;
+        str_T sa, sb;
+        StrInit(&sa);
+        StrInit(&sb);
+        bool ascii = decode_ascii_const(const_value(var_a), &sa) && decode_ascii_const(const_value(var_b), &sb);
+        size_t len = StrLen(&sa) < StrLen(&sb) ? StrLen(&sa) : StrLen(&sb);
+        cmp = memcmp(StrRead(&sa), StrRead(&sb), len);
+        if(cmp == 0){
+            cmp = (StrLen(&sa) > StrLen(&sb)) - (StrLen(&sa) < StrLen(&sb));
+        }
+        StrDestroy(&sa);
+        StrDestroy(&sb);
+        if(!ascii) return false;
+        break;
+    case NIL: // nil sa dá iba porovnať na rovnosť
+        if(operator != EQ && operator != NEQ) return false;
+        cmp = 0;
+        break;
+    case BOOL_CONST:
+        if(operator != EQ && operator != NEQ) return false;
+        cmp = var_a->codename != var_b->codename;
+        break;
+    default:
+        return false;
+    }
+
+    bool result;
+    switch(operator){
+    case EQ:
+        result = cmp == 0;
+        break;
+    case NEQ:
+        result = cmp != 0;
+        break;
+    case LT:
+        result = cmp < 0;
+        break;
+    case GT:
+        result = cmp > 0;
+        break;
+    case LTEQ:
+        result = cmp <= 0;
+        break;
+    case GTEQ:
+        result = cmp >= 0;
+        break;
+    default:
+        return false;
+    }
+    set_const(var_a, BOOL_CONST, 'b', result ? "true" : "false");
+    return true;
+}
+
+/**************************************************************************************************
+* Podmienené skoky
+**************************************************************************************************/
+
+/**
+ * @brief Vráti operátor opačného porovnania (napr. < => >=)
+**/
+int negate_relational(int operator){
+    switch(operator){
+    case EQ:    return NEQ;
+    case NEQ:   return EQ;
+    case LT:    return GTEQ;
+    case GTEQ:  return LT;
+    case GT:    return LTEQ;
+    default:    return GT; // LTEQ
+    }
+}
+
+/**
+ * Rovnosť sa testuje priamo inštrukciou JUMPIFEQ/JUMPIFNEQ. Pri usporiadaní sa <= a >= vyhodnotia
+ * ako opačné porovnanie GT/LT a skočí sa pri jeho výsledku true, takže netreba NOT.
+ * Operandy, ktoré ešte nie sú na zásobníku, sú priamo operandmi inštrukcií.
+ * Skok pri platnom porovnaní je skokom pri neplatnom opačnom porovnaní.
+ *
+ * @brief Vygeneruje skok na label, ak porovnanie "var_a operator var_b" neplatí
+ * @param stack zásobník operandov, z ktorého už boli var_a a var_b vybrané
+ * @param jump_when pri true sa naopak skáče, keď porovnanie platí
+**/
+void gen_cond_jump(stack_t *stack, ptoken_T *var_a, ptoken_T *var_b, int operator, char *label, bool jump_when){
+    if(jump_when){
+        operator = negate_relational(operator);
+    }
+    bool inverted = operator == LTEQ || operator == GTEQ;                // skáče sa, keď opačné porovnanie platí
+    bool less = operator == LT || operator == GTEQ;                      // porovnanie sa vykoná ako A < B
+    char *jump_value = inverted ? "bool@true" : "bool@false";
+
+    if(var_a->pushed || var_b->pushed){ // Aspoň jeden operand je na zásobníku
+        push_operands(stack, var_a, var_b);
+        switch(operator){
+        case EQ:
+            genCode(INS_JUMPIFNEQS, label, NULL, NULL);
+            break;
+        case NEQ:
+            genCode(INS_JUMPIFEQS, label, NULL, NULL);
+            break;
+        default:
+            genCode(less ? INS_LTS : INS_GTS, NULL, NULL, NULL);
+            genCode(INS_PUSHS, jump_value, NULL, NULL);
+            genCode(INS_JUMPIFEQS, label, NULL, NULL);
+            break;
+        }
+        return;
+    }
+    switch(operator){
+    case EQ:
+        genCode(INS_JUMPIFNEQ, label, var_a->codename->text, var_b->codename->text);
+        break;
+    case NEQ:
+        genCode(INS_JUMPIFEQ, label, var_a->codename->text, var_b->codename->text);
+        break;
+    default:
+        genCode(less ? INS_LT : INS_GT, VAR_COND, var_a->codename->text, var_b->codename->text);
+        genCode(INS_JUMPIFEQ, label, VAR_COND, jump_value);
+        break;
+    }
+}
+
+/**
+ * @brief Vygeneruje skok na label, ak má bool výsledok podmienky hodnotu jump_when
+ * @details Konštantná podmienka sa vyhodnotí počas prekladu, pri inej hodnote sa negeneruje nič.
+**/
+void gen_value_jump(ptoken_T *result, char *label, bool jump_when){
+    char *value = jump_when ? "bool@true" : "bool@false";
+    if(is_pending_const(result) && result->type == BOOL_CONST){
+        if(strcmp(result->codename->text, value) == 0){
+            genCode(INS_JUMP, label, NULL, NULL);
+        }
+    }
+    else if(!result->pushed){
+        genCode(INS_JUMPIFEQ, label, result->codename->text, value);
+    }
+    else{
+        genCode(INS_PUSHS, value, NULL, NULL);
+        genCode(INS_JUMPIFEQS, label, NULL, NULL);
+    }
+}
+
 /**************************************************************************************************
  *Hlavná funkcia
 **************************************************************************************************/
 
-int parseExpression(char* result_type, bool *literal) {
+/**
+ * @brief Syntaktická analýza výrazu a jeho prevod do postfixovej formy
+ * @param postfixExpr zásobník pre postfixový výraz, pri úspechu ho uvoľní volajúci
+ * @returns 0 v prípade úspechu, inak chybový kód (postfixExpr je vtedy už uvoľnený)
+**/
+int parse_postfix(stack_t *postfixExpr) {
 
     stack_t stack;              // Zásobník pre konverziu výrazu na postfixovú formu
-    stack_t postfixExpr;        // Zásobník pre uloženie postfixového výrazu
     stack_init(&stack);         // Inicializácia zásobníka
-    stack_init(&postfixExpr);   // Inicializácia zásobníka
+    stack_init(postfixExpr);    // Inicializácia zásobníka
 
     int prevTokenType = NO_PREV;    // Pomocná premenná pre uloženie typu tokenu pred momentálne spracovaným
     int bracketCount = 0;           // Premenná na overenie korektnosti zátvoriek "()" vo výraze
@@ -586,7 +983,7 @@ int parseExpression(char* result_type, bool *literal) {
         {
             if(tkn->type == INVALID) // Token je typu INVALID
             {
-                endParse_syn(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+                endParse_syn(&stack, postfixExpr); // Upratanie pred skončením funkcie
                 return LEX_ERR; // Lexikálna chyba
             }
             if(prevTokenType == NO_PREV){ // Token je prvý vo výraze
@@ -607,8 +1004,8 @@ int parseExpression(char* result_type, bool *literal) {
                     prevTokenType = NO_PREV;
                     break; // Výraz nie je valídny
                 }
-                if(infix2postfix(&stack, &postfixExpr, NULL) == COMPILER_ERROR){ // Ukončenie postfix výrazu
-                    endParse_syn(&stack, &postfixExpr); // Upratenie pred ukončením pri chybovom stave
+                if(infix2postfix(&stack, postfixExpr, NULL) == COMPILER_ERROR){ // Ukončenie postfix výrazu
+                    endParse_syn(&stack, postfixExpr); // Upratenie pred ukončením pri chybovom stave
                     return COMPILER_ERROR; // Nastala chyba pri malloc/realloc
                 }
                 saveToken();    // Vloženie tokenu späť do input streamu
@@ -641,8 +1038,8 @@ int parseExpression(char* result_type, bool *literal) {
                     }
                     else
                     {
-                        if(infix2postfix(&stack, &postfixExpr, NULL) == COMPILER_ERROR){ // Signalizuje ukončenie postfix výrazu
-                            endParse_syn(&stack, &postfixExpr); // Upratenie pred ukončením
+                        if(infix2postfix(&stack, postfixExpr, NULL) == COMPILER_ERROR){ // Signalizuje ukončenie postfix výrazu
+                            endParse_syn(&stack, postfixExpr); // Upratenie pred ukončením
                             return COMPILER_ERROR; // Nastala chyba pri malloc/realloc
                         }
                         saveToken(); // Vloženie tokenu späť do input streamu
@@ -693,10 +1090,10 @@ int parseExpression(char* result_type, bool *literal) {
             }
         }
 
-        status = infix2postfix(&stack, &postfixExpr, tkn); // Pridanie tokenu do postfix výrazu
+        status = infix2postfix(&stack, postfixExpr, tkn); // Pridanie tokenu do postfix výrazu
         if(status != 0) // Pridanie tokenu do postfix výrazu nebolo úspešné
         {
-            endParse_syn(&stack, &postfixExpr); // Upratenie pred ukončením
+            endParse_syn(&stack, postfixExpr); // Upratenie pred ukončením
             return status;                      // Vrátenie chybového kódu            
         }
         
@@ -704,11 +1101,11 @@ int parseExpression(char* result_type, bool *literal) {
         status = nextToken();           // Požiadanie o ďalší token z výrazu
         if(status == COMPILER_ERROR){   // nextToken vrátil compiler error
             fprintf(stderr, "nextToken: memory allocation error\n");
-            endParse_syn(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+            endParse_syn(&stack, postfixExpr); // Upratanie pred skončením funkcie
             return COMPILER_ERROR;              // Vrátenie compiler error
         }
         if(status == LEX_ERR){
-            endParse_syn(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+            endParse_syn(&stack, postfixExpr); // Upratanie pred skončením funkcie
             return LEX_ERR;                     // Vrátenie lexical error
         }
 
@@ -716,31 +1113,43 @@ int parseExpression(char* result_type, bool *literal) {
 
     if(prevTokenType == NO_PREV) // Symbolizuje chybnú syntax
     {
-        endParse_syn(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+        endParse_syn(&stack, postfixExpr); // Upratanie pred skončením funkcie
         return SYN_ERR; // Vrátenie chybového stavu
     }
 
-//=====================================Sémantická analýza=========================================/
+    stack_dispose(&stack);
+    return COMPILATION_OK;
+}
+
+/**
+ * Postfixový výraz sa pri vyhodnotení nemení, ten istý výraz je preto možné vygenerovať viackrát.
+ *
+ * @brief Sémantická analýza a generovanie kódu postfixového výrazu, pri label != NULL ide o podmienku
+ * a namiesto vloženia výsledku na zásobník sa vygeneruje skok na label, keď výsledok je jump_when
+**/
+int eval_postfix(stack_t *postfixExpr, char* result_type, bool *literal, char *label, bool jump_when) {
+
+    stack_t stack;          // Zásobník operandov
+    stack_init(&stack);     // Inicializácia zásobníka
 
     ptoken_T *var_a, *var_b; // Pomocné premenné pre sémantickú analýzu
-    status = 0;
+    bool branched = false;   // Podmienený skok už bol vygenerovaný pri porovnaní v koreni podmienky
+    int status = 0;
 
-    for(int index = 0; index<postfixExpr.size; index++) // Kým sa nespracuje celý postfix výraz
+    for(int index = 0; index<postfixExpr->size; index++) // Kým sa nespracuje celý postfix výraz
     {
-        if(is_operand(postfixExpr.array[index]->type))  // Operand
+        if(is_operand(postfixExpr->array[index]->type))  // Operand
         {
-            ptoken_T *new_token = malloc(sizeof(ptoken_T)); // Vytvorenie nového tokenu kvôli zachovaniu hodnôt v pôvodnom
-            copy_data(postfixExpr.array[index], new_token); // Skopírovanie hodnôt z pôvodného tokenu
+            ptoken_T *new_token = memMalloc(MEM_EXPRESSION, sizeof(ptoken_T)); // Vytvorenie nového tokenu kvôli zachovaniu hodnôt v pôvodnom
+            copy_data(postfixExpr->array[index], new_token); // Skopírovanie hodnôt z pôvodného tokenu
 
             if(stack_push_ptoken(&stack, new_token) == COMPILER_ERROR) // Operand sa vloží na zásobník
             {
-                endParse_sem(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+                endParse_sem(&stack); // Upratanie pred skončením funkcie
                 return COMPILER_ERROR; // Vrátenie chybového stavu
             }
-
-            genCode("PUSHS",StrRead(&(postfixExpr.array[index]->codename)),NULL, NULL); // Vloženie premennej na zásobník
         }
-        if(is_binary_operator(postfixExpr.array[index]->type)) // Binárny operátor
+        if(is_binary_operator(postfixExpr->array[index]->type)) // Binárny operátor
         {
             var_b = stack_top(&stack);
             stack_pop(&stack);
@@ -748,7 +1157,7 @@ int parseExpression(char* result_type, bool *literal) {
             stack_pop(&stack);
             // Popneme 2 premenné zo zásobníka, vo výraze sú v poradí "a b"
 
-            if(is_arithmetic_operator(postfixExpr.array[index]->type)) // Aritmetický operátor
+            if(is_arithmetic_operator(postfixExpr->array[index]->type)) // Aritmetický operátor
             {
                 if(var_a->st_type == 'I' || var_a->st_type == 'D' || var_a->st_type == 'S' || 
                 var_a->st_type == 'N' || var_b->st_type == 'I' || var_b->st_type == 'D' || 
@@ -766,21 +1175,19 @@ int parseExpression(char* result_type, bool *literal) {
 
                 if(var_a->st_type == 's' || var_a->type == STRING_CONST) // Prvý operand je reťazec
                 {
-                    if(postfixExpr.array[index]->type == OP_PLUS) // Operátor je "+"
+                    if(postfixExpr->array[index]->type == OP_PLUS) // Operátor je "+"
                     {
                         if(var_b->st_type == 's' || var_b->type == STRING_CONST) // Druhý operand je tiež reťazec
                         {
                             var_a->st_type = 's';   // Výsledok konkatenácie je typu string
-                            free(var_b);            // Vymazanie tokenu
+                            if(!fold_arithmetic(var_a, var_b, OP_PLUS)){ // Konkatenácia konštánt sa vykoná počas prekladu
+                                gen_operation(&stack, var_a, var_b, INS_CONCAT, INS_CONCAT, false); // Konkatenácia reťazcov
+                            }
+                            memFree(MEM_EXPRESSION, var_b);            // Vymazanie tokenu
                             if((status = stack_push_ptoken(&stack, var_a)) != 0){  // Vloženie tokenu na zásobník
                                 break;
                             }
 
-                            genCode("POPS","GF@!tmp2", NULL, NULL);                 // Popnutie reťazca do pomocnej premennej
-                            genCode("POPS","GF@!tmp1", NULL, NULL);                 // Popnutie reťazca do pomocnej premennej
-                            genCode("CONCAT", "GF@!tmp3", "GF@!tmp1", "GF@!tmp2");  // Konkatenácia reťazcov
-                            genCode("PUSHS", "GF@!tmp3", NULL, NULL);               // Pushnutie konkatenovaného reťazca na stack
-
                             continue; // Posúvame sa na ďalší znak v postfix výraze
                         }
                         else{ // Druhý operand nie je reťazec
@@ -790,11 +1197,13 @@ int parseExpression(char* result_type, bool *literal) {
                         }
                     }
                     else{ // Operátor nie je "+"
-                        logErrCodeAnalysis(SEM_ERR_TYPE, postfixExpr.array[index]->ln, postfixExpr.array[index]->col,"expected the '+' operator");
+                        logErrCodeAnalysis(SEM_ERR_TYPE, postfixExpr->array[index]->ln, postfixExpr->array[index]->col,"expected the '+' operator");
                         status = SEM_ERR_TYPE;
                         break;
                     }
                 }
+                int_const2double(var_a, var_b); // Int literál s Double operandom sa prevedie už počas prekladu
+
                 if((var_a->st_type == 'i' || var_a->type == INT_CONST) && (var_b->st_type == 'i' || var_b->type == INT_CONST)) 
                 { // 2 Inty
                     var_a->st_type = 'i'; // Výsledok operácie je typu int
@@ -803,76 +1212,83 @@ int parseExpression(char* result_type, bool *literal) {
                         var_a->type = ID;           // V tomto prípade musíme na zásobník vložiť výsledok operácie ako typ ID, čiže premenná
                     }
 
-                    free(var_b); // Vymazanie tokenu
+                    if(!fold_arithmetic(var_a, var_b, postfixExpr->array[index]->type)){ // Výsledok nie je možné vypočítať počas prekladu
+                        switch (postfixExpr->array[index]->type){
+                        case OP_PLUS:
+                            gen_operation(&stack, var_a, var_b, INS_ADDS, INS_ADD, false);     // Sčítanie hodnôt
+                            break;
+                        case OP_MINUS:
+                            gen_operation(&stack, var_a, var_b, INS_SUBS, INS_SUB, false);     // Odčítanie hodnôt
+                            break;
+                        case OP_DIV:
+                            gen_operation(&stack, var_a, var_b, INS_IDIVS, INS_IDIV, false);   // Podiel integer hodnôt
+                            break;
+                        case OP_MUL:
+                            gen_operation(&stack, var_a, var_b, INS_MULS, INS_MUL, false);     // Vynásobenie hodnôt
+                            break;
+                        }
+                    }
+
+                    memFree(MEM_EXPRESSION, var_b); // Vymazanie tokenu
                     if(stack_push_ptoken(&stack, var_a) != 0){  // Vloženie tokenu na zásobník
-                        free(var_a); // Vymazanie tokenu
-                        endParse_sem(&stack, &postfixExpr);     // Upratanie pred skončením funkcie
+                        memFree(MEM_EXPRESSION, var_a); // Vymazanie tokenu
+                        endParse_sem(&stack);     // Upratanie pred skončením funkcie
                         return COMPILER_ERROR;
                     }
-                    switch (postfixExpr.array[index]->type){
-                    case OP_PLUS:
-                        genCode("ADDS",NULL, NULL, NULL);   // Sčítanie hodnôt na vrchole zásobníka
-                        break;
-                    case OP_MINUS:
-                        genCode("SUBS",NULL, NULL, NULL);   // Odčítanie hodnôt na vrchole zásobníka
-                        break;
-                    case OP_DIV:
-                        genCode("IDIVS",NULL, NULL, NULL);  // Podiel integer hodnôt na vrchole zásobníka
-                        break;
-                    case OP_MUL:
-                        genCode("MULS",NULL, NULL, NULL);   // Vynásobenie hodnôt na vrchole zásobníka
-                        break;
-                    }
 
                     continue; // Posúvame sa na ďalší znak v postfix výraze
                 }
                 if((var_a->st_type == 'd' || var_a->type == DOUBLE_CONST) && (var_b->st_type == 'd' || var_b->type == DOUBLE_CONST))
                 { // 2 Double
                     var_a->st_type = 'd'; // Výsledok operácie je typu double
-                    if((status = stack_push_ptoken(&stack, var_a)) != 0){  // Vloženie tokenu na zásobník
-                        break;
+                    if(!fold_arithmetic(var_a, var_b, postfixExpr->array[index]->type)){ // Výsledok nie je možné vypočítať počas prekladu
+                        switch (postfixExpr->array[index]->type){
+                        case OP_PLUS:
+                            gen_operation(&stack, var_a, var_b, INS_ADDS, INS_ADD, false); // Sčítanie hodnôt
+                            break;
+                        case OP_MINUS:
+                            gen_operation(&stack, var_a, var_b, INS_SUBS, INS_SUB, false); // Odčítanie hodnôt
+                            break;
+                        case OP_DIV:
+                            gen_operation(&stack, var_a, var_b, INS_DIVS, INS_DIV, false); // Podiel hodnôt
+                            break;
+                        case OP_MUL:
+                            gen_operation(&stack, var_a, var_b, INS_MULS, INS_MUL, false); //  Vynásobenie hodnôt
+                            break;
+                        }
                     }
-                    free(var_b); // Vymazanie tokenu
-
-                    switch (postfixExpr.array[index]->type){
-                    case OP_PLUS:
-                        genCode("ADDS",NULL, NULL, NULL); // Sčítanie hodnôt na vrchole zásobníka
-                        break;
-                    case OP_MINUS:
-                        genCode("SUBS",NULL, NULL, NULL); // Odčítanie hodnôt na vrchole zásobníka
-                        break;
-                    case OP_DIV:
-                        genCode("DIVS",NULL, NULL, NULL); // Podiel hodnôt na vrchole zásobníka
-                        break;
-                    case OP_MUL:
-                        genCode("MULS",NULL, NULL, NULL);  //  Vynásobenie hodnôt na vrchole zásobníka
+                    if((status = stack_push_ptoken(&stack, var_a)) != 0){  // Vloženie tokenu na zásobník
                         break;
                     }
+                    memFree(MEM_EXPRESSION, var_b); // Vymazanie tokenu
                     continue; // Posúvame sa na ďalší znak v postfix výraze
                 }
                 if( (var_a->type == INT_CONST && (var_b->type == DOUBLE_CONST || var_b->st_type == 'd') ) || 
                 (var_b->type == INT_CONST && (var_a->type == DOUBLE_CONST || var_a->st_type == 'd') ) ) 
                 { // Int konštanta a Double
+                    if(!exp_three_address){
+                        push_operands(&stack, var_a, var_b); // int2double konvertuje hodnoty na zásobníku
+                    }
                     int2double(var_a, var_b); // Konverzia int typu na double typ
 
                     var_a->st_type = 'd';   // Výsledok operácie je typu double
-                    free(var_b);            // Vymazanie tokenu
-                    if((status = stack_push_ptoken(&stack, var_a)) != 0){  // Vloženie tokenu na zásobník
-                        break;
-                    }
-
-                    switch (postfixExpr.array[index]->type){
+                    switch (postfixExpr->array[index]->type){
                     case OP_PLUS:
-                        genCode("ADDS",NULL, NULL, NULL); // Sčítanie hodnôt na vrchole zásobníka
+                        gen_operation(&stack, var_a, var_b, INS_ADDS, INS_ADD, false); // Sčítanie hodnôt
                         break;
                     case OP_MINUS:
-                        genCode("SUBS",NULL, NULL, NULL); // Odčítanie hodnôt na vrchole zásobníka
+                        gen_operation(&stack, var_a, var_b, INS_SUBS, INS_SUB, false); // Odčítanie hodnôt
                         break;
                     case OP_DIV:
-                        genCode("DIVS",NULL, NULL, NULL); // Podiel hodnôt na vrchole zásobníka
+                        gen_operation(&stack, var_a, var_b, INS_DIVS, INS_DIV, false); // Podiel hodnôt
                         break;
                     case OP_MUL:
-                        genCode("MULS",NULL, NULL, NULL); // Vynásobenie hodnôt na vrchole zásobníka
+                        gen_operation(&stack, var_a, var_b, INS_MULS, INS_MUL, false); // Vynásobenie hodnôt
+                        break;
+                    }
+
+                    memFree(MEM_EXPRESSION, var_b);            // Vymazanie tokenu
+                    if((status = stack_push_ptoken(&stack, var_a)) != 0){  // Vloženie tokenu na zásobník
                         break;
                     }
                     continue; // Posúvame sa na ďalší znak v postfix výraze
@@ -884,49 +1300,58 @@ int parseExpression(char* result_type, bool *literal) {
                     break;
                 }
             }
-            if(is_logical_operator(postfixExpr.array[index]->type)) // Logický operátor
+            if(is_logical_operator(postfixExpr->array[index]->type)) // Logický operátor
             {
+                int_const2double(var_a, var_b); // Int literál s Double operandom sa prevedie už počas prekladu
+                if(!exp_three_address && ((var_a->type == INT_CONST && !is_pending_const(var_a)) ||
+                (var_b->type == INT_CONST && !is_pending_const(var_b)))){
+                    push_operands(&stack, var_a, var_b); // are_compatible_l môže vygenerovať konverziu na zásobníku
+                }
                 if(are_compatible_l(var_a, var_b)) // Overenie, či sú dátové typy kompatibilné pre logickú operáciu
                 { // Ak sú int a double, are_compatible_l vykoná implicitnú konverzia
 
                     if(var_a->st_type == 'b' && var_b->st_type == 'b' &&
-                    (postfixExpr.array[index]->type != EQ && postfixExpr.array[index]->type != NEQ))
+                    (postfixExpr->array[index]->type != EQ && postfixExpr->array[index]->type != NEQ))
                     {// Bool operandy môžu byť porovnané iba operátorom "==" alebo "!="
 
-                        logErrCodeAnalysis(SEM_ERR_TYPE, postfixExpr.array[index]->ln, postfixExpr.array[index]->col,"expected the '==' or '!=' operator");
+                        logErrCodeAnalysis(SEM_ERR_TYPE, postfixExpr->array[index]->ln, postfixExpr->array[index]->col,"expected the '==' or '!=' operator");
                         status = SEM_ERR_TYPE;
                         break;
                     }
 
+                    if(!fold_relational(var_a, var_b, postfixExpr->array[index]->type)){ // Výsledok nie je možné vypočítať počas prekladu
+                        if(label != NULL && index == postfixExpr->size - 1){ // Porovnanie je koreňom podmienky
+                            gen_cond_jump(&stack, var_a, var_b, postfixExpr->array[index]->type, label, jump_when);
+                            branched = true;
+                        }
+                        else{
+                            switch (postfixExpr->array[index]->type){
+                            case EQ:
+                                gen_operation(&stack, var_a, var_b, INS_EQS, INS_EQ, false); // Rovnosť hodnôt
+                                break;
+                            case NEQ:
+                                gen_operation(&stack, var_a, var_b, INS_EQS, INS_EQ, true); // Rovnosť hodnôt => nerovnosť hodnôt
+                                break;
+                            case GT:
+                                gen_operation(&stack, var_a, var_b, INS_GTS, INS_GT, false); // A > B
+                                break;
+                            case LT:
+                                gen_operation(&stack, var_a, var_b, INS_LTS, INS_LT, false); // A<B
+                                break;
+                            case LTEQ:
+                                gen_operation(&stack, var_a, var_b, INS_GTS, INS_GT, true); // A > B => A <= B
+                                break;
+                            case GTEQ:
+                                gen_operation(&stack, var_a, var_b, INS_LTS, INS_LT, true); // A < B => A >= B
+                                break;
+                            }
+                        }
+                    }
                     var_a->st_type = 'b'; // Výsledný token bude typu boolean
                     if((status = stack_push_ptoken(&stack, var_a)) != 0){ // Pushnutie nového tokenu na stack
                         break;
                     }
-                    free(var_b); // Vymazanie druhého tokenu
-
-                    switch (postfixExpr.array[index]->type){
-                    case EQ:
-                        genCode("EQS",NULL, NULL, NULL); // Rovnosť hodnôt
-                        break;
-                    case NEQ:
-                        genCode("EQS",NULL, NULL, NULL); // Rovnosť hodnôt
-                        genCode("NOTS",NULL, NULL, NULL); // => nerovnosť hodnôt
-                        break;
-                    case GT:
-                        genCode("GTS",NULL, NULL, NULL); // A > B
-                        break;
-                    case LT:
-                        genCode("LTS",NULL, NULL, NULL); // A<B
-                        break;
-                    case LTEQ:
-                        genCode("GTS",NULL, NULL, NULL); // A > B
-                        genCode("NOTS",NULL, NULL, NULL); // A <= B
-                        break;
-                    case GTEQ:
-                        genCode("LTS",NULL, NULL, NULL); // A < B
-                        genCode("NOTS",NULL, NULL, NULL); // A >= B
-                        break;
-                    }
+                    memFree(MEM_EXPRESSION, var_b); // Vymazanie druhého tokenu
                     continue; // Posúvame sa na ďalší znak v postfix výraze
                 }
                 
@@ -936,7 +1361,7 @@ int parseExpression(char* result_type, bool *literal) {
                     break;
                 }
             }
-            if(postfixExpr.array[index]->type == TEST_NIL) // Test nil hodnoty "??"
+            if(postfixExpr->array[index]->type == TEST_NIL) // Test nil hodnoty "??"
             {
                 if(is_nil_type(var_b)) // Druhý operand je nil alebo nil typ
                 {
@@ -946,32 +1371,65 @@ int parseExpression(char* result_type, bool *literal) {
                 }
                 if(var_a->st_type == 'N')// Prvý operand je nil
                 {
+                    if(var_a->pushed){ // Ak nil ešte nie je na zásobníku, výsledkom je priamo druhý operand
+                        push_operands(&stack, var_a, var_b);
+                        genCode(INS_POPS,"GF@!tmp1", NULL, NULL);     // Popnutie non-nil premennej do pomocnej premennej
+                        genCode(INS_POPS,"GF@!tmp2", NULL, NULL);     // Odstránenie nil zo zásobníka
+                        genCode(INS_PUSHS,"GF@!tmp1", NULL, NULL);    // Vrátenie non-nil premennej späť na zásobník
+                    }
+                    if(exp_three_address && is_temp(var_b)){ // Medzivýsledok sa presunie na pozíciu prvého operandu
+                        atom_T *result = genExpTemp(stack.size);
+                        genCodeAtoms(INS_MOVE, result, var_b->codename, NULL);
+                        var_b->codename = result;
+                    }
                     if((status = stack_push_ptoken(&stack, var_b)) != 0){  // Pushnutie druhého tokenu na stack
                         break;
                     }
-                    free(var_a); // Vymazanie prvého tokenu
-                    genCode("POPS","GF@!tmp1", NULL, NULL);     // Popnutie non-nil premennej do pomocnej premennej
-                    genCode("POPS","GF@!tmp2", NULL, NULL);     // Odstránenie nil zo zásobníka
-                    genCode("PUSHS","GF@!tmp1", NULL, NULL);    // Vrátenie non-nil premennej späť na zásobník
+                    memFree(MEM_EXPRESSION, var_a); // Vymazanie prvého tokenu
                     continue; // Posúvame sa na ďalší token
                 }
                 if(are_compatible_n(var_a, var_b)) // Ak majú tokeny kompatibilný dátový typ
                 {
                     if(!is_nil_type(var_a)) // Prvý operand nikdy nebude nil => je výsledok výrazu
                     {
+                        if(var_b->pushed){ // Druhý operand, ktorý ešte nie je na zásobníku, sa iba zahodí
+                            genCode(INS_POPS,"GF@!tmp1", NULL, NULL); // Odstránenie nil zo zásobníka
+                        }
                         if((status = stack_push_ptoken(&stack, var_a)) != 0){  // Pushnutie druhého tokenu na stack
                         break;
                         }
-                        free(var_b); // Vymazanie druhého tokenu
-                        genCode("POPS","GF@!tmp1", NULL, NULL); // Odstránenie nil zo zásobníka
+                        memFree(MEM_EXPRESSION, var_b); // Vymazanie druhého tokenu
+                        continue;
+                    }
+                    else if(exp_three_address) // Prvý operand môže byť nil, výsledok je v pomocnej premennej
+                    {
+                        atom_T *result = genExpTemp(stack.size);
+                        str_T label;
+                        StrInit(&label);
+                        genUniqLabel("testnil","l1",&label); // Vygenerovanie labelu pre podmienený skok
+
+                        if(var_a->codename != result){
+                            genCodeAtoms(INS_MOVE, result, var_a->codename, NULL); // Výsledok je prvý operand
+                        }
+                        genCode(INS_JUMPIFNEQ, StrRead(&label), result->text, "nil@nil"); // Prvý operand nie je nil
+                        genCodeAtoms(INS_MOVE, result, var_b->codename, NULL); // Inak je výsledok druhý operand
+                        genCode(INS_LABEL, StrRead(&label), NULL, NULL);
+                        StrDestroy(&label);
+
+                        var_b->codename = result;
+                        if((status = stack_push_ptoken(&stack, var_b)) != 0){  // Pushnutie druhého tokenu na stack
+                        break;
+                        }
+                        memFree(MEM_EXPRESSION, var_a); // Vymazanie prvého tokenu
                         continue;
                     }
                     else // Prvý operand môže byť nil
                     {
+                        push_operands(&stack, var_a, var_b);
                         if((status = stack_push_ptoken(&stack, var_b)) != 0){  // Pushnutie druhého tokenu na stack
                         break;
                         }
-                        free(var_a); // Vymazanie druhého tokenu
+                        memFree(MEM_EXPRESSION, var_a); // Vymazanie druhého tokenu
 
                         str_T label1, label2;
                         StrInit(&label1);
@@ -980,14 +1438,14 @@ int parseExpression(char* result_type, bool *literal) {
                         genUniqLabel("testnil","l1",&label1); // Vygenerovanie labelu pre podmienený skok
                         genUniqLabel("testnil","l2",&label2); // Vygenerovanie labelu pre podmienený skok
 
-                        genCode("POPS","GF@!tmp2", NULL, NULL); // Popnutie non-nil premennej do pomocnej premennej
-                        genCode("POPS","GF@!tmp1", NULL, NULL); // Popnutie possible-nil premennej do pomocnej premennej
-                        genCode("JUMPIFEQ", StrRead(&label1),"GF@!tmp1", "nil@nil"); // Ak sa prvá premenná rovná nil, skok na náveštie 1
-                        genCode("PUSHS","GF@!tmp1", NULL, NULL); // V tomto prípade prvá premenná nie je nil, pushnutie prvej premennej na zásobník
-                        genCode("JUMP", StrRead(&label2), NULL, NULL); // Skok na koniec funkcie
-                        genCode("LABEL", StrRead(&label1), NULL, NULL); // Náveštie 1
-                        genCode("PUSHS","GF@!tmp2", NULL, NULL); // V tomto prípade prvá premenná je nil, pushnutie 2. premennej na zásobník
-                        genCode("LABEL", StrRead(&label2), NULL, NULL); // Náveštie 2 - koniec funkcie
+                        genCode(INS_POPS,"GF@!tmp2", NULL, NULL); // Popnutie non-nil premennej do pomocnej premennej
+                        genCode(INS_POPS,"GF@!tmp1", NULL, NULL); // Popnutie possible-nil premennej do pomocnej premennej
+                        genCode(INS_JUMPIFEQ, StrRead(&label1),"GF@!tmp1", "nil@nil"); // Ak sa prvá premenná rovná nil, skok na náveštie 1
+                        genCode(INS_PUSHS,"GF@!tmp1", NULL, NULL); // V tomto prípade prvá premenná nie je nil, pushnutie prvej premennej na zásobník
+                        genCode(INS_JUMP, StrRead(&label2), NULL, NULL); // Skok na koniec funkcie
+                        genCode(INS_LABEL, StrRead(&label1), NULL, NULL); // Náveštie 1
+                        genCode(INS_PUSHS,"GF@!tmp2", NULL, NULL); // V tomto prípade prvá premenná je nil, pushnutie 2. premennej na zásobník
+                        genCode(INS_LABEL, StrRead(&label2), NULL, NULL); // Náveštie 2 - koniec funkcie
 
                         StrDestroy(&label1);
                         StrDestroy(&label2);
@@ -1003,7 +1461,7 @@ int parseExpression(char* result_type, bool *literal) {
             }
         }
         
-        if(postfixExpr.array[index]->type == EXCL) // Výkričník
+        if(postfixExpr->array[index]->type == EXCL) // Výkričník
         {
             if(stack_top(&stack)->st_type == 'I'){ // typ Int? 
                 stack_top(&stack)->st_type = 'i'; // pretypovanie na Int
@@ -1024,28 +1482,82 @@ int parseExpression(char* result_type, bool *literal) {
     }// Koniec for loopu
 
     if(status != COMPILATION_OK){ // Počas sémantickej analýzy bola zistená chyba
-        free(var_a);
-        free(var_b);
-        endParse_sem(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+        memFree(MEM_EXPRESSION, var_a);
+        memFree(MEM_EXPRESSION, var_b);
+        endParse_sem(&stack); // Upratanie pred skončením funkcie
         return status; // Koniec 
     }
 
     if(stack.size == 1){ // Výsledný typ je na vrchole zásobníka
+        if(label == NULL){
+            push_operands(&stack, NULL, NULL); // Vloženie výsledku, ak bol vypočítaný počas prekladu
+        }
+        else if(!branched){
+            gen_value_jump(stack_top(&stack), label, jump_when);
+        }
         *result_type = stack_top(&stack)->st_type; // Zapísanie výsledného typu výrazu
         if(stack_top(&stack)->type == INT_CONST){
             *literal = true; // Výsledok je int literál, je možné ho implicitne pretypovať na double
         }
-        endParse_sem(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+        endParse_sem(&stack); // Upratanie pred skončením funkcie
 
         return COMPILATION_OK; // Úspešný koniec
     }
     else{
-        endParse_sem(&stack, &postfixExpr); // Upratanie pred skončením funkcie
+        endParse_sem(&stack); // Upratanie pred skončením funkcie
         return SEM_ERR_OTHER;
     }
     
     return COMPILATION_OK;
 }
 
+/**
+ * @brief Spracuje výraz, pri label != NULL ide o podmienku, viď. eval_postfix
+**/
+int parse_expression(char* result_type, bool *literal, char *label, bool jump_when) {
+    stack_t postfixExpr;
+    int status = parse_postfix(&postfixExpr);
+    if(status != COMPILATION_OK){
+        return status;
+    }
+    status = eval_postfix(&postfixExpr, result_type, literal, label, jump_when);
+    stack_dispose(&postfixExpr);
+    return status;
+}
+
+int parseExpression(char* result_type, bool *literal) {
+    TIMER_BEGIN(TIMER_EXPRESSION);
+    int status = parse_expression(result_type, literal, NULL, false);
+    TIMER_END();
+    return status;
+}
+
+int parseCondition(char* result_type, char *label_false) {
+    bool literal = false; // V podmienke sa implicitná konverzia nevyužíva
+    TIMER_BEGIN(TIMER_EXPRESSION);
+    int status = parse_expression(result_type, &literal, label_false, false);
+    TIMER_END();
+    return status;
+}
+
+int parseLoopCondition(char* result_type, char *label_end, char *label_body, codeBlock_T *bottom_test) {
+    bool literal = false;
+    stack_t postfixExpr;
+    TIMER_BEGIN(TIMER_EXPRESSION);
+    int status = parse_postfix(&postfixExpr);
+    if(status != COMPILATION_OK){
+        TIMER_END();
+        return status;
+    }
+    status = eval_postfix(&postfixExpr, result_type, &literal, label_end, false); // Test pred vstupom do cyklu
+    if(status == COMPILATION_OK){
+        size_t mark = genCodeMark();
+        status = eval_postfix(&postfixExpr, result_type, &literal, label_body, true); // Test za telom cyklu
+        genCodeCut(mark, bottom_test);
+    }
+    stack_dispose(&postfixExpr);
+    TIMER_END();
+    return status;
+}
 
 /* Koniec súboru exp.c */
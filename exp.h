@@ -9,6 +9,24 @@
 #define _EXP_H_
 
 #include "parser.h"
+#include "generator.h"
+
+/**
+ * Pri false (predvolené) sa výrazy vyhodnocujú na dátovom zásobníku (PUSHS, ADDS, LTS, ...).
+ * Pri true sa generuje trojadresný kód (ADD, LT, CONCAT, ...), medzivýsledky sú v pomocných
+ * premenných genExpTemp a na zásobník sa vkladá iba výsledok výrazu.
+ *
+ * @brief Spôsob generovania kódu výrazov, nastavuje sa prepínačom prekladača --tac
+*/
+extern bool exp_three_address;
+
+/**
+ * @brief Dekóduje reťazcovú konštantu cieľového kódu (escape sekvencie \ddd)
+ * @param value reťazec bez prefixu "string@"
+ * @param decoded inicializovaný reťazec, na jeho koniec sa pridajú dekódované znaky
+ * @return true ak reťazec obsahuje iba ASCII znaky, inak false, pretože ich poradie určuje až interpret
+*/
+bool decode_ascii_const(const char *value, str_T *decoded);
 
 /**
  * Táto funkcia:
@@ -31,5 +49,32 @@
 */
 int parseExpression(char* result_type, bool *literal);
 
+/**
+ * Podmienka sa spracuje rovnako ako výraz v parseExpression, jej výsledok sa však nevkladá na zásobník.
+ * Ak je koreňom výrazu porovnanie, vygeneruje sa priamo podmienený skok (napr. a != b => JUMPIFEQ),
+ * inak sa skočí podľa bool výsledku. Podmienka konštantná počas prekladu skok buď vynechá, alebo ho
+ * vygeneruje ako JUMP.
+ *
+ * @brief Precedenčná syntaktická analýza podmienky if a while
+ * @param result_type Dátový typ výsledku výrazu
+ * @param label_false Náveštie, na ktoré sa skočí, keď podmienka neplatí
+ * @return 0 v prípade úspechu, inak číslo chyby
+*/
+int parseCondition(char* result_type, char *label_false);
+
+/**
+ * Podmienka cyklu sa spracuje raz, jej kód sa však vygeneruje dvakrát: test pred vstupom do cyklu
+ * (skok na label_end, keď neplatí) a test za telom cyklu (skok späť na label_body, keď platí).
+ * Test za telom sa namiesto aktuálneho bloku uloží do bottom_test, viď. genCodePaste.
+ *
+ * @brief Precedenčná syntaktická analýza podmienky rotovaného cyklu while
+ * @param result_type Dátový typ výsledku výrazu
+ * @param label_end Náveštie za cyklom
+ * @param label_body Náveštie začiatku tela cyklu
+ * @param bottom_test Prázdny blok pre kód testu za telom cyklu
+ * @return 0 v prípade úspechu, inak číslo chyby
+*/
+int parseLoopCondition(char* result_type, char *label_end, char *label_body, codeBlock_T *bottom_test);
+
 #endif // ifndef _EXP_H_
 /* Koniec súboru exp.h */
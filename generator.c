@@ -6,16 +6,408 @@
  */
 
 #include "generator.h"
+#include "emit.h"
+#include "timer.h"
+#include "mem.h"
+#include "stats.h"
 #include <stdarg.h>
 
-DLLstr_T code_fn;
-DLLstr_T code_main;
+codeFnList_T code_fn;
+codeBlock_T code_main;
 
 void fnParamIdentificator(char *identificator, str_T *id);
 
+/**
+ * @brief Textové názvy inštrukcií, indexované operačným kódom
+*/
+static const char *ins_names[INS_COUNT] = {
+    "MOVE", "CREATEFRAME", "PUSHFRAME", "POPFRAME", "DEFVAR", "CALL", "RETURN",
+    "PUSHS", "POPS", "CLEARS",
+    "ADD", "SUB", "MUL", "DIV", "IDIV", "ADDS", "SUBS", "MULS", "DIVS", "IDIVS",
+    "LT", "GT", "EQ", "LTS", "GTS", "EQS",
+    "AND", "OR", "NOT", "ANDS", "ORS", "NOTS",
+    "INT2FLOAT", "FLOAT2INT", "INT2CHAR", "STRI2INT", "INT2FLOATS", "FLOAT2INTS", "INT2CHARS", "STRI2INTS",
+    "READ", "WRITE",
+    "CONCAT", "STRLEN", "GETCHAR", "SETCHAR",
+    "TYPE",
+    "LABEL", "JUMP", "JUMPIFEQ", "JUMPIFNEQ", "JUMPIFEQS", "JUMPIFNEQS",
+    "EXIT", "BREAK", "DPRINT",
+    "HOIST"
+};
+
+/**
+ * @brief Tabuľka náveští generátora
+ * @details Náveštia sú uložené za sebou v jednom poli chars, offsets[id] je začiatok náveštia id.
+ * Rozptylová tabuľka slots (otvorené adresovanie) obsahuje id + 1, 0 značí voľné miesto.
+ * Náveštia nie sú atómy, aby ich genRelease mohol po odložení kódu zahodiť.
+*/
+static struct {
+    char *chars;            ///< uložené náveštia ukončené znakom \0
+    size_t chars_used;
+    size_t chars_size;
+    size_t *offsets;        ///< začiatky náveští v chars
+    unsigned int count;     ///< počet náveští
+    unsigned int offsets_size;
+    unsigned int *slots;    ///< rozptylová tabuľka
+    size_t slots_size;      ///< veľkosť rozptylovej tabuľky, mocnina dvojky
+} labels;
+
+/**
+ * @brief Zásobník indexov blokov v code_fn práve definovaných (vnorených) funkcií
+*/
+static struct {
+    size_t *items;
+    size_t used;
+    size_t size;
+} fn_blocks;
+
+/**
+ * @brief Definície premenných pre miesta pred cyklami (INS_HOIST)
+ * @details Miesto slot má definície vars[slots[slot].start .. start + count).
+*/
+static struct {
+    operand_T *vars;    ///< premenné všetkých miest za sebou
+    size_t vars_used;
+    size_t vars_size;
+    struct {
+        size_t start;
+        size_t count;
+    } *slots;
+    size_t slots_used;
+    size_t slots_size;
+} hoist;
+
+/**
+ * @brief Počet pomocných premenných pre medzivýsledky výrazov (GF@!tmp4, GF@!tmp5, ...)
+*/
+static int exp_temps = 0;
+
+size_t gen_inline_limit = 0;
+
+/**
+ * @brief Funkcie zaznamenané pri genFnDefEnd na vkladanie do miesta volania (genInlineCall)
+*/
+static struct {
+    struct {
+        unsigned int name;  ///< názov funkcie v tabuľke náveští
+        size_t block;       ///< index bloku funkcie v code_fn
+        size_t sites;       ///< počet miest volania, kam bola funkcia vložená
+    } *fns;
+    size_t fns_used;
+    size_t fns_size;
+    size_t *by_name;        ///< index v fns + 1 podľa názvu funkcie, 0 ak funkcia nie je zaznamenaná
+    size_t by_name_size;
+} inl;
+
+/**
+ * @brief Realokuje pole, pri chybe ukončí prekladač
+*/
+static void *genRealloc(void *ptr, size_t size) {
+    void *new_ptr = memRealloc(MEM_GENERATOR, ptr, size);
+    if (new_ptr == NULL) {
+        fprintf(stderr, "generator: memory allocation error.\n");
+        exit(COMPILER_ERROR);
+    }
+    return new_ptr;
+}
+
+/**
+ * @brief Inicializuje prázdnu tabuľku náveští
+*/
+static void genLabelsInit() {
+    labels.chars = NULL;
+    labels.chars_used = labels.chars_size = 0;
+    labels.offsets = NULL;
+    labels.count = labels.offsets_size = 0;
+    labels.slots_size = 1024;
+    labels.slots = memCalloc(MEM_GENERATOR, labels.slots_size, sizeof(unsigned int));
+    if (labels.slots == NULL) {
+        fprintf(stderr, "genInit() memory allocation error.\n");
+        exit(COMPILER_ERROR);
+    }
+}
+
+void genInit() {
+    code_main = (codeBlock_T){NULL, 0, 0, 0, 0, false};
+    code_fn = (codeFnList_T){NULL, 0, 0};
+    fn_blocks.items = NULL;
+    fn_blocks.used = fn_blocks.size = 0;
+    hoist.vars = NULL;
+    hoist.vars_used = hoist.vars_size = 0;
+    hoist.slots = NULL;
+    hoist.slots_used = hoist.slots_size = 0;
+    inl.fns = NULL;
+    inl.fns_used = inl.fns_size = 0;
+    inl.by_name = NULL;
+    inl.by_name_size = 0;
+    genLabelsInit();
+}
+
+void genDestroy() {
+    memFree(MEM_GENERATOR, code_main.ins);
+    for (size_t i = 0; i < code_fn.used; i++) memFree(MEM_GENERATOR, code_fn.blocks[i].ins);
+    memFree(MEM_GENERATOR, code_fn.blocks);
+    memFree(MEM_GENERATOR, fn_blocks.items);
+    memFree(MEM_GENERATOR, hoist.vars);
+    memFree(MEM_GENERATOR, hoist.slots);
+    memFree(MEM_GENERATOR, inl.fns);
+    memFree(MEM_GENERATOR, inl.by_name);
+    memFree(MEM_GENERATOR, labels.chars);
+    memFree(MEM_GENERATOR, labels.offsets);
+    memFree(MEM_GENERATOR, labels.slots);
+    code_main = (codeBlock_T){NULL, 0, 0, 0, 0, false};
+    code_fn = (codeFnList_T){NULL, 0, 0};
+    fn_blocks.items = NULL;
+    fn_blocks.used = fn_blocks.size = 0;
+    hoist.vars = NULL;
+    hoist.vars_used = hoist.vars_size = 0;
+    hoist.slots = NULL;
+    hoist.slots_used = hoist.slots_size = 0;
+    inl.fns = NULL;
+    inl.fns_used = inl.fns_size = 0;
+    inl.by_name = NULL;
+    inl.by_name_size = 0;
+    labels.chars = NULL;
+    labels.offsets = NULL;
+    labels.slots = NULL;
+    labels.chars_used = labels.chars_size = labels.slots_size = 0;
+    labels.count = labels.offsets_size = 0;
+    exp_temps = 0;
+}
+
+/**
+ * @brief genLabel s už známou rozptylovou hodnotou náveštia (StrHash), napr. z atómu
+*/
+static unsigned int genLabelHashed(const char *text, unsigned long hash) {
+    if (labels.slots == NULL) genLabelsInit();
+
+    size_t mask = labels.slots_size - 1;
+    size_t i = hash & mask;
+    while (labels.slots[i] != 0) {
+        unsigned int id = labels.slots[i] - 1;
+        if (strcmp(labels.chars + labels.offsets[id], text) == 0) return id;
+        i = (i + 1) & mask;
+    }
+
+    // nové náveštie
+    size_t len = strlen(text) + 1;
+    if (labels.chars_used + len > labels.chars_size) {
+        labels.chars_size = 2 * labels.chars_size + len;
+        labels.chars = genRealloc(labels.chars, labels.chars_size);
+    }
+    if (labels.count == labels.offsets_size) {
+        labels.offsets_size = labels.offsets_size == 0 ? 256 : 2 * labels.offsets_size;
+        labels.offsets = genRealloc(labels.offsets, labels.offsets_size * sizeof(size_t));
+    }
+    memcpy(labels.chars + labels.chars_used, text, len);
+    labels.offsets[labels.count] = labels.chars_used;
+    labels.chars_used += len;
+    unsigned int id = labels.count++;
+    labels.slots[i] = id + 1;
+
+    // udržanie zaplnenia rozptylovej tabuľky najviac na polovici, náveštia sa vkladajú v poradí id,
+    // genRelease ich preto môže odoberať od konca
+    if (2 * labels.count > labels.slots_size) {
+        size_t new_size = 2 * labels.slots_size;
+        unsigned int *new_slots = memCalloc(MEM_GENERATOR, new_size, sizeof(unsigned int));
+        if (new_slots == NULL) {
+            fprintf(stderr, "genLabel() memory allocation error.\n");
+            exit(COMPILER_ERROR);
+        }
+        for (unsigned int n = 0; n < labels.count; n++) {
+            size_t j = StrHash(labels.chars + labels.offsets[n]) & (new_size - 1);
+            while (new_slots[j] != 0) j = (j + 1) & (new_size - 1);
+            new_slots[j] = n + 1;
+        }
+        memFree(MEM_GENERATOR, labels.slots);
+        labels.slots = new_slots;
+        labels.slots_size = new_size;
+    }
+    return id;
+}
+
+unsigned int genLabel(const char *text) {
+    return genLabelHashed(text, StrHash(text));
+}
+
+const char *genOperandText(operand_T *op) {
+    if (op->kind == OPD_LABEL) return labels.chars + labels.offsets[op->id];
+    return AtomById(op->id)->text;
+}
+
+/**
+ * @brief Začne nový blok v code_fn a nastaví ho ako aktuálny
+*/
+static void genFnBlockBegin() {
+    if (code_fn.used == code_fn.size) {
+        code_fn.size = code_fn.size == 0 ? 16 : 2 * code_fn.size;
+        code_fn.blocks = genRealloc(code_fn.blocks, code_fn.size * sizeof(codeBlock_T));
+    }
+    code_fn.blocks[code_fn.used++] = (codeBlock_T){NULL, 0, 0, 0, 0, false};
+
+    if (fn_blocks.used == fn_blocks.size) {
+        fn_blocks.size = fn_blocks.size == 0 ? 8 : 2 * fn_blocks.size;
+        fn_blocks.items = genRealloc(fn_blocks.items, fn_blocks.size * sizeof(size_t));
+    }
+    fn_blocks.items[fn_blocks.used++] = code_fn.used - 1;
+}
+
+/**
+ * @brief Vráti blok kódu, do ktorého sa aktuálne generujú inštrukcie
+*/
+static codeBlock_T *genCurrentBlock() {
+    if (!parser_inside_fn_def) return &code_main;
+    // kód funkcie bez predchádzajúceho genFnDefBegin dostane samostatný blok
+    if (fn_blocks.used == 0) genFnBlockBegin();
+    return &code_fn.blocks[fn_blocks.items[fn_blocks.used - 1]];
+}
+
+/**
+ * @brief Zabezpečí v bloku miesto pre ďalších n inštrukcií
+*/
+static void genReserve(codeBlock_T *block, size_t n) {
+    if (block->used + n <= block->size) return;
+    size_t new_size = block->size == 0 ? 64 : 2 * block->size;
+    if (new_size < block->used + n) new_size = block->used + n;
+    block->ins = genRealloc(block->ins, new_size * sizeof(ins_T));
+    block->size = new_size;
+}
+
+/**
+ * @brief Zaznamená hotovú funkciu na vkladanie, ak má telo najviac gen_inline_limit inštrukcií a nie je rekurzívna
+*/
+static void genInlineRecord(size_t index) {
+    codeBlock_T *block = &code_fn.blocks[index];
+    if (gen_inline_limit == 0 || block->used == 0 || block->ins[0].code != INS_LABEL) return;
+    if (block->tail_calls || block->used - block->body > gen_inline_limit) return;
+    unsigned int name = block->ins[0].op[0].id;
+    for (size_t i = block->body; i < block->used; i++) {
+        if (block->ins[i].code == INS_CALL && block->ins[i].op[0].id == name) return;
+    }
+
+    if (inl.fns_used == inl.fns_size) {
+        inl.fns_size = inl.fns_size == 0 ? 16 : 2 * inl.fns_size;
+        inl.fns = genRealloc(inl.fns, inl.fns_size * sizeof(*inl.fns));
+    }
+    if (name >= inl.by_name_size) {
+        size_t new_size = labels.count > 2 * inl.by_name_size ? labels.count : 2 * inl.by_name_size;
+        inl.by_name = genRealloc(inl.by_name, new_size * sizeof(size_t));
+        memset(inl.by_name + inl.by_name_size, 0, (new_size - inl.by_name_size) * sizeof(size_t));
+        inl.by_name_size = new_size;
+    }
+    inl.fns[inl.fns_used].name = name;
+    inl.fns[inl.fns_used].block = index;
+    inl.fns[inl.fns_used].sites = 0;
+    inl.by_name[name] = ++inl.fns_used;
+}
+
+void genFnDefEnd() {
+    if (fn_blocks.used == 0) return;
+    codeBlock_T *block = &code_fn.blocks[fn_blocks.items[fn_blocks.used - 1]];
+    genExpandHoists(block);
+    if (block->tail_calls) genHoistFnBody(block);
+    genInlineRecord(fn_blocks.items[fn_blocks.used - 1]);
+    fn_blocks.used--;
+}
+
+/**
+ * @brief Zistí, či je operand na pozícii pos inštrukcie code náveštím
+*/
+static bool genIsLabel(ins_code_T code, int pos) {
+    return pos == 0 && (code == INS_LABEL || code == INS_JUMP || code == INS_CALL ||
+        code == INS_JUMPIFEQ || code == INS_JUMPIFNEQ || code == INS_JUMPIFEQS || code == INS_JUMPIFNEQS);
+}
+
+/**
+ * @brief Prevedie operand, ktorý je atómom, na typovaný operand
+ * @param code inštrukcia, ktorej operand patrí
+ * @param pos poradie operandu (od 0)
+ * @param atom celý text operandu v tvare cieľového kódu, alebo NULL
+*/
+static operand_T genAtomOperand(ins_code_T code, int pos, atom_T *atom) {
+    operand_T op = {OPD_NONE, 0, 0};
+    if (atom == NULL) return op;
+
+    op.id = atom->id;
+    if (genIsLabel(code, pos)) {
+        op.kind = OPD_LABEL;
+        op.id = genLabelHashed(atom->text, atom->hash);
+    }
+    else if (pos == 1 && code == INS_READ) {
+        op.kind = OPD_TYPE;
+    }
+    else if (ATOM_IS_VAR(atom->kind)) {
+        op.kind = OPD_VAR;
+        op.sub = FRAME_GF + (atom->kind - ATOM_VAR_GF);
+    }
+    else if (ATOM_IS_CONST(atom->kind)) {
+        op.kind = OPD_CONST;
+        op.sub = CONST_INT + (atom->kind - ATOM_CONST_INT);
+    }
+    else {
+        // neznámy tvar (napr. premenná bez kódového mena v jednotkových testoch) sa zachová doslovne
+        op.kind = OPD_TEXT;
+    }
+    return op;
+}
+
+/**
+ * @brief Prevedie operand v textovom tvare na typovaný operand
+ * @param code inštrukcia, ktorej operand patrí
+ * @param pos poradie operandu (od 0)
+ * @param text operand v tvare cieľového kódu, alebo NULL
+*/
+static operand_T genParseOperand(ins_code_T code, int pos, char *text) {
+    if (text == NULL) return (operand_T){OPD_NONE, 0, 0};
+    // náveštie nie je atóm, inak by ho genRelease nemohol zahodiť
+    if (genIsLabel(code, pos)) return (operand_T){OPD_LABEL, 0, genLabel(text)};
+    return genAtomOperand(code, pos, AtomIntern(text));
+}
+
+operand_T genOperand(char *text) {
+    return genParseOperand(INS_MOVE, 1, text);
+}
+
+void genInsert(ins_T *ins) {
+    codeBlock_T *block = genCurrentBlock();
+    genReserve(block, 1);
+    block->ins[block->used++] = *ins;
+}
+
+void genRenderIns(ins_T *ins, str_T *out) {
+    StrCatString(out, (char *)ins_names[ins->code]);
+    for (int i = 0; i < 3 && ins->op[i].kind != OPD_NONE; i++) {
+        operand_T *op = &(ins->op[i]);
+        StrAppend(out, ' ');
+        StrCatString(out, (char *)genOperandText(op));
+    }
+}
+
+const char *genInsName(ins_code_T code) {
+    return ins_names[code];
+}
+
+void genPrintBlock(codeBlock_T *block) {
+    genExpandHoists(block);
+    if (stats_enabled) statsBlock(block);
+    for (size_t i = 0; i < block->used; i++) {
+        ins_T *ins = &(block->ins[i]);
+        emitString(ins_names[ins->code]);
+        for (int o = 0; o < 3 && ins->op[o].kind != OPD_NONE; o++) {
+            operand_T *op = &(ins->op[o]);
+            emitText(" ", 1);
+            emitString(genOperandText(op));
+        }
+        emitText("\n", 1);
+    }
+}
+
+/// Počítadlá genUniqVar a genUniqLabel
+static int uniq_var_count = 0;
+static int uniq_label_count = 0;
+
 void genUniqVar(char *scope, char *sub, str_T *id) {
-    static int count = 0;
-    count++;
+    int count = ++uniq_var_count;
 
     char numStr[100];
     sprintf(numStr, "%d", count);
@@ -32,8 +424,7 @@ void genUniqVar(char *scope, char *sub, str_T *id) {
 }
 
 void genUniqLabel(char *fn, char *sub, str_T *label){
-    static int count = 0;
-    count++;
+    int count = ++uniq_label_count;
 
     char numStr[100];
     sprintf(numStr, "%d", count);
@@ -47,6 +438,14 @@ void genUniqLabel(char *fn, char *sub, str_T *label){
     StrCatString(label, numStr);
 }
 
+int genUniqVarCount() {
+    return uniq_var_count;
+}
+
+int genUniqLabelCount() {
+    return uniq_label_count;
+}
+
 void genConstVal(int const_type, char *value, str_T *cval) {
     switch (const_type) {
         case 8:;
@@ -81,128 +480,407 @@ void genConstVal(int const_type, char *value, str_T *cval) {
     }
 }
 
-void genCode(char *instruction, char *op1, char *op2, char *op3) {
-    if (instruction == NULL)
+void genCode(ins_code_T instruction, char *op1, char *op2, char *op3) {
+    if (instruction >= INS_COUNT)
+        exit (COMPILER_ERROR);
+
+    TIMER_BEGIN(TIMER_GEN_CODE);
+    ins_T ins;
+    ins.code = instruction;
+    ins.op[0] = genParseOperand(instruction, 0, op1);
+    ins.op[1] = genParseOperand(instruction, 1, op2);
+    ins.op[2] = genParseOperand(instruction, 2, op3);
+
+    genInsert(&ins);
+    TIMER_END();
+}
+
+void genCodeAtoms(ins_code_T instruction, atom_T *op1, atom_T *op2, atom_T *op3) {
+    if (instruction >= INS_COUNT)
         exit (COMPILER_ERROR);
 
-    str_T *code = malloc(sizeof(str_T));
-    if(code == NULL) exit(COMPILER_ERROR);
-    StrInit(code);
+    TIMER_BEGIN(TIMER_GEN_CODE);
+    ins_T ins;
+    ins.code = instruction;
+    ins.op[0] = genAtomOperand(instruction, 0, op1);
+    ins.op[1] = genAtomOperand(instruction, 1, op2);
+    ins.op[2] = genAtomOperand(instruction, 2, op3);
 
-    StrFillWith(code, instruction);
+    genInsert(&ins);
+    TIMER_END();
+}
 
-    if (op1 != NULL) {
-        StrAppend(code, ' ');
-        StrCatString(code, op1);
+void genInt2FloatS() {
+    codeBlock_T *block = genCurrentBlock();
+    if (block->used > 0) {
+        operand_T *top = &(block->ins[block->used - 1].op[0]);
+        if (block->ins[block->used - 1].code == INS_PUSHS && top->kind == OPD_CONST && top->sub == CONST_INT) {
+            char value[64];
+            snprintf(value, sizeof(value), "float@%a", (double)strtoll(genOperandText(top) + strlen("int@"), NULL, 10));
+            *top = genOperand(value);
+            return;
+        }
     }
+    genCode(INS_INT2FLOATS, NULL, NULL, NULL);
+}
+
+atom_T *genExpTemp(int slot) {
+    char name[32];
+    snprintf(name, sizeof(name), "%s%d", VAR_TMP_PREFIX, slot + 4);
+    if (slot + 1 > exp_temps) exp_temps = slot + 1;
+    return AtomIntern(name);
+}
+
+int genExpTempCount() {
+    return exp_temps;
+}
 
-    if (op2 != NULL) {
-        StrAppend(code, ' ');
-        StrCatString(code, op2);
+size_t genCodeMark() {
+    return genCurrentBlock()->used;
+}
+
+void genCodeCut(size_t mark, codeBlock_T *out) {
+    codeBlock_T *block = genCurrentBlock();
+    size_t n = block->used - mark;
+    if (n == 0) return;
+    genReserve(out, n);
+    memcpy(out->ins + out->used, block->ins + mark, n * sizeof(ins_T));
+    out->used += n;
+    for (size_t i = mark; i < block->used; i++) {
+        if (block->ins[i].code == INS_HOIST) {
+            block->hoists--;
+            out->hoists++;
+        }
     }
+    block->used = mark;
+}
 
-    if (op3 != NULL) {
-        StrAppend(code, ' ');
-        StrCatString(code, op3);
+void genCodePaste(codeBlock_T *saved) {
+    codeBlock_T *block = genCurrentBlock();
+    if (saved->used > 0) {
+        genReserve(block, saved->used);
+        memcpy(block->ins + block->used, saved->ins, saved->used * sizeof(ins_T));
+        block->used += saved->used;
+        block->hoists += saved->hoists;
     }
+    memFree(MEM_GENERATOR, saved->ins);
+    *saved = (codeBlock_T){NULL, 0, 0, 0, 0, false};
+}
 
-    if(parser_inside_fn_def == true)
-        DLLstr_InsertLast(&code_fn, StrRead(code));
-    else
-        DLLstr_InsertLast(&code_main, StrRead(code));
+size_t genLoopHoistSlot() {
+    if (hoist.slots_used == hoist.slots_size) {
+        hoist.slots_size = hoist.slots_size == 0 ? 64 : 2 * hoist.slots_size;
+        hoist.slots = genRealloc(hoist.slots, hoist.slots_size * sizeof(*hoist.slots));
+    }
+    size_t slot = hoist.slots_used++;
+    hoist.slots[slot].start = hoist.slots[slot].count = 0;
 
-    StrDestroy(code);
-    free(code);
+    codeBlock_T *block = genCurrentBlock();
+    genReserve(block, 1);
+    ins_T *ins = &(block->ins[block->used++]);
+    ins->code = INS_HOIST;
+    ins->op[0] = (operand_T){OPD_NONE, 0, (unsigned int)slot};
+    ins->op[1] = ins->op[2] = (operand_T){OPD_NONE, 0, 0};
+    block->hoists++;
+    return slot;
 }
 
-void genDefVarsBeforeLoop(char *label, DLLstr_T *variables) {
+void genDefVarsBeforeLoop(size_t slot, DLLstr_T *variables) {
     //Získání hodnoty z něterého seznamu
     str_T var;
-    //Zde bude uložená instrukce
-    str_T instruction;
-    str_T label_instruction;
-    DLLstr_T *list;
+    StrInit(&var);
 
-    if (parser_inside_fn_def) {
-        list = &code_fn;
-    } else {
-        list = &code_main;
+    hoist.slots[slot].start = hoist.vars_used;
+    for (DLLstr_First(variables); DLLstr_IsActive(variables); DLLstr_Next(variables)) {
+        DLLstr_GetValue(variables, &var);
+        if (hoist.vars_used == hoist.vars_size) {
+            hoist.vars_size = hoist.vars_size == 0 ? 64 : 2 * hoist.vars_size;
+            hoist.vars = genRealloc(hoist.vars, hoist.vars_size * sizeof(operand_T));
+        }
+        hoist.vars[hoist.vars_used++] = genParseOperand(INS_DEFVAR, 0, StrRead(&var));
     }
+    hoist.slots[slot].count = hoist.vars_used - hoist.slots[slot].start;
 
-    StrInit(&label_instruction);
-    StrFillWith(&label_instruction, "LABEL ");
-    StrCatString(&label_instruction, label);
-
-    StrInit(&instruction);
-    StrInit(&var);
-
-    DLLstr_First(variables);
-    DLLstr_Last(list);
+    StrDestroy(&var);
+}
 
-    //Vyhledání labelu v dll code_fn
-    while (DLLstr_IsActive(list)) {
+void genExpandHoists(codeBlock_T *block) {
+    if (block->hoists == 0) return;
 
-        DLLstr_GetValue(list, &var);
+    size_t total = block->used - block->hoists;
+    for (size_t i = 0; i < block->used; i++) {
+        if (block->ins[i].code == INS_HOIST) total += hoist.slots[block->ins[i].op[0].id].count;
+    }
 
-        //Label byl vyhledán
-        if (strcmp(StrRead(&var), StrRead(&label_instruction)) == 0) {
-            
-            //Před label v dll code_fn se vloží instrukce dle popisu funkce
-            while(DLLstr_IsActive(variables)) {
-                
-                DLLstr_GetValue(variables, &var);
+    ins_T *expanded = genRealloc(NULL, (total > 0 ? total : 1) * sizeof(ins_T));
+    size_t n = 0;
+    for (size_t i = 0; i < block->used; i++) {
+        ins_T *ins = &(block->ins[i]);
+        if (ins->code != INS_HOIST) {
+            expanded[n++] = *ins;
+            continue;
+        }
+        size_t start = hoist.slots[ins->op[0].id].start;
+        size_t count = hoist.slots[ins->op[0].id].count;
+        for (size_t v = start; v < start + count; v++) {
+            expanded[n].code = INS_DEFVAR;
+            expanded[n].op[0] = hoist.vars[v];
+            expanded[n].op[1] = expanded[n].op[2] = (operand_T){OPD_NONE, 0, 0};
+            n++;
+        }
+    }
 
-                //Vytvoření a vložení instrukce
-                StrFillWith(&instruction, "DEFVAR ");
-                StrCatString(&instruction, StrRead(&var));
-    
-                DLLstr_InsertBefore(list, StrRead(&instruction));
+    memFree(MEM_GENERATOR, block->ins);
+    block->ins = expanded;
+    block->used = total;
+    block->size = total > 0 ? total : 1;
+    block->hoists = 0;
+}
 
-                DLLstr_Next(variables);
-            }
+void genMark(genMark_T *mark) {
+    mark->labels = labels.count;
+    mark->hoist_vars = hoist.vars_used;
+    mark->hoist_slots = hoist.slots_used;
+    mark->fn_blocks = code_fn.used;
+}
 
-            break;
-        }
+bool genRelease(genMark_T *mark) {
+    if (code_fn.used != mark->fn_blocks) return false;
 
-        DLLstr_Previous(list);
+    // náveštia sa odoberajú v opačnom poradí, ako boli pridané, žiadne zostávajúce náveštie preto
+    // pri lineárnom skúšaní neprechádzalo cez uvoľnené miesto
+    size_t mask = labels.slots_size - 1;
+    while (labels.count > mark->labels) {
+        unsigned int id = --labels.count;
+        size_t i = StrHash(labels.chars + labels.offsets[id]) & mask;
+        while (labels.slots[i] != id + 1) i = (i + 1) & mask;
+        labels.slots[i] = 0;
+        labels.chars_used = labels.offsets[id];
     }
-
-    StrDestroy(&label_instruction);
-    StrDestroy(&instruction);
-    StrDestroy(&var);
+    hoist.vars_used = mark->hoist_vars;
+    hoist.slots_used = mark->hoist_slots;
+    return true;
 }
 
-void genFnDefBegin(char *fn, DLLstr_T *params) {
+void genFnDefBegin(char *fn, atomList_T *params) {
     //zde bude zapsán celý identifikator parametru
     str_T idpar;
-    //zde budou uloženy parametry funkce
-    str_T fnpar;
-    //Inicializace řetězců
+    //Inicializace řetězce
     StrInit(&idpar);
-    StrInit(&fnpar);
 
-    genCode("LABEL", fn, NULL, NULL);
-    genCode("CREATEFRAME", NULL, NULL, NULL);
-    genCode("PUSHFRAME", NULL, NULL, NULL);
-    DLLstr_First(params);
+    genFnBlockBegin();
+    genCode(INS_LABEL, fn, NULL, NULL);
+    genCode(INS_CREATEFRAME, NULL, NULL, NULL);
+    genCode(INS_PUSHFRAME, NULL, NULL, NULL);
 
-    while(DLLstr_IsActive(params)) {
-        DLLstr_GetValue(params, &fnpar);
-        if(strcmp(StrRead(&fnpar), "_") == 0) {
+    for (size_t i = 0; i < params->used; i++) {
+        atom_T *fnpar = params->items[i];
+        if(strcmp(fnpar->text, "_") == 0) {
             // parameter s identifikátorom '_' nie je využívaný v tele funkcie
             // Hodnota argumentu na zásobníku je preto zahodená
             genCode(INS_POPS, VAR_TMP1, NULL, NULL);
         }
         else {
-            fnParamIdentificator(StrRead(&fnpar), &idpar);
-            genCode("DEFVAR", StrRead(&idpar), NULL, NULL);
-            genCode("POPS", StrRead(&idpar), NULL, NULL);
+            fnParamIdentificator(fnpar->text, &idpar);
+            genCode(INS_DEFVAR, StrRead(&idpar), NULL, NULL);
+            genCode(INS_POPS, StrRead(&idpar), NULL, NULL);
         }
-        DLLstr_Next(params);
     }
 
     StrDestroy(&idpar);
-    StrDestroy(&fnpar);
+    genCurrentBlock()->body = genCurrentBlock()->used;
+}
+
+/**
+ * @brief Náveštie začiatku tela funkcie fn za jej prológom, cieľ skoku genTailCall
+*/
+static void genFnBodyLabel(const char *fn, str_T *label) {
+    StrFillWith(label, (char *)fn);
+    StrCatString(label, "&body");
+}
+
+bool genTailCall(char *fn, atomList_T *params) {
+    codeBlock_T *block = genCurrentBlock();
+    size_t labels = 0; // náveštia medzi volaním a RETURN, cez ktoré sa k nemu iba prepadne
+    while (block->used - labels > block->body && block->ins[block->used - labels - 1].code == INS_LABEL) {
+        labels++;
+    }
+    size_t used = block->used - labels;
+    ins_T *end = block->ins + used;
+    size_t n; // počet inštrukcií od CALL po náveštia, resp. koniec bloku
+    if (used >= block->body + 3 && end[-1].code == INS_CLEARS) {
+        n = 3;
+    }
+    else if (labels == 0 && used >= block->body + 4 && end[-1].code == INS_PUSHS && end[-2].code == INS_POPS &&
+        end[-1].op[0].kind == OPD_VAR && end[-1].op[0].sub == FRAME_LF && end[-2].op[0].kind == OPD_VAR &&
+        end[-2].op[0].sub == FRAME_LF && end[-1].op[0].id == end[-2].op[0].id) {
+        n = 4; // lokálna premenná s výsledkom sa po návrate už nečíta
+    }
+    else {
+        return false;
+    }
+    ins_T *call = end - n;
+    if (call[0].code != INS_CALL || call[0].op[0].id != genLabel(fn) || call[1].code != INS_POPFRAME) {
+        return false;
+    }
+
+    ins_T *label_ins = genRealloc(NULL, (labels > 0 ? labels : 1) * sizeof(ins_T));
+    memcpy(label_ins, end, labels * sizeof(ins_T));
+    block->used = used - n;
+
+    str_T idpar;
+    StrInit(&idpar);
+    for (size_t i = 0; i < params->used; i++) { // na vrchole zásobníka je prvý argument
+        if (strcmp(params->items[i]->text, "_") == 0) {
+            genCode(INS_POPS, VAR_TMP1, NULL, NULL);
+        }
+        else {
+            fnParamIdentificator(params->items[i]->text, &idpar);
+            genCode(INS_POPS, StrRead(&idpar), NULL, NULL);
+        }
+    }
+    genFnBodyLabel(fn, &idpar);
+    genCode(INS_JUMP, StrRead(&idpar), NULL, NULL);
+    StrDestroy(&idpar);
+
+    // na náveštia sa skáče aj z iných vetiev, tie ešte RETURN potrebujú
+    genReserve(block, labels);
+    memcpy(block->ins + block->used, label_ins, labels * sizeof(ins_T));
+    block->used += labels;
+    memFree(MEM_GENERATOR, label_ins);
+
+    block->tail_calls = true;
+    return labels == 0;
+}
+
+void genHoistFnBody(codeBlock_T *block) {
+    ins_T *hoisted = genRealloc(NULL, (block->used + 1) * sizeof(ins_T));
+    size_t n = block->body;
+    memcpy(hoisted, block->ins, n * sizeof(ins_T));
+    for (size_t i = block->body; i < block->used; i++) {
+        if (block->ins[i].code == INS_DEFVAR) hoisted[n++] = block->ins[i];
+    }
+
+    str_T label;
+    StrInit(&label);
+    genFnBodyLabel(genOperandText(&block->ins[0].op[0]), &label);
+    hoisted[n].code = INS_LABEL;
+    hoisted[n].op[0] = genParseOperand(INS_LABEL, 0, StrRead(&label));
+    hoisted[n].op[1] = hoisted[n].op[2] = (operand_T){OPD_NONE, 0, 0};
+    n++;
+    StrDestroy(&label);
+
+    for (size_t i = block->body; i < block->used; i++) {
+        if (block->ins[i].code != INS_DEFVAR) hoisted[n++] = block->ins[i];
+    }
+    memFree(MEM_GENERATOR, block->ins);
+    block->ins = hoisted;
+    block->size = block->used + 1;
+    block->used = n;
+}
+
+/**
+ * @brief Premenovanie premennej alebo náveštia vkladanej funkcie
+*/
+typedef struct inline_rename {
+    operand_T from;
+    operand_T to;
+} inlineRename_T;
+
+/**
+ * @brief Nový operand pre operand vkladanej funkcie, alebo pôvodný, ak sa nepremenúva
+*/
+static operand_T genInlineRenamed(inlineRename_T *map, size_t used, operand_T op) {
+    for (size_t i = 0; i < used; i++) {
+        if (map[i].from.kind == op.kind && map[i].from.sub == op.sub && map[i].from.id == op.id) return map[i].to;
+    }
+    return op;
+}
+
+bool genInlineCall(char *fn, DLLstr_T *args, DLLstr_T *hoisted) {
+    unsigned int name = genLabel(fn);
+    if (gen_inline_limit == 0 || name >= inl.by_name_size || inl.by_name[name] == 0) return false;
+    size_t f = inl.by_name[name] - 1;
+    genCurrentBlock(); // prípadný nový blok code_fn sa vytvorí skôr, ako sa získa ukazateľ na volanú funkciu
+    codeBlock_T *callee = &code_fn.blocks[inl.fns[f].block];
+
+    // nové mená premenných a náveští, pred telom sa definujú všetky premenné
+    inlineRename_T *map = genRealloc(NULL, (callee->used + 1) * sizeof(inlineRename_T));
+    size_t used = 0;
+    str_T text;
+    StrInit(&text);
+    for (size_t i = 1; i < callee->used; i++) {
+        ins_T *ins = &(callee->ins[i]);
+        bool var = (ins->code == INS_DEFVAR && ins->op[0].sub == FRAME_LF);
+        if (!var && !(ins->code == INS_LABEL && i >= callee->body)) continue;
+        StrFillWith(&text, "");
+        if (var) {
+            const char *name = genOperandText(&ins->op[0]) + strlen("LF@");
+            char base[strlen(name) + 1]; // identifikátor bez rámca a prípony $N alebo %
+            strcpy(base, name);
+            base[strcspn(base, "$%")] = '\0';
+            genUniqVar(parser_inside_fn_def ? "LF" : "GF", base, &text);
+            if (hoisted != NULL) DLLstr_InsertLast(hoisted, StrRead(&text));
+            else genCode(INS_DEFVAR, StrRead(&text), NULL, NULL);
+            map[used].to = genParseOperand(INS_DEFVAR, 0, StrRead(&text));
+        }
+        else {
+            genUniqLabel((char *)genOperandText(&ins->op[0]), "inl", &text);
+            map[used].to = genParseOperand(INS_LABEL, 0, StrRead(&text));
+        }
+        map[used++].from = ins->op[0];
+    }
+
+    // argumenty sa priradia priamo do parametrov, v prológu v poradí inštrukcií POPS
+    DLLstr_First(args);
+    for (size_t i = 1; i < callee->body && DLLstr_IsActive(args); i++) {
+        ins_T *ins = &(callee->ins[i]);
+        if (ins->code != INS_POPS) continue;
+        if (ins->op[0].sub == FRAME_LF) {
+            DLLstr_GetValue(args, &text);
+            ins_T move = {INS_MOVE, {genInlineRenamed(map, used, ins->op[0]),
+                genParseOperand(INS_MOVE, 1, StrRead(&text)), {OPD_NONE, 0, 0}}};
+            genInsert(&move);
+        }
+        DLLstr_Next(args);
+    }
+
+    // telo, RETURN pred koncom tela sa nahradí skokom za telo
+    operand_T end = {OPD_NONE, 0, 0};
+    for (size_t i = callee->body; i < callee->used; i++) {
+        ins_T ins = callee->ins[i];
+        if (ins.code == INS_DEFVAR) continue;
+        if (ins.code == INS_RETURN) {
+            if (i == callee->used - 1) break;
+            if (end.kind == OPD_NONE) {
+                StrFillWith(&text, "");
+                genUniqLabel(fn, "inl", &text);
+                end = genParseOperand(INS_LABEL, 0, StrRead(&text));
+            }
+            ins.code = INS_JUMP;
+            ins.op[0] = end;
+        }
+        for (int o = 0; o < 3; o++) ins.op[o] = genInlineRenamed(map, used, ins.op[o]);
+        genInsert(&ins);
+    }
+    if (end.kind != OPD_NONE) {
+        ins_T label = {INS_LABEL, {end, {OPD_NONE, 0, 0}, {OPD_NONE, 0, 0}}};
+        genInsert(&label);
+    }
+
+    StrDestroy(&text);
+    memFree(MEM_GENERATOR, map);
+    inl.fns[f].sites++;
+    return true;
+}
+
+void genInlineReport() {
+    for (size_t f = 0; f < inl.fns_used; f++) {
+        if (inl.fns[f].sites == 0) continue;
+        codeBlock_T *block = &code_fn.blocks[inl.fns[f].block];
+        fprintf(stderr, "inline: %s (%zu instructions) at %zu call site%s\n", labels.chars + labels.offsets[inl.fns[f].name],
+            block->used - block->body, inl.fns[f].sites, inl.fns[f].sites == 1 ? "" : "s");
+    }
 }
 
 void genFnCall(char *fn, DLLstr_T *args) {
@@ -214,11 +892,11 @@ void genFnCall(char *fn, DLLstr_T *args) {
     //Průchod přes všechny argumenty funkce
     while (DLLstr_IsActive(args)) {
         DLLstr_GetValue(args, &arg);
-        genCode("PUSHS", StrRead(&arg), NULL, NULL);
+        genCode(INS_PUSHS, StrRead(&arg), NULL, NULL);
         DLLstr_Previous(args);
     }
     //Vložení na zásobník CALL instrukce
-    genCode("CALL", fn, NULL, NULL);
+    genCode(INS_CALL, fn, NULL, NULL);
    
     //Uvolnění řetězců
     StrDestroy(&arg);
@@ -233,7 +911,7 @@ void genWrite(DLLstr_T *args) {
     while(DLLstr_IsActive(args)) {
         DLLstr_GetValue(args, &arg);
 
-        genCode("WRITE", StrRead(&arg), NULL, NULL);
+        genCode(INS_WRITE, StrRead(&arg), NULL, NULL);
 
         DLLstr_Next(args);
     }
@@ -243,90 +921,191 @@ void genSubstring() {
     bool previous_parser_in_fn_def_value = parser_inside_fn_def;
     //Nastavení této proměnné true, aby se kód vygenerovaný genCode ukládal do code_fn
     parser_inside_fn_def = true;
-    
-    int num_of_params = 3;      //počet parametrů funkce 
-    int num_of_local_vars = 7;  //celkový počet lokálních proměnných, které se budou používat
-    int num_of_lables = 3;
-
-    //char *local_variables[] = {"?!end", "?!begin", "?!string", "?!strlen", "?!check", "?!output", "?!char"};
-    char *local_variables[] = {"?!string", "?!begin", "?!end", "?!strlen", "?!check", "?!output", "?!char"};
-    char *lables[] = {"substring", "cycle", "end"};
-    
-    str_T uniq_vars[num_of_local_vars];   //Pole lokálních proměnných
-    str_T uniq_lables[num_of_lables];
+    genFnBlockBegin();
+
+    //parametry v pořadí POPS, lokální proměnné krátké cesty a proměnné dlouhé cesty (definují se až v ní)
+    enum { STRING, BEGIN, END, STRLEN, CHECK, OUTPUT, CHAR, STOP, BLOCK, CHUNK, LIMIT, BLOCK_LIMIT, NUM_OF_VARS };
+    enum { CYCLE, LONG, PART, HEAD, BLOCKS, CHUNKS, QUAD, END_LABEL, NUM_OF_LABELS };
+    int num_of_params = 3;
+    int num_of_short_vars = 7;
+    char *local_variables[NUM_OF_VARS] = {"?!string", "?!begin", "?!end", "?!strlen", "?!check", "?!output", "?!char",
+        "?!stop", "?!block", "?!chunk", "?!limit", "?!blimit"};
+    char *lables[NUM_OF_LABELS] = {"cycle", "long", "part", "head", "blocks", "chunks", "quad", "end"};
+
+    str_T uniq_vars[NUM_OF_VARS];     //Pole lokálních proměnných
+    str_T uniq_lables[NUM_OF_LABELS];
+    char *v[NUM_OF_VARS];
+    char *l[NUM_OF_LABELS];
+    char chunk_size[32], block_size[32];
+    snprintf(chunk_size, sizeof(chunk_size), "int@%d", GEN_SUBSTRING_CHUNK);
+    snprintf(block_size, sizeof(block_size), "int@%d", GEN_SUBSTRING_BLOCK);
 
     /*Oblast inicializace a Generovaní unikátních identifikátorů*/
-    for (int i = 0; i < num_of_local_vars; i++) {
+    for (int i = 0; i < NUM_OF_VARS; i++) {
         StrInit(&uniq_vars[i]);
         genUniqVar("LF", local_variables[i], &uniq_vars[i]);
+        v[i] = StrRead(&uniq_vars[i]);
     }
-    for (int i = 0; i < num_of_lables; i++) {
+    for (int i = 0; i < NUM_OF_LABELS; i++) {
         StrInit(&uniq_lables[i]);
         genUniqLabel(lables[i], "", &uniq_lables[i]);
+        l[i] = StrRead(&uniq_lables[i]);
     }
     /*Konec inicializace a generování unikátních identifikátorů*/
 
     /*Hlavní část vygenerování kódu*/
-    genCode("LABEL", "substring", NULL, NULL);
-    genCode("CREATEFRAME", NULL, NULL, NULL);
-    genCode("PUSHFRAME", NULL, NULL, NULL);
+    genCode(INS_LABEL, "substring", NULL, NULL);
+    genCode(INS_CREATEFRAME, NULL, NULL, NULL);
+    genCode(INS_PUSHFRAME, NULL, NULL, NULL);
 
     for (int i = 0; i < num_of_params; i++) {
-        genCode("DEFVAR", StrRead(&uniq_vars[i]), NULL, NULL);    
-        genCode("POPS", StrRead(&uniq_vars[i]), NULL, NULL);
+        genCode(INS_DEFVAR, v[i], NULL, NULL);
+        genCode(INS_POPS, v[i], NULL, NULL);
     }
-    //Inicializace lokalnich promennych (neberou se v potza parametry, ty uz jsou nainicializovane)
-    for (int i = num_of_params; i < num_of_local_vars; i++) {
-        genCode("DEFVAR", StrRead(&uniq_vars[i]), NULL, NULL);
+    for (int i = num_of_params; i < num_of_short_vars; i++) {
+        genCode(INS_DEFVAR, v[i], NULL, NULL);
     }
-    //Overeni spravnosti zadanych mezi retezce
-    genCode("MOVE", StrRead(&uniq_vars[5]), "nil@nil", NULL);
-    genCode("STRLEN", StrRead(&uniq_vars[3]), StrRead(&uniq_vars[0]), NULL);
-    /*Overovani*/
-    genCode("GT", StrRead(&uniq_vars[4]), StrRead(&uniq_vars[1]), StrRead(&uniq_vars[3]));
-    genCode("EQ", StrRead(&uniq_vars[4]), StrRead(&uniq_vars[1]), StrRead(&uniq_vars[3]));
-    genCode("JUMPIFEQ", StrRead(&uniq_lables[2]), StrRead(&uniq_vars[4]), "bool@true");
+    /*Overovani: begin < 0, begin > end, end > strlen, begin == strlen => nil (end < 0 a begin > strlen z nich plyne)*/
+    genCode(INS_MOVE, v[OUTPUT], "nil@nil", NULL);
+    genCode(INS_LT, v[CHECK], v[BEGIN], "int@0");
+    genCode(INS_JUMPIFEQ, l[END_LABEL], v[CHECK], "bool@true");
+    genCode(INS_GT, v[CHECK], v[BEGIN], v[END]);
+    genCode(INS_JUMPIFEQ, l[END_LABEL], v[CHECK], "bool@true");
+    genCode(INS_STRLEN, v[STRLEN], v[STRING], NULL);
+    genCode(INS_GT, v[CHECK], v[END], v[STRLEN]);
+    genCode(INS_JUMPIFEQ, l[END_LABEL], v[CHECK], "bool@true");
+    genCode(INS_JUMPIFEQ, l[END_LABEL], v[BEGIN], v[STRLEN]);
+    /*Konec overovani*/
+    genCode(INS_MOVE, v[OUTPUT], "string@", NULL);
+    genCode(INS_JUMPIFEQ, l[END_LABEL], v[BEGIN], v[END]);
 
-    genCode("GT", StrRead(&uniq_vars[4]), StrRead(&uniq_vars[2]), StrRead(&uniq_vars[3]));
-    genCode("JUMPIFEQ", StrRead(&uniq_lables[2]), StrRead(&uniq_vars[4]), "bool@true");
+    //Krátký výřez po jednom znaku
+    genCode(INS_SUB, v[CHAR], v[END], v[BEGIN]);
+    genCode(INS_LT, v[CHECK], v[CHAR], chunk_size);
+    genCode(INS_JUMPIFNEQ, l[LONG], v[CHECK], "bool@true");
+    genCode(INS_LABEL, l[CYCLE], NULL, NULL);
+    genCode(INS_GETCHAR, v[CHAR], v[STRING], v[BEGIN]);
+    genCode(INS_CONCAT, v[OUTPUT], v[OUTPUT], v[CHAR]);
+    genCode(INS_ADD, v[BEGIN], v[BEGIN], "int@1");
+    genCode(INS_JUMPIFNEQ, l[CYCLE], v[BEGIN], v[END]);
+    genCode(INS_JUMP, l[END_LABEL], NULL, NULL);
 
-    genCode("LT", StrRead(&uniq_vars[4]), StrRead(&uniq_vars[1]), "int@0");
-    genCode("JUMPIFEQ", StrRead(&uniq_lables[2]), StrRead(&uniq_vars[4]), "bool@true");
+    /*Dlouhý výřez: celý řetězec se nekopíruje, jinak se znaky skládají do úseků a úseky do bloků,
+      výsledek tak není kopírován po každém znaku*/
+    genCode(INS_LABEL, l[LONG], NULL, NULL);
+    genCode(INS_JUMPIFNEQ, l[PART], v[BEGIN], "int@0");
+    genCode(INS_JUMPIFNEQ, l[PART], v[END], v[STRLEN]);
+    genCode(INS_MOVE, v[OUTPUT], v[STRING], NULL);
+    genCode(INS_JUMP, l[END_LABEL], NULL, NULL);
+    genCode(INS_LABEL, l[PART], NULL, NULL);
+    for (int i = num_of_short_vars; i < NUM_OF_VARS; i++) {
+        genCode(INS_DEFVAR, v[i], NULL, NULL);
+    }
+    //Zbytek délky po dělení 4 se zpracuje po jednom znaku, zbytek výřezu po čtyřech
+    genCode(INS_IDIV, v[STOP], v[CHAR], "int@4");
+    genCode(INS_MUL, v[STOP], v[STOP], "int@4");
+    genCode(INS_SUB, v[STOP], v[CHAR], v[STOP]);
+    genCode(INS_ADD, v[STOP], v[STOP], v[BEGIN]);
+    genCode(INS_JUMPIFEQ, l[BLOCKS], v[BEGIN], v[STOP]);
+    genCode(INS_LABEL, l[HEAD], NULL, NULL);
+    genCode(INS_GETCHAR, v[CHAR], v[STRING], v[BEGIN]);
+    genCode(INS_CONCAT, v[OUTPUT], v[OUTPUT], v[CHAR]);
+    genCode(INS_ADD, v[BEGIN], v[BEGIN], "int@1");
+    genCode(INS_JUMPIFNEQ, l[HEAD], v[BEGIN], v[STOP]);
 
-    genCode("LT", StrRead(&uniq_vars[4]), StrRead(&uniq_vars[2]), "int@0");
-    genCode("JUMPIFEQ", StrRead(&uniq_lables[2]), StrRead(&uniq_vars[4]), "bool@true");
+    //Blok nejvýše GEN_SUBSTRING_BLOCK znaků
+    genCode(INS_LABEL, l[BLOCKS], NULL, NULL);
+    genCode(INS_MOVE, v[BLOCK], "string@", NULL);
+    genCode(INS_ADD, v[BLOCK_LIMIT], v[BEGIN], block_size);
+    genCode(INS_GT, v[CHECK], v[BLOCK_LIMIT], v[END]);
+    genCode(INS_JUMPIFNEQ, l[CHUNKS], v[CHECK], "bool@true");
+    genCode(INS_MOVE, v[BLOCK_LIMIT], v[END], NULL);
+    //Úsek nejvýše GEN_SUBSTRING_CHUNK znaků
+    genCode(INS_LABEL, l[CHUNKS], NULL, NULL);
+    genCode(INS_MOVE, v[CHUNK], "string@", NULL);
+    genCode(INS_ADD, v[LIMIT], v[BEGIN], chunk_size);
+    genCode(INS_GT, v[CHECK], v[LIMIT], v[BLOCK_LIMIT]);
+    genCode(INS_JUMPIFNEQ, l[QUAD], v[CHECK], "bool@true");
+    genCode(INS_MOVE, v[LIMIT], v[BLOCK_LIMIT], NULL);
+    genCode(INS_LABEL, l[QUAD], NULL, NULL);
+    for (int i = 0; i < 4; i++) {
+        genCode(INS_GETCHAR, v[CHAR], v[STRING], v[BEGIN]);
+        genCode(INS_CONCAT, v[CHUNK], v[CHUNK], v[CHAR]);
+        genCode(INS_ADD, v[BEGIN], v[BEGIN], "int@1");
+    }
+    genCode(INS_JUMPIFNEQ, l[QUAD], v[BEGIN], v[LIMIT]);
+    genCode(INS_CONCAT, v[BLOCK], v[BLOCK], v[CHUNK]);
+    genCode(INS_JUMPIFNEQ, l[CHUNKS], v[BEGIN], v[BLOCK_LIMIT]);
+    genCode(INS_CONCAT, v[OUTPUT], v[OUTPUT], v[BLOCK]);
+    genCode(INS_JUMPIFNEQ, l[BLOCKS], v[BEGIN], v[END]);
 
-    genCode("GT", StrRead(&uniq_vars[4]), StrRead(&uniq_vars[1]), StrRead(&uniq_vars[2]));
-    genCode("JUMPIFEQ", StrRead(&uniq_lables[2]), StrRead(&uniq_vars[4]), "bool@true");
-    /*Konec overovani*/
-    //Inicializace vystupni promenne
-    genCode("MOVE", StrRead(&uniq_vars[5]), "string@", NULL);
-    //Jsou indexy stejne?
-    genCode("EQ", StrRead(&uniq_vars[4]), StrRead(&uniq_vars[1]), StrRead(&uniq_vars[2]));
-    genCode("JUMPIFEQ", StrRead(&uniq_lables[2]), StrRead(&uniq_vars[4]), "bool@true");
-
-    /*Hlavni cyklus*/
-    genCode("LABEL", StrRead(&uniq_lables[1]), NULL, NULL);
-    genCode("GETCHAR", StrRead(&uniq_vars[3]), StrRead(&uniq_vars[0]), StrRead(&uniq_vars[1]));
-    genCode("CONCAT", StrRead(&uniq_vars[5]), StrRead(&uniq_vars[5]), StrRead(&uniq_vars[3]));
-    genCode("ADD", StrRead(&uniq_vars[1]), StrRead(&uniq_vars[1]), "int@1");
-    genCode("JUMPIFNEQ", StrRead(&uniq_lables[1]), StrRead(&uniq_vars[1]), StrRead(&uniq_vars[2]));
-    /*Konec hlavniho cyklu*/
-    genCode("LABEL", StrRead(&uniq_lables[2]), NULL, NULL);
-    genCode("PUSHS", StrRead(&uniq_vars[5]), NULL, NULL);
-
-    genCode("RETURN", NULL, NULL, NULL);
+    genCode(INS_LABEL, l[END_LABEL], NULL, NULL);
+    genCode(INS_PUSHS, v[OUTPUT], NULL, NULL);
+
+    genCode(INS_RETURN, NULL, NULL, NULL);
+    genFnDefEnd();
     parser_inside_fn_def = previous_parser_in_fn_def_value;
 
     /* dealokácia pomocných str_T */
-    for (int i = 0; i < num_of_local_vars; i++) {
+    for (int i = 0; i < NUM_OF_VARS; i++) {
         StrDestroy(&uniq_vars[i]);
     }
-    for (int i = 0; i < num_of_lables; i++) {
+    for (int i = 0; i < NUM_OF_LABELS; i++) {
         StrDestroy(&uniq_lables[i]);
     }
 }
 
+bool genSubstringInline(DLLstr_T *args) {
+    str_T label, arg[3];
+    StrInit(&label);
+    size_t argc = 0;
+    for (DLLstr_First(args); DLLstr_IsActive(args) && argc < 3; DLLstr_Next(args)) {
+        StrInit(&arg[argc]);
+        DLLstr_GetValue(args, &arg[argc++]);
+    }
+    bool inlined = false;
+    if (argc == 3 && !DLLstr_IsActive(args) &&
+        strncmp(StrRead(&arg[1]), "int@", 4) == 0 && strncmp(StrRead(&arg[2]), "int@", 4) == 0) {
+        char *string = StrRead(&arg[0]);
+        long long begin = strtoll(StrRead(&arg[1]) + 4, NULL, 10);
+        long long end = strtoll(StrRead(&arg[2]) + 4, NULL, 10);
+        if (begin < 0 || end < 0 || begin > end) {
+            // nil bez ohľadu na reťazec
+            genCode(INS_PUSHS, "nil@nil", NULL, NULL);
+            inlined = true;
+        }
+        else if (end - begin <= GEN_SUBSTRING_INLINE_MAX) {
+            genUniqLabel("substring", "inl", &label);
+            genCode(INS_STRLEN, VAR_TMP1, string, NULL);
+            genCode(INS_MOVE, VAR_TMP2, "nil@nil", NULL);
+            if (begin == end) {
+                // prázdny výrez, ak begin < strlen
+                genCode(INS_GT, VAR_COND, VAR_TMP1, StrRead(&arg[1]));
+                genCode(INS_JUMPIFNEQ, StrRead(&label), VAR_COND, "bool@true");
+                genCode(INS_MOVE, VAR_TMP2, "string@", NULL);
+            }
+            else {
+                // end <= strlen, z toho aj begin < strlen
+                genCode(INS_LT, VAR_COND, VAR_TMP1, StrRead(&arg[2]));
+                genCode(INS_JUMPIFEQ, StrRead(&label), VAR_COND, "bool@true");
+                genCode(INS_GETCHAR, VAR_TMP2, string, StrRead(&arg[1]));
+                for (long long i = begin + 1; i < end; i++) {
+                    char index[32];
+                    snprintf(index, sizeof(index), "int@%lld", i);
+                    genCode(INS_GETCHAR, VAR_TMP3, string, index);
+                    genCode(INS_CONCAT, VAR_TMP2, VAR_TMP2, VAR_TMP3);
+                }
+            }
+            genCode(INS_LABEL, StrRead(&label), NULL, NULL);
+            genCode(INS_PUSHS, VAR_TMP2, NULL, NULL);
+            inlined = true;
+        }
+    }
+    for (size_t i = 0; i < argc; i++) StrDestroy(&arg[i]);
+    StrDestroy(&label);
+    return inlined;
+}
+
 /**
  *  Pomocná funkce, která vytvoří řetězec identifikátoru parametru funkce a uloží jej do "id"
 */
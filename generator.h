@@ -14,51 +14,200 @@
 
 #define BOOL_CONST -50  ///< Konštanta - true/false ... Musí byť rôzna od hodnôt token_ids.
 
-// Inštrukcie zapísané ako konštanty, aby sa predišlo chýbam v zápise inštrkucií
-#define INS_MOVE            "MOVE"
-#define INS_CREATEFRAME     "CREATEFRAME"
-#define INS_PUSHFRAME       "PUSHFRAME"
-#define INS_POPFRAME        "POPFRAME"
-#define INS_DEFVAR          "DEFVAR"
-#define INS_CALL            "CALL"
-#define INS_RETURN          "RETURN"
-#define INS_PUSHS           "PUSHS"
-#define INS_POPS            "POPS"
-#define INS_CLEARS          "CLEARS"
-#define INS_ADDS            "ADDS"
-#define INS_SUBS            "SUBS"
-#define INS_MULS            "MULS"
-#define INS_DIVS            "DIVS"
-#define INS_IDIVS           "IDIVS"
-#define INS_LTS             "LTS"
-#define INS_GTS             "GTS"
-#define INS_EQS             "EQS"
-#define INS_NOTS            "NOTS"
-#define INS_INT2FLOATS      "INT2FLOATS"
-#define INS_FLOAT2INTS      "FLOAT2INTS"
-#define INS_READ            "READ"
-#define INS_WRITE           "WRITE"
-#define INS_CONCAT          "CONCAT"
-#define INS_STRLEN          "STRLEN"
-#define INS_LABEL           "LABEL"
-#define INS_JUMP            "JUMP"
-#define INS_JUMPIFEQS       "JUMPIFEQS"
-#define INS_EXIT            "EXIT"
+/**
+ * @brief Operačné kódy inštrukcií IFJcode23
+ * @details Inštrukcie sú zapísané ako konštanty, aby sa predišlo chýbam v zápise inštrukcií.
+ * Textový názov inštrukcie sa použije až pri výpise kódu.
+*/
+typedef enum ins_codes {
+    INS_MOVE,
+    INS_CREATEFRAME,
+    INS_PUSHFRAME,
+    INS_POPFRAME,
+    INS_DEFVAR,
+    INS_CALL,
+    INS_RETURN,
+    INS_PUSHS,
+    INS_POPS,
+    INS_CLEARS,
+    INS_ADD,
+    INS_SUB,
+    INS_MUL,
+    INS_DIV,
+    INS_IDIV,
+    INS_ADDS,
+    INS_SUBS,
+    INS_MULS,
+    INS_DIVS,
+    INS_IDIVS,
+    INS_LT,
+    INS_GT,
+    INS_EQ,
+    INS_LTS,
+    INS_GTS,
+    INS_EQS,
+    INS_AND,
+    INS_OR,
+    INS_NOT,
+    INS_ANDS,
+    INS_ORS,
+    INS_NOTS,
+    INS_INT2FLOAT,
+    INS_FLOAT2INT,
+    INS_INT2CHAR,
+    INS_STRI2INT,
+    INS_INT2FLOATS,
+    INS_FLOAT2INTS,
+    INS_INT2CHARS,
+    INS_STRI2INTS,
+    INS_READ,
+    INS_WRITE,
+    INS_CONCAT,
+    INS_STRLEN,
+    INS_GETCHAR,
+    INS_SETCHAR,
+    INS_TYPE,
+    INS_LABEL,
+    INS_JUMP,
+    INS_JUMPIFEQ,
+    INS_JUMPIFNEQ,
+    INS_JUMPIFEQS,
+    INS_JUMPIFNEQS,
+    INS_EXIT,
+    INS_BREAK,
+    INS_DPRINT,
+    INS_HOIST,      ///< pseudo-inštrukcia, miesto pre definície premenných cyklu (genLoopHoistSlot)
+    INS_COUNT       ///< počet inštrukcií, nie je inštrukcia
+} ins_code_T;
+
+/**
+ * @brief Druh operandu inštrukcie
+*/
+enum operand_kinds {
+    OPD_NONE,   ///< operand nie je použitý
+    OPD_VAR,    ///< premenná, sub určuje rámec
+    OPD_CONST,  ///< konštanta, sub určuje jej typ
+    OPD_LABEL,  ///< náveštie
+    OPD_TYPE,   ///< názov typu (operand inštrukcie READ)
+    OPD_TEXT    ///< operand bez rozpoznaného prefixu, vypíše sa doslovne
+};
+
+/**
+ * @brief Rámce premenných
+*/
+enum frames { FRAME_GF, FRAME_LF, FRAME_TF };
+
+/**
+ * @brief Typy konštánt v cieľovom kóde
+*/
+enum const_kinds { CONST_INT, CONST_FLOAT, CONST_STRING, CONST_BOOL, CONST_NIL };
+
+/**
+ * @brief Operand inštrukcie
+ * @details Premenná, konštanta, typ a doslovný operand sú atómy s celým textom operandu (napr. "GF@x$1",
+ * "int@5"), operand obsahuje iba atom->id. Náveštia sú v tabuľke náveští generátora, ktorú možno po odložení
+ * kódu zmenšiť (genRelease). Dva operandy sú zhodné práve vtedy, keď sa zhodujú vo všetkých troch položkách.
+*/
+typedef struct operand {
+    unsigned char kind; ///< druh operandu, operand_kinds
+    unsigned char sub;  ///< rámec premennej (frames) alebo typ konštanty (const_kinds)
+    unsigned int id;    ///< atom->id, pri náveští index v tabuľke náveští, viď. genOperandText
+} operand_T;
+
+/**
+ * @brief Inštrukcia cieľového kódu
+*/
+typedef struct instruction {
+    unsigned char code; ///< operačný kód, ins_code_T
+    operand_T op[3];    ///< operandy, nepoužité majú druh OPD_NONE
+} ins_T;
+
+/**
+ * @brief Súvislé pole inštrukcií jednej funkcie alebo hlavného tela programu
+*/
+typedef struct code_block {
+    ins_T *ins;     ///< inštrukcie
+    size_t used;    ///< počet inštrukcií
+    size_t size;    ///< alokovaná kapacita poľa
+    size_t hoists;  ///< počet pseudo-inštrukcií INS_HOIST v bloku
+    size_t body;    ///< blok funkcie: index prvej inštrukcie tela za prológom (genFnDefBegin)
+    bool tail_calls;///< blok funkcie: rekurzívne volanie bolo nahradené skokom (genTailCall)
+} codeBlock_T;
+
+/**
+ * @brief Kód všetkých funkcií, každá funkcia má vlastný blok v poradí definícií
+*/
+typedef struct code_fn_list {
+    codeBlock_T *blocks;    ///< bloky funkcií
+    size_t used;            ///< počet blokov
+    size_t size;            ///< alokovaná kapacita poľa
+} codeFnList_T;
 
 // Pomocné globálne premenné
+#define VAR_TMP_PREFIX "GF@!tmp"    ///< spoločný začiatok mien všetkých pomocných premenných
 #define VAR_TMP1 "GF@!tmp1"
 #define VAR_TMP2 "GF@!tmp2"
 #define VAR_TMP3 "GF@!tmp3"
+#define VAR_COND "GF@!cond" ///< výsledok porovnania pred podmieneným skokom
 
 /**
  * @brief Vygenerovaný kód pre funkcie
 */
-extern DLLstr_T code_fn;
+extern codeFnList_T code_fn;
 
 /**
  * @brief Vygenerovaný kód pre hlavný program (všetko mimo funkcií)
 */
-extern DLLstr_T code_main;
+extern codeBlock_T code_main;
+
+/**
+ * @brief Inicializuje bloky kódu a tabuľku náveští generátora
+*/
+void genInit();
+
+/**
+ * @brief Uvoľní všetok vygenerovaný kód a tabuľku náveští generátora
+*/
+void genDestroy();
+
+/**
+ * @brief Vráti index náveštia v tabuľke náveští generátora, nové náveštie sa do tabuľky pridá
+ * @return index, rovnaké náveštia majú vždy rovnaký index
+*/
+unsigned int genLabel(const char *text);
+
+/**
+ * @brief Text operandu v tvare cieľového kódu, napr. "GF@x$1" alebo náveštie
+*/
+const char *genOperandText(operand_T *op);
+
+/**
+ * @brief Prevedie zdrojový operand v textovom tvare cieľového kódu na typovaný operand
+ * @param text napr. "GF@!tmp1" alebo "bool@false"
+*/
+operand_T genOperand(char *text);
+
+/**
+ * @brief Vloží inštrukciu na koniec aktuálneho bloku kódu (viď. genCode)
+*/
+void genInsert(ins_T *ins);
+
+/**
+ * @brief Zapíše textový tvar inštrukcie (bez konca riadku) na koniec reťazca out
+*/
+void genRenderIns(ins_T *ins, str_T *out);
+
+/**
+ * @brief Textový názov inštrukcie s operačným kódom code, napr. "MOVE"
+*/
+const char *genInsName(ins_code_T code);
+
+/**
+ * Text sa skladá priamo z atómov a tabuľky náveští do vyrovnávacích pamätí emit.h, bez pomocného reťazca.
+ *
+ * @brief Vypíše inštrukcie bloku kódu cez emit.h, každú na samostatný riadok
+*/
+void genPrintBlock(codeBlock_T *block);
 
 /**
  * Vygenerovaný identifikátor bude v tvare "<scope>@<id>$<cislo>", kde
@@ -100,6 +249,16 @@ void genUniqVar(char *scope, char *sub, str_T *id);
 */
 void genUniqLabel(char *fn, char *sub, str_T *label);
 
+/**
+ * @brief Počet premenných vytvorených funkciou genUniqVar
+*/
+int genUniqVarCount();
+
+/**
+ * @brief Počet náveští vytvorených funkciou genUniqLabel
+*/
+int genUniqLabelCount();
+
 /**
  * V prípade reťazca treba reťazec prispoôsobiť požiadavkam cieľového kódu pomocou funkcie decode.
  *      
@@ -119,31 +278,75 @@ void genUniqLabel(char *fn, char *sub, str_T *label);
 void genConstVal(int const_type, char *value, str_T *cval);
 
 /**
- * Vygenerovaný kód bude vložený na koniec zoznamu code_fn pokiaľ parser_inside_fn_def==true
- * (globálna premenná v parser.h), inak na koniec code_main.
+ * Vygenerovaný kód bude vložený na koniec bloku práve definovanej funkcie v code_fn
+ * pokiaľ parser_inside_fn_def==true (globálna premenná v parser.h), inak na koniec code_main.
+ * Operandy v textovom tvare sú prevedené na typované operandy (operand_T).
  * 
  * Príklady:
- *      genCode("ADD", "GF@x", "GF@y", "LF@z") vygeneruje "ADD GF@x GF@y LF@z"
- *      genCode("PUSHFRAME", NULL, NULL, NULL) vygeneruje "PUSHFRAME"
+ *      genCode(INS_ADD, "GF@x", "GF@y", "LF@z") vygeneruje "ADD GF@x GF@y LF@z"
+ *      genCode(INS_PUSHFRAME, NULL, NULL, NULL) vygeneruje "PUSHFRAME"
  * 
- * @brief Vygeneruje a vloží kód s danými argumentami do zoznamu s vygenerovanými inštrukciami. 
- * @param instruction Názov inštrukcie
+ * @brief Vygeneruje a vloží kód s danými argumentami do bloku s vygenerovanými inštrukciami. 
+ * @param instruction Operačný kód inštrukcie
  * @param op1 Prvý operand. Ak sa rovná NULL, je ignorovaný.
  * @param op2 Druhý operand. Ak sa rovná NULL, je ignorovaný.
  * @param op3 Tretí operand. Ak sa rovná NULL, je ignorovaný.
 */
-void genCode(char *instruction, char *op1, char *op2, char *op3);
+void genCode(ins_code_T instruction, char *op1, char *op2, char *op3);
 
 /**
- * Funkcia pracuje so zoznamom code_fn pokiaľ parser_inside_fn_def==true
- * (globálna premenná v parser.h), inak s code_main.
+ * Druh operandu (rámec premennej, typ konštanty) určuje druh atómu, text operandov sa preto nerozoberá
+ * ani znova nerozptyľuje. Náveštie na mieste prvého operandu skokov sa vyhľadá podľa atom->hash.
+ *
+ * Príklad:
+ *      genCodeAtoms(INS_PUSHS, variable->codename, NULL, NULL)
+ *
+ * @brief genCode s operandami, ktoré volajúci už má ako atómy (kódové mená z tabuľky symbolov a výrazov)
+*/
+void genCodeAtoms(ins_code_T instruction, atom_T *op1, atom_T *op2, atom_T *op3);
+
+/**
+ * Ak je posledná vygenerovaná inštrukcia PUSHS int@N, prepíše sa na PUSHS float@N,
+ * inak sa vygeneruje INT2FLOATS.
+ *
+ * @brief Vygeneruje konverziu hodnoty na vrchole zásobníka z Int na Double
+*/
+void genInt2FloatS();
+
+/**
+ * Medzivýsledok na pozícii slot je vždy v tej istej premennej, výrazy neobsahujú volania funkcií,
+ * preto stačia globálne premenné. Vytvoria sa iba tie, ktoré boli počas prekladu použité.
+ *
+ * @brief Vráti pomocnú premennú GF@!tmpN pre medzivýsledok trojadresného kódu výrazu
+ * @param slot pozícia medzivýsledku na zásobníku operandov výrazu, od 0
+*/
+atom_T *genExpTemp(int slot);
+
+/**
+ * @brief Počet pomocných premenných vrátených genExpTemp, t.j. GF@!tmp4 až GF@!tmp(3 + počet)
+*/
+int genExpTempCount();
+
+/**
+ * Do aktuálneho bloku vloží pseudo-inštrukciu INS_HOIST, ktorá si pamätá miesto pred
+ * náveštím cyklu. Definície premenných z tela cyklu sa na toto miesto doplnia neskôr
+ * funkciou genDefVarsBeforeLoop bez prehľadávania a posúvania už vygenerovaného kódu.
  * 
- * Vygenerované inštrukcie definícií premenných budú vložené pred náveštie zadané náveštie,
- * resp. pred inštrukciu "LABEL <label>".
+ * @brief Zaznamená miesto pre definície premenných pred najvrchnejším cyklom
+ * @return identifikátor miesta pre genDefVarsBeforeLoop
+*/
+size_t genLoopHoistSlot();
+
+/**
+ * Definície sa uložia k miestu zaznamenanému funkciou genLoopHoistSlot, do bloku sa
+ * rozvinú až pri ukončení funkcie (genFnDefEnd) alebo pri výpise (genPrintBlock).
  * 
  * Príklad:
- *      genDefVarsBeforeLoop("&while25", {"LF@x$1", "LF@y$2"}),
- *      budú vygenerované dve inštrukcie:
+ *      slot = genLoopHoistSlot(),
+ *      LABEL &while25
+ *      ...
+ *      genDefVarsBeforeLoop(slot, {"LF@x$1", "LF@y$2"}),
+ *      výsledný kód:
  * 
  *      ...
  *      DEFVAR LF@x$1
@@ -151,14 +354,66 @@ void genCode(char *instruction, char *op1, char *op2, char *op3);
  *      LABEL &while25 # nie je už generované funkciou genDefVarsBeforeLoop
  *      ...
  * 
- * @brief Vygeneruje kód pre deklaráciu premenných pred zadaný cyklus.
- * @param label Názov náveštia cyklu.
+ * @brief Vygeneruje kód pre deklaráciu premenných pred zadaný cyklus v konštantnom čase.
+ * @param slot Miesto pred náveštím cyklu, viď. genLoopHoistSlot.
  * @param variables Zoznam identifikátorov premenných, ktoré treba definovať pred cyklom.
 */
-void genDefVarsBeforeLoop(char *label, DLLstr_T *variables);
+void genDefVarsBeforeLoop(size_t slot, DLLstr_T *variables);
+
+/**
+ * @brief Nahradí všetky pseudo-inštrukcie INS_HOIST bloku zaznamenanými definíciami premenných
+ * @details Blok sa prejde iba raz, celková zložitosť je lineárna vzhľadom na veľkosť bloku.
+*/
+void genExpandHoists(codeBlock_T *block);
+
+/**
+ * @brief Značka pre genCodeCut, t.j. počet inštrukcií v aktuálnom bloku
+*/
+size_t genCodeMark();
+
+/**
+ * Spolu s genCodePaste umožňuje vygenerovať časť kódu skôr, ako je na rade jej miesto
+ * v cieľovom kóde (napr. podmienka cyklu, ktorá sa testuje až za jeho telom).
+ *
+ * @brief Presunie inštrukcie od značky mark po koniec aktuálneho bloku do bloku out
+ * @param out prázdny blok, inicializovaný ako (codeBlock_T){NULL, 0, 0, 0, 0, false}
+*/
+void genCodeCut(size_t mark, codeBlock_T *out);
+
+/**
+ * @brief Pripojí inštrukcie vybrané funkciou genCodeCut na koniec aktuálneho bloku a blok saved uvoľní
+*/
+void genCodePaste(codeBlock_T *saved);
+
+/**
+ * @brief Stav tabuľky náveští a miest pre definície pred cyklami, viď. genRelease
+*/
+typedef struct gen_mark {
+    unsigned int labels;    ///< počet náveští
+    size_t hoist_vars;      ///< počet zaznamenaných definícií premenných
+    size_t hoist_slots;     ///< počet miest pred cyklami
+    size_t fn_blocks;       ///< počet blokov v code_fn
+} genMark_T;
+
+/**
+ * @brief Zaznamená aktuálny stav tabuľky náveští pre neskoršie genRelease
+*/
+void genMark(genMark_T *mark);
+
+/**
+ * Náveštia a miesta pred cyklami pridané po značke mark môže používať iba kód, ktorý už bol vypísaný
+ * (viď. streamMainBody), pokiaľ medzitým nevznikla žiadna funkcia, jej kód zostáva v pamäti.
+ * Počítadlo genUniqLabel sa nevracia, nové náveštia sa preto s uvoľnenými nestretnú. Premenné a konštanty
+ * sú atómy, tie sa neuvoľňujú (ich kódové mená drží aj tabuľka symbolov a výrazy).
+ *
+ * @brief Zahodí náveštia a miesta pred cyklami pridané po značke mark
+ * @return false ak bola po značke definovaná funkcia a nič sa neuvoľnilo
+*/
+bool genRelease(genMark_T *mark);
 
 /**
- * Vygenerovaný kód bude vložený na koniec zoznamu code_fn.
+ * Vygenerovaný kód bude vložený do nového bloku v code_fn, ktorý sa stane aktuálnym
+ * až do zavolania genFnDefEnd.
  * 
  * Vygenerovaný kód:    náveštie na funkciu, vytvorí nový rámec, vloží ho do zásobníka,
  *                      definuje v novom rámci premenné parametrov funkcie,
@@ -184,10 +439,70 @@ void genDefVarsBeforeLoop(char *label, DLLstr_T *variables);
  * @param fn Názov funkcie
  * @param params Identifikátory parametrov funkcie
 */
-void genFnDefBegin(char *fn, DLLstr_T *params);
+void genFnDefBegin(char *fn, atomList_T *params);
+
+/**
+ * @brief Ukončí generovanie kódu funkcie, aktuálnym sa stane blok obklopujúcej funkcie
+*/
+void genFnDefEnd();
+
+/**
+ * Rozpozná na konci aktuálneho bloku volanie funkcie fn samej seba, ktorého výsledok sa hneď vracia:
+ *      CALL fn, POPFRAME, CLEARS                   (príkaz fn(...) pred return vo void funkcii)
+ *      CALL fn, POPFRAME, POPS LF@x, PUSHS LF@x    (let x = fn(...) pred return x)
+ * Argumenty sú už na zásobníku, volanie sa preto nahradí ich priradením do parametrov
+ * a skokom na začiatok tela funkcie, rámec sa nevytvára a RETURN sa negeneruje:
+ *      POPS    LF@a%
+ *      POPS    LF@b%
+ *      JUMP    <fn&body>
+ * Medzi volaním void funkcie a RETURN môžu byť náveštia (koniec vetvy if), tie ostanú za skokom.
+ * Definície lokálnych premenných funkcie sa potom pri genFnDefEnd presunú pred telo (genHoistFnBody).
+ *
+ * @brief Nahradí rekurzívne volanie v koncovej pozícii skokom, volá sa namiesto generovania RETURN
+ * @param fn Názov aktuálne definovanej funkcie
+ * @param params Identifikátory parametrov funkcie
+ * @return true, ak bolo volanie nahradené a RETURN už netreba generovať (za skokom nie je náveštie)
+*/
+bool genTailCall(char *fn, atomList_T *params);
+
+/**
+ * @brief Presunie všetky DEFVAR tela funkcie pred jej telo a za ne vloží náveštie <fn&body>
+ * @details Skok genTailCall tak nedefinuje premenné rámca opakovane.
+*/
+void genHoistFnBody(codeBlock_T *block);
+
+/**
+ * @brief Najväčší počet inštrukcií tela funkcie, ktorú genInlineCall vloží do miesta volania, 0 vypína vkladanie
+*/
+extern size_t gen_inline_limit;
 
 /**
- * Vygenerovaný kód bude vložený na koniec zoznamu code_fn pokiaľ parser_inside_fn_def==true
+ * Vkladajú sa iba funkcie zaznamenané pri genFnDefEnd: telo má najviac gen_inline_limit inštrukcií,
+ * funkcia nevolá samu seba a nemá volania nahradené skokom (genTailCall).
+ * Parametre a lokálne premenné dostanú nové mená (genUniqVar), náveštia tela nové náveštia (genUniqLabel).
+ * Príklad pre func dec(_ n: Int) -> Int { return n - 1 } a volanie dec(x) v hlavnom tele:
+ *      DEFVAR  GF@n$7
+ *      MOVE    GF@n$7 GF@x$1
+ *      PUSHS   GF@n$7
+ *      PUSHS   int@1
+ *      SUBS
+ * Návratová hodnota ostane na zásobníku rovnako ako po CALL, RETURN uprostred tela sa nahradí skokom za telo.
+ *
+ * @brief Vloží telo malej funkcie namiesto jej volania
+ * @param fn Názov volanej funkcie
+ * @param args Predávané argumenty (termy)
+ * @param hoisted Zoznam, do ktorého sa pridajú nové premenné, ak sa nesmú definovať v mieste volania (cyklus), inak NULL
+ * @return true, ak bola funkcia vložená, inak treba vygenerovať genFnCall
+*/
+bool genInlineCall(char *fn, DLLstr_T *args, DLLstr_T *hoisted);
+
+/**
+ * @brief Vypíše na stderr, ktoré funkcie boli vložené do miesta volania a koľkokrát
+*/
+void genInlineReport();
+
+/**
+ * Vygenerovaný kód bude vložený na koniec aktuálneho bloku code_fn pokiaľ parser_inside_fn_def==true
  * (globálna premenná v parser.h), inak na koniec code_main.
  * 
  * Vygenerovaný kód:    vloží do zásobníka argumenty (prvý argument bude na vrchole, posledný na dne)
@@ -198,8 +513,8 @@ void genFnDefBegin(char *fn, DLLstr_T *params);
  *      vygeneruje kód:
  * 
  *      ...
- *      PUSH    LF@x$1
- *      PUSH    int@6
+ *      PUSHS   LF@x$1
+ *      PUSHS   int@6
  *      CALL sum
  * 
  * @brief Vygeneruje kód volania funkcie.
@@ -210,7 +525,7 @@ void genFnDefBegin(char *fn, DLLstr_T *params);
 void genFnCall(char *fn, DLLstr_T *args);
 
 /**
- * Vygenerovaný kód bude vložený na koniec zoznamu code_fn pokiaľ parser_inside_fn_def==true
+ * Vygenerovaný kód bude vložený na koniec aktuálneho bloku code_fn pokiaľ parser_inside_fn_def==true
  * (globálna premenná v parser.h), inak na koniec code_main.
  * 
  * Argumenty funkce se budou zpracovávat z leva doprava. Jako kod se vygeneruje sekvence WRITE prikazu s argumenty v args
@@ -228,67 +543,52 @@ void genFnCall(char *fn, DLLstr_T *args);
  */
 void genWrite(DLLstr_T *args);
 
+#define GEN_SUBSTRING_CHUNK 64          ///< délka úseku, po kterém funkce substring připojuje znaky k bloku, násobek 4
+#define GEN_SUBSTRING_BLOCK 4096        ///< délka bloku, po kterém funkce substring připojuje úseky k výsledku
+#define GEN_SUBSTRING_INLINE_MAX 8      ///< nejdelší výřez s konstantními mezemi, který genSubstringInline vloží do místa volání
+
 /**
- * Vygenerovaný kód bude vložený na koniec zoznamu code_fn.
- * 
- * Vygeneruje se následující kód:
- *      LABEL substring
-        CREATEFRAME
-        PUSHFRAME
-
-        DEFVAR LF@?!end$1
-        POPS LF@?!end$1
-        DEFVAR LF@?!begin$2
-        POPS LF@?!begin$2
-        DEFVAR LF@?!string$3
-        POPS LF@?!string$3
-
-        DEFVAR LF@?!strlen$4
-        DEFVAR LF@?!check$5
-        DEFVAR LF@?!output$6
-        DEFVAR LF@?!char$7
-
-        MOVE LF@?!output$6 nil@nil
-        STRLEN LF@?!strlen$4 LF@?!string$3
-
-        GT LF@?!check$5 LF@?!begin$2 LF@?!strlen$4
-        EQ LF@?!check$5 LF@?!begin$2 LF@?!strlen$4
-        JUMPIFEQ end&3 LF@?!check$5 bool@true
-
-        GT LF@?!check$5 LF@?!end$1 LF@?!strlen$4
-        JUMPIFEQ end&3 LF@?!check$5 bool@true
-
-        LT LF@?!check$5 LF@?!begin$2 int@0
-        JUMPIFEQ end&3 LF@?!check$5 bool@true
-
-        LT LF@?!check$5 LF@?!end$1 int@0
-        JUMPIFEQ end&3 LF@?!check$5 bool@true
-
-        GT LF@?!check$5 LF@?!begin$2 LF@?!end$1
-        JUMPIFEQ end&3 LF@?!check$5 bool@true
-
-        MOVE LF@?!output$6 string@
-        EQ LF@?!check$5 LF@?!begin$2 LF@?!end$1
-        JUMPIFEQ end&3 LF@?!check$5 bool@true
-
-        LABEL cycle&2
-            GETCHAR LF@?!strlen$4 LF@?!string$3 LF@?!begin$2
-            CONCAT LF@?!output$6 LF@?!output$6 LF@?!strlen$4
-            ADD LF@?!begin$2 LF@?!begin$2 int@1
-            JUMPIFNEQ cycle&2 LF@?!begin$2 LF@?!end$1
-
-        LABEL end&3
-            PUSHS LF@?!output$6
-        RETURN
- * 
- * Všechny proměnné a labely, použité v této funkci, musí mít unikatní 
+ * Vygenerovaný kód bude vložený do samostatného bloku v code_fn.
+ *
+ * Funkce vrací nil, pokud begin < 0, begin > end, end > strlen nebo begin == strlen
+ * (end < 0 a begin > strlen z těchto podmínek plynou), prázdný řetězec pro begin == end.
+ * Výřez kratší než GEN_SUBSTRING_CHUNK se skládá po jednom znaku:
+ *      LABEL cycle&N
+ *      GETCHAR LF@?!char$7 LF@?!string$1 LF@?!begin$2
+ *      CONCAT LF@?!output$6 LF@?!output$6 LF@?!char$7
+ *      ADD LF@?!begin$2 LF@?!begin$2 int@1
+ *      JUMPIFNEQ cycle&N LF@?!begin$2 LF@?!end$3
+ * Delší výřez celého řetězce se pouze zkopíruje. Jinak se znaky (po čtyřech v jedné iteraci) skládají do úseků
+ * délky GEN_SUBSTRING_CHUNK, úseky do bloků délky GEN_SUBSTRING_BLOCK a až bloky do výsledku.
+ * CONCAT tak nekopíruje dlouhý výsledek po každém znaku a čas roste s délkou výřezu téměř lineárně (tests/benchmark měří
+ * výřezy od 1 KB do 1 MB).
+ *
+ * Všechny proměnné a labely, použité v této funkci, musí mít unikatní
  * pojmenování v rámci celého programu
- * 
+ *
  * @brief Vygeneruje kód potřebný pro provedení build-in funkce substring
- * 
- * @param ans Předpokládá se nějaké externí proměnná (z pohledu této funkce), kam bude uložen výsledek
  */
 void genSubstring();
 
+/**
+ * Při konstantních mezích begin > end vloží na zásobník nil. Výřez nejvýše GEN_SUBSTRING_INLINE_MAX znaků
+ * vygeneruje přímo v místě volání, kontroluje se pouze délka řetězce:
+ *      STRLEN      GF@!tmp1 <string>
+ *      MOVE        GF@!tmp2 nil@nil
+ *      LT          GF@!cond GF@!tmp1 int@<end>
+ *      JUMPIFEQ    <substring&inlN> GF@!cond bool@true
+ *      GETCHAR     GF@!tmp2 <string> int@<begin>
+ *      GETCHAR     GF@!tmp3 <string> int@<begin+1>
+ *      CONCAT      GF@!tmp2 GF@!tmp2 GF@!tmp3
+ *      ...
+ *      LABEL       <substring&inlN>
+ *      PUSHS       GF@!tmp2
+ *
+ * @brief Vygeneruje volání substring se známými mezemi bez volání funkce substring
+ * @param args Argumenty volání (řetězec, begin, end)
+ * @return true, pokud byl kód vygenerován, jinak je třeba funkci substring volat
+ */
+bool genSubstringInline(DLLstr_T *args);
+
 #endif // ifndef _GENERATOR_H_
 /* Koniec súboru generator.h */
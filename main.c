@@ -6,21 +6,106 @@
  */
 
 #include "parser.h"
+#include "exp.h"
+#include "optimizer.h"
+#include "emit.h"
+#include "timer.h"
+#include "mem.h"
+#include "stats.h"
 
-int main() {
+int main(int argc, char *argv[]) {
+    const char *output = NULL; // výstupný súbor, inak stdout
+    bool emit_report = false;
+    for (int i = 1; i < argc; i++) { // prepínače prekladača
+        if (strcmp(argv[i], "--tac") == 0) {
+            exp_three_address = true; // výrazy ako trojadresný kód
+        }
+        else if (strcmp(argv[i], "--rotate-loops") == 0) {
+            parser_rotate_loops = true; // podmienka cyklu za jeho telom
+        }
+        else if (strcmp(argv[i], "--dce-report") == 0) {
+            opt_dce_report = true; // počty inštrukcií odstránených ako mŕtvy kód
+        }
+        else if (strcmp(argv[i], "--emit-report") == 0) {
+            emit_report = true; // objem a rýchlosť výpisu cieľového kódu
+        }
+        else if (strcmp(argv[i], "--time-report") == 0) {
+            timer_enabled = true; // čas jednotlivých fáz prekladu
+        }
+        else if (strcmp(argv[i], "--mem-report") == 0) {
+            mem_enabled = true; // alokácie podľa podsystémov, pred prvou alokáciou
+        }
+        else if (strncmp(argv[i], "--stats=", 8) == 0) {
+            if (strcmp(argv[i] + 8, "json") != 0) { // iný formát zatiaľ nie je
+                fprintf(stderr, "invalid value in option %s\n", argv[i]);
+                return COMPILER_ERROR;
+            }
+            stats_enabled = true; // počty tokenov, symbolov, funkcií a inštrukcií
+        }
+        else if (strcmp(argv[i], "-o") == 0) {
+            if (i + 1 == argc) {
+                fprintf(stderr, "missing file name after -o\n");
+                return COMPILER_ERROR;
+            }
+            output = argv[++i];
+        }
+        else if (strncmp(argv[i], "--stream=", 9) == 0) {
+            char *end;
+            long limit = strtol(argv[i] + 9, &end, 10);
+            if (*end != '\0' || end == argv[i] + 9 || limit < 0) {
+                fprintf(stderr, "invalid value in option %s\n", argv[i]);
+                return COMPILER_ERROR;
+            }
+            parser_stream_limit = (size_t)limit; // odkladanie hotového kódu hlavného tela
+        }
+        else if (strncmp(argv[i], "--inline=", 9) == 0) {
+            char *end;
+            long limit = strtol(argv[i] + 9, &end, 10);
+            if (*end != '\0' || end == argv[i] + 9 || limit < 0) {
+                fprintf(stderr, "invalid value in option %s\n", argv[i]);
+                return COMPILER_ERROR;
+            }
+            gen_inline_limit = (size_t)limit; // vkladanie malých funkcií do miesta volania
+        }
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return COMPILER_ERROR;
+        }
+    }
+
+    TIMER_BEGIN(TIMER_COMPILE);
     if (!initializeParser()) return COMPILER_ERROR; // inicializácia dátových štruktúr parsera
     TRY_OR_EXIT(nextToken()); // načítať prvý token
     while (tkn->type != EOF_TKN)
     {
         TRY_OR_EXIT(parse());   // spracovanie základneho príkazu, pravidlo <STAT>
+        streamMainBody();       // hotový kód hlavného tela môže opustiť pamäť
         TRY_OR_EXIT(nextToken());
     }
 
     TRY_OR_EXIT(checkIfAllFnDef()); // zistí, či boli definované všetky volané funkcie
 
+    // súbor sa otvára až po úspešnom preklade, pri chybe zostane pôvodný obsah
+    if (output == NULL) emitInit();
+    else if (!emitOpen(output)) {
+        destroyParser();
+        return COMPILER_ERROR;
+    }
     printOutCompiledCode(); // výpis vygenerovaného cieľového kódu
+    TIMER_BEGIN(TIMER_EMIT);
+    emitClose();
+    TIMER_END();
+    TIMER_END(); // TIMER_COMPILE
+    if (emit_report) emitReport();
+    if (timer_enabled) {
+        timerReport();
+        timer_enabled = false; // uvoľnenie zdrojov sa už nemeria, strom fáz by zostal alokovaný
+    }
+    if (stats_enabled) statsReport();
+    if (gen_inline_limit > 0) genInlineReport();
 
     destroyParser(); // dealokácia použitých zdrojov
+    if (mem_enabled) memReport(); // čo zostalo alokované, je únik
 
     return COMPILATION_OK;
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+/** Projekt IFJ2023
+ * @file mem.c
+ * @brief Sledovanie alokácií pamäte podľa podsystémov (prepínač --mem-report)
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "mem.h"
+
+bool mem_enabled = false;
+
+/// Názvy značiek vo výpise, indexované memTag_T
+static const char *mem_names[] = {
+    "scanner", "source", "string", "atom", "dll", "symtable", "expression", "generator", "optimizer", "emit",
+    "diag"
+};
+
+static struct {
+    memStats_T tags[MEM_TAGS];
+    size_t live;                    ///< práve alokované bajty všetkých značiek
+    size_t peak;                    ///< najväčšia hodnota live
+} mem;
+
+/**
+ * Veľkosti blokov si pamätá alokátor (malloc_usable_size), pred blokom preto nie je žiadna hlavička.
+ *
+ * @brief Započíta značke tag zmenu veľkosti bloku z old_size na new_size, 0 je neexistujúci blok
+*/
+static void memCount(memTag_T tag, size_t old_size, size_t new_size) {
+    memStats_T *stats = &mem.tags[tag];
+    if (new_size > old_size) stats->bytes += new_size - old_size; // realokácia prispeje iba zväčšením
+    stats->live = stats->live - old_size + new_size;
+    if (stats->live > stats->peak) stats->peak = stats->live;
+    mem.live = mem.live - old_size + new_size;
+    if (mem.live > mem.peak) mem.peak = mem.live;
+}
+
+void *memMalloc(memTag_T tag, size_t size) {
+    void *ptr = malloc(size);
+    if (mem_enabled && ptr != NULL) {
+        mem.tags[tag].allocs++;
+        memCount(tag, 0, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void *memCalloc(memTag_T tag, size_t count, size_t size) {
+    void *ptr = calloc(count, size);
+    if (mem_enabled && ptr != NULL) {
+        mem.tags[tag].allocs++;
+        memCount(tag, 0, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void *memRealloc(memTag_T tag, void *ptr, size_t size) {
+    if (!mem_enabled) return realloc(ptr, size);
+    // po úspešnom realloc už starý blok nemusí existovať, jeho veľkosť sa zistí vopred
+    size_t old_size = ptr != NULL ? malloc_usable_size(ptr) : 0;
+    void *new_ptr = realloc(ptr, size);
+    if (new_ptr == NULL) return NULL;
+    if (ptr == NULL) mem.tags[tag].allocs++;
+    else mem.tags[tag].reallocs++;
+    memCount(tag, old_size, malloc_usable_size(new_ptr));
+    return new_ptr;
+}
+
+void memFree(memTag_T tag, void *ptr) {
+    if (mem_enabled && ptr != NULL) {
+        mem.tags[tag].frees++;
+        memCount(tag, malloc_usable_size(ptr), 0);
+    }
+    free(ptr);
+}
+
+const memStats_T *memStats(memTag_T tag) {
+    return &mem.tags[tag];
+}
+
+size_t memPeak() {
+    return mem.peak;
+}
+
+void memReport() {
+    fprintf(stderr, "%-12s %10s %10s %10s %14s %14s %12s\n",
+        "tag", "allocs", "reallocs", "frees", "total [B]", "peak [B]", "leaked [B]");
+    memStats_T sum = {0};
+    for (int t = 0; t < MEM_TAGS; t++) {
+        memStats_T *stats = &mem.tags[t];
+        fprintf(stderr, "%-12s %10zu %10zu %10zu %14zu %14zu %12zu\n", mem_names[t],
+            stats->allocs, stats->reallocs, stats->frees, stats->bytes, stats->peak, stats->live);
+        sum.allocs += stats->allocs;
+        sum.reallocs += stats->reallocs;
+        sum.frees += stats->frees;
+        sum.bytes += stats->bytes;
+        sum.live += stats->live;
+    }
+    // špička celku je menšia ako súčet špičiek značiek, ak nenastali naraz
+    fprintf(stderr, "%-12s %10zu %10zu %10zu %14zu %14zu %12zu\n", "total",
+        sum.allocs, sum.reallocs, sum.frees, sum.bytes, mem.peak, sum.live);
+    if (sum.live > 0) {
+        fprintf(stderr, "leaked: %zu bytes in %zu blocks\n", sum.live, sum.allocs - sum.frees);
+    }
+}
+
+/* Koniec súboru mem.c */
@@ -0,0 +1,90 @@
+/** Projekt IFJ2023
+ * @file mem.h
+ * @brief Sledovanie alokácií pamäte podľa podsystémov (prepínač --mem-report)
+ */
+
+#ifndef _MEM_H_
+#define _MEM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Značka patrí vlastníkovi dátovej štruktúry, nie súboru, v ktorom sa volá alokácia
+ * (napr. pole inštrukcií nahradené optimalizátorom zostáva MEM_GENERATOR).
+ *
+ * @brief Podsystémy, ktorým sa pripisujú alokácie
+*/
+typedef enum mem_tag {
+    MEM_SCANNER,        ///< tokeny a ich atribúty
+    MEM_SOURCE,         ///< vyrovnávacia pamäť zdrojového kódu (bez mmap)
+    MEM_STRING,         ///< dynamické reťazce strR
+    MEM_ATOM,           ///< internované identifikátory a zoznamy atómov
+    MEM_DLL,            ///< zoznamy reťazcov DLLstr
+    MEM_SYMTAB,         ///< tabuľka symbolov
+    MEM_EXPRESSION,     ///< zásobníky a tokeny precedenčnej analýzy
+    MEM_GENERATOR,      ///< bloky inštrukcií, mená, pomocné tabuľky generátora
+    MEM_OPTIMIZER,      ///< pomocné polia optimalizátora
+    MEM_EMIT,           ///< vyrovnávacie pamäte výstupu
+    MEM_DIAG,           ///< diagnostika --time-report a --stats
+    MEM_TAGS            ///< počet značiek
+} memTag_T;
+
+/**
+ * @brief Štatistika alokácií jednej značky, veľkosti sú využiteľné veľkosti blokov (malloc_usable_size)
+*/
+typedef struct mem_stats {
+    size_t allocs;      ///< počet nových blokov (malloc, calloc, realloc z NULL)
+    size_t reallocs;    ///< počet zmien veľkosti existujúceho bloku
+    size_t frees;       ///< počet uvoľnených blokov
+    size_t bytes;       ///< súčet bajtov všetkých alokácií a zväčšení
+    size_t live;        ///< práve alokované bajty
+    size_t peak;        ///< najväčší počet naraz alokovaných bajtov
+} memStats_T;
+
+/**
+ * Musí sa nastaviť pred prvou alokáciou a už nemeniť, inak by sa uvoľňovali nezapočítané bloky.
+ *
+ * @brief Sledovanie je zapnuté, inak funkcie iba zavolajú malloc, calloc, realloc alebo free
+*/
+extern bool mem_enabled;
+
+/**
+ * @brief malloc pripísaný značke tag
+*/
+void *memMalloc(memTag_T tag, size_t size);
+
+/**
+ * @brief calloc pripísaný značke tag
+*/
+void *memCalloc(memTag_T tag, size_t count, size_t size);
+
+/**
+ * @brief realloc pripísaný značke tag, pri neúspechu zostáva pôvodný blok započítaný
+*/
+void *memRealloc(memTag_T tag, void *ptr, size_t size);
+
+/**
+ * @brief free bloku alokovaného so značkou tag
+*/
+void memFree(memTag_T tag, void *ptr);
+
+/**
+ * @brief Štatistika značky tag
+*/
+const memStats_T *memStats(memTag_T tag);
+
+/**
+ * @brief Najväčší počet naraz alokovaných bajtov cez všetky značky
+*/
+size_t memPeak();
+
+/**
+ * Volá sa po destroyParser, bajty, ktoré sú ešte alokované, sú únikom pamäte.
+ *
+ * @brief Vypíše na stderr pre každú značku počty alokácií, celkový objem, špičku a neuvoľnené bajty
+*/
+void memReport();
+
+#endif // ifndef _MEM_H_
+/* Koniec súboru mem.h */
@@ -0,0 +1,465 @@
+/** Projekt IFJ2023
+ * @file optimizer.c
+ * @brief Optimalizácie vygenerovaného cieľového kódu
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "optimizer.h"
+#include "mem.h"
+
+#define OPT_MAX_PATTERN 5       ///< najdlhší vzor pravidla
+#define OPT_LIVENESS_BUDGET 256 ///< najviac prezretých inštrukcií pri zisťovaní, či je pomocná premenná mŕtva
+
+/**
+ * @brief Operandy vo vzore a náhrade pravidla
+ * @details Metapremenné (PO_A až PO_U) sa pri prvom výskyte naviažu na operand inštrukcie,
+ * ďalšie výskyty sa s ním musia zhodovať. Rôzne metapremenné sa vždy naviažu na rôzne operandy,
+ * okrem PO_V až PO_X, ktoré sa smú zhodovať s ľubovoľnou inou metapremennou.
+*/
+enum opt_operands {
+    PO_NONE = 0,    ///< operand nie je použitý
+    PO_A,           ///< ľubovoľný operand
+    PO_B,
+    PO_C,
+    PO_D,
+    PO_V,           ///< ľubovoľný operand, smie sa zhodovať s inými metapremennými
+    PO_W,
+    PO_X,
+    PO_L,           ///< náveštie
+    PO_T,           ///< pomocná premenná GF@!tmpN, ktorá už za vzorom nie je čítaná
+    PO_U,
+    PO_FALSE,       ///< bool@false
+    PO_TRUE,        ///< bool@true
+    PO_COND,        ///< VAR_COND
+    PO_COUNT
+};
+
+#define PO_IS_META(spec) ((spec) >= PO_A && (spec) <= PO_U)    ///< operand je metapremenná
+#define PO_IS_TEMP(spec) ((spec) == PO_T || (spec) == PO_U)    ///< metapremenná musí byť mŕtva pomocná premenná
+#define PO_IS_ALIAS(spec) ((spec) >= PO_V && (spec) <= PO_X)  ///< metapremenná sa smie zhodovať s inými
+
+/**
+ * @brief Inštrukcia vo vzore alebo v náhrade pravidla
+*/
+typedef struct opt_ins {
+    unsigned char code;     ///< operačný kód, ins_code_T
+    unsigned char op[3];    ///< operandy, opt_operands
+} optIns_T;
+
+/**
+ * @brief Pravidlo peephole optimalizácie
+*/
+typedef struct opt_rule {
+    const char *name;
+    size_t len;                         ///< dĺžka vzoru
+    optIns_T pattern[OPT_MAX_PATTERN];  ///< vzor, súvislá postupnosť inštrukcií
+    size_t out_len;                     ///< dĺžka náhrady, vždy kratšia ako vzor
+    optIns_T replace[OPT_MAX_PATTERN];  ///< náhrada vzoru
+    size_t hits;                        ///< počet použití pravidla
+} optRule_T;
+
+/**
+ * @brief Pravidlo OP T V W, MOVE X T  =>  OP X V W pre trojadresnú inštrukciu OP
+*/
+#define OPT_OP_MOVE(name, code) \
+    {name, 2, {{code, {PO_T, PO_V, PO_W}}, {INS_MOVE, {PO_X, PO_T}}}, 1, {{code, {PO_X, PO_V, PO_W}}}, 0}
+
+/**
+ * @brief Tabuľka pravidiel, pri zhode viacerých pravidiel sa použije prvé z nich
+*/
+static optRule_T rules[] = {
+    // priradenie výsledku výrazu, ktorý je iba premennou či konštantou
+    {"push-pop-self", 2, {{INS_PUSHS, {PO_A}}, {INS_POPS, {PO_A}}},
+        0, {{0}}, 0},
+    {"push-pop-move", 2, {{INS_PUSHS, {PO_A}}, {INS_POPS, {PO_B}}},
+        1, {{INS_MOVE, {PO_B, PO_A}}}, 0},
+    {"push-move-pop", 3, {{INS_PUSHS, {PO_A}}, {INS_MOVE, {PO_B, PO_C}}, {INS_POPS, {PO_D}}},
+        2, {{INS_MOVE, {PO_B, PO_C}}, {INS_MOVE, {PO_D, PO_A}}}, 0},
+
+    // podmienené skoky podľa výsledku podmienky if a while
+    {"not-jump-false", 3, {{INS_NOTS, {PO_NONE}}, {INS_PUSHS, {PO_FALSE}}, {INS_JUMPIFEQS, {PO_L}}},
+        2, {{INS_PUSHS, {PO_TRUE}}, {INS_JUMPIFEQS, {PO_L}}}, 0},
+    {"not-jump-true", 3, {{INS_NOTS, {PO_NONE}}, {INS_PUSHS, {PO_TRUE}}, {INS_JUMPIFEQS, {PO_L}}},
+        2, {{INS_PUSHS, {PO_FALSE}}, {INS_JUMPIFEQS, {PO_L}}}, 0},
+    {"eq-jump-false", 5, {{INS_PUSHS, {PO_A}}, {INS_PUSHS, {PO_B}}, {INS_EQS, {PO_NONE}}, {INS_PUSHS, {PO_FALSE}}, {INS_JUMPIFEQS, {PO_L}}},
+        1, {{INS_JUMPIFNEQ, {PO_L, PO_A, PO_B}}}, 0},
+    {"eq-jump-true", 5, {{INS_PUSHS, {PO_A}}, {INS_PUSHS, {PO_B}}, {INS_EQS, {PO_NONE}}, {INS_PUSHS, {PO_TRUE}}, {INS_JUMPIFEQS, {PO_L}}},
+        1, {{INS_JUMPIFEQ, {PO_L, PO_A, PO_B}}}, 0},
+    {"lt-jump", 5, {{INS_PUSHS, {PO_A}}, {INS_PUSHS, {PO_B}}, {INS_LTS, {PO_NONE}}, {INS_PUSHS, {PO_C}}, {INS_JUMPIFEQS, {PO_L}}},
+        2, {{INS_LT, {PO_COND, PO_A, PO_B}}, {INS_JUMPIFEQ, {PO_L, PO_COND, PO_C}}}, 0},
+    {"gt-jump", 5, {{INS_PUSHS, {PO_A}}, {INS_PUSHS, {PO_B}}, {INS_GTS, {PO_NONE}}, {INS_PUSHS, {PO_C}}, {INS_JUMPIFEQS, {PO_L}}},
+        2, {{INS_GT, {PO_COND, PO_A, PO_B}}, {INS_JUMPIFEQ, {PO_L, PO_COND, PO_C}}}, 0},
+    {"push-jump", 3, {{INS_PUSHS, {PO_A}}, {INS_PUSHS, {PO_B}}, {INS_JUMPIFEQS, {PO_L}}},
+        1, {{INS_JUMPIFEQ, {PO_L, PO_A, PO_B}}}, 0},
+
+    // presuny cez pomocné premenné pri ??, konkatenácii a konverzii Int na Double
+    {"pop-push-temp", 2, {{INS_POPS, {PO_T}}, {INS_PUSHS, {PO_T}}},
+        0, {{0}}, 0},
+    {"move-push-temp", 2, {{INS_MOVE, {PO_T, PO_A}}, {INS_PUSHS, {PO_T}}},
+        1, {{INS_PUSHS, {PO_A}}}, 0},
+    {"move-concat-left", 2, {{INS_MOVE, {PO_T, PO_A}}, {INS_CONCAT, {PO_C, PO_T, PO_B}}},
+        1, {{INS_CONCAT, {PO_C, PO_A, PO_B}}}, 0},
+    {"move-concat-right", 2, {{INS_MOVE, {PO_T, PO_B}}, {INS_CONCAT, {PO_C, PO_A, PO_T}}},
+        1, {{INS_CONCAT, {PO_C, PO_A, PO_B}}}, 0},
+    {"concat-move", 2, {{INS_CONCAT, {PO_T, PO_A, PO_B}}, {INS_MOVE, {PO_V, PO_T}}},
+        1, {{INS_CONCAT, {PO_V, PO_A, PO_B}}}, 0},
+    {"move-int2float", 2, {{INS_MOVE, {PO_T, PO_A}}, {INS_INT2FLOAT, {PO_B, PO_T}}},
+        1, {{INS_INT2FLOAT, {PO_B, PO_A}}}, 0},
+    {"int2float-move", 2, {{INS_INT2FLOAT, {PO_T, PO_A}}, {INS_MOVE, {PO_V, PO_T}}},
+        1, {{INS_INT2FLOAT, {PO_V, PO_A}}}, 0},
+
+    // trojadresný kód výrazov (--tac), výsledok sa zapíše priamo do cieľa namiesto pomocnej premennej
+    OPT_OP_MOVE("add-move", INS_ADD),
+    OPT_OP_MOVE("sub-move", INS_SUB),
+    OPT_OP_MOVE("mul-move", INS_MUL),
+    OPT_OP_MOVE("div-move", INS_DIV),
+    OPT_OP_MOVE("idiv-move", INS_IDIV),
+    OPT_OP_MOVE("lt-move", INS_LT),
+    OPT_OP_MOVE("gt-move", INS_GT),
+    OPT_OP_MOVE("eq-move", INS_EQ),
+    {"not-move", 2, {{INS_NOT, {PO_T, PO_T}}, {INS_MOVE, {PO_V, PO_T}}},
+        1, {{INS_NOT, {PO_V, PO_T}}}, 0},
+    {"not-jump-temp", 2, {{INS_NOT, {PO_T, PO_T}}, {INS_JUMPIFEQ, {PO_L, PO_T, PO_FALSE}}},
+        1, {{INS_JUMPIFEQ, {PO_L, PO_T, PO_TRUE}}}, 0},
+
+    {"dead-move-temp", 1, {{INS_MOVE, {PO_T, PO_A}}},
+        0, {{0}}, 0},
+};
+
+#define OPT_RULE_COUNT (sizeof(rules) / sizeof(rules[0]))
+
+/**
+ * @brief Stav optimalizácie práve spracúvaného bloku
+*/
+static struct {
+    ins_T *in;                  ///< pôvodné inštrukcie bloku
+    size_t used;                ///< počet pôvodných inštrukcií
+    size_t *labels;             ///< rozptylová tabuľka náveští, obsahuje index inštrukcie LABEL + 1, 0 je voľné miesto
+    size_t labels_size;         ///< mocnina dvojky
+    operand_T fixed[PO_COUNT];  ///< hodnoty pevných operandov (PO_FALSE, PO_TRUE, PO_COND)
+    bool main;                  ///< blok je hlavné telo programu alebo jeho časť ukončená na hranici príkazu
+} opt;
+
+/**
+ * @brief Zhoda dvoch operandov
+*/
+static bool optSameOperand(operand_T *a, operand_T *b) {
+    return a->kind == b->kind && a->sub == b->sub && a->id == b->id;
+}
+
+/**
+ * @brief Zistí, či je operand pomocnou premennou GF@!tmpN
+*/
+static bool optIsTemp(operand_T *op) {
+    return op->kind == OPD_VAR && strncmp(genOperandText(op), VAR_TMP_PREFIX, strlen(VAR_TMP_PREFIX)) == 0;
+}
+
+/**
+ * @brief Zistí, či inštrukcia iba zapisuje do svojho prvého operandu (bez jeho čítania)
+*/
+static bool optWritesFirst(unsigned char code) {
+    switch (code) {
+    case INS_MOVE: case INS_DEFVAR: case INS_POPS:
+    case INS_ADD: case INS_SUB: case INS_MUL: case INS_DIV: case INS_IDIV:
+    case INS_LT: case INS_GT: case INS_EQ: case INS_AND: case INS_OR: case INS_NOT:
+    case INS_INT2FLOAT: case INS_FLOAT2INT: case INS_INT2CHAR: case INS_STRI2INT:
+    case INS_READ: case INS_CONCAT: case INS_STRLEN: case INS_GETCHAR: case INS_TYPE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Vráti index inštrukcie LABEL s daným náveštím, alebo used, ak v bloku nie je
+*/
+static size_t optLabelIndex(unsigned int label) {
+    if (opt.labels_size == 0) return opt.used;
+    size_t mask = opt.labels_size - 1;
+    size_t i = label & mask;
+    while (opt.labels[i] != 0) {
+        if (opt.in[opt.labels[i] - 1].op[0].id == label) return opt.labels[i] - 1;
+        i = (i + 1) & mask;
+    }
+    return opt.used;
+}
+
+/**
+ * @brief Zostaví rozptylovú tabuľku náveští bloku
+*/
+static void optIndexLabels() {
+    size_t count = 0;
+    for (size_t i = 0; i < opt.used; i++) {
+        if (opt.in[i].code == INS_LABEL) count++;
+    }
+    opt.labels_size = 0;
+    opt.labels = NULL;
+    if (count == 0) return;
+
+    opt.labels_size = 16;
+    while (opt.labels_size < 2 * count) opt.labels_size *= 2;
+    opt.labels = memCalloc(MEM_OPTIMIZER, opt.labels_size, sizeof(size_t));
+    if (opt.labels == NULL) {
+        fprintf(stderr, "optPeephole() memory allocation error.\n");
+        exit(COMPILER_ERROR);
+    }
+    size_t mask = opt.labels_size - 1;
+    for (size_t i = 0; i < opt.used; i++) {
+        if (opt.in[i].code != INS_LABEL) continue;
+        size_t j = opt.in[i].op[0].id & mask;
+        while (opt.labels[j] != 0) j = (j + 1) & mask;
+        opt.labels[j] = i + 1;
+    }
+}
+
+/**
+ * Prechádza pôvodné inštrukcie od pos po všetkých cestách (skoky sleduje cez tabuľku náveští).
+ * Premenná je mŕtva, ak je na každej ceste skôr prepísaná ako čítaná. Pri volaní funkcie,
+ * návrate z funkcie, konci bloku funkcie alebo vyčerpaní budget sa predpokladá, že je živá.
+ * Za hlavným telom nasleduje EXIT alebo ďalší príkaz (viď. streamMainBody), ktorý pomocnú premennú
+ * najprv zapíše, na konci hlavného tela je teda mŕtva.
+ *
+ * @brief Zistí, či hodnota premennej var pred inštrukciou pos už nebude čítaná
+*/
+static bool optDeadAt(size_t pos, operand_T *var, int *budget) {
+    while (pos < opt.used && (*budget)-- > 0) {
+        ins_T *ins = &(opt.in[pos]);
+        bool writes = optWritesFirst(ins->code);
+        for (int i = writes ? 1 : 0; i < 3; i++) {
+            if (optSameOperand(&(ins->op[i]), var)) return false;
+        }
+        if (writes && optSameOperand(&(ins->op[0]), var)) return true;
+
+        switch (ins->code) {
+        case INS_JUMP:
+            pos = optLabelIndex(ins->op[0].id);
+            continue;
+        case INS_JUMPIFEQ:
+        case INS_JUMPIFNEQ:
+        case INS_JUMPIFEQS:
+        case INS_JUMPIFNEQS:
+            if (!optDeadAt(optLabelIndex(ins->op[0].id), var, budget)) return false;
+            break;
+        case INS_CALL:
+        case INS_RETURN:
+            return false;
+        case INS_EXIT:
+            return true;
+        default:
+            break;
+        }
+        pos++;
+    }
+    return pos >= opt.used && opt.main;
+}
+
+/**
+ * @brief Porovná okno inštrukcií so vzorom pravidla a naviaže metapremenné
+ * @param next index pôvodnej inštrukcie za oknom, od neho sa zisťuje, či sú pomocné premenné mŕtve
+ * @param bound naviazané operandy, indexované opt_operands
+*/
+static bool optMatch(optRule_T *rule, ins_T *window, size_t next, operand_T *bound) {
+    bool is_bound[PO_COUNT] = {false};
+
+    for (size_t k = 0; k < rule->len; k++) {
+        if (window[k].code != rule->pattern[k].code) return false;
+        for (int o = 0; o < 3; o++) {
+            unsigned char spec = rule->pattern[k].op[o];
+            operand_T *op = &(window[k].op[o]);
+            if (spec == PO_NONE) {
+                if (op->kind != OPD_NONE) return false;
+            }
+            else if (!PO_IS_META(spec)) {
+                if (!optSameOperand(op, &opt.fixed[spec])) return false;
+            }
+            else if (is_bound[spec]) {
+                if (!optSameOperand(op, &bound[spec])) return false;
+            }
+            else {
+                if (PO_IS_TEMP(spec) && !optIsTemp(op)) return false;
+                for (unsigned char m = PO_A; m <= PO_U && !PO_IS_ALIAS(spec); m++) {
+                    if (is_bound[m] && !PO_IS_ALIAS(m) && optSameOperand(op, &bound[m])) return false;
+                }
+                bound[spec] = *op;
+                is_bound[spec] = true;
+            }
+        }
+    }
+
+    // pomocné premenné musia byť mŕtve za vzorom aj na náveští skoku zo vzoru
+    for (unsigned char m = PO_T; m <= PO_U; m++) {
+        int budget = OPT_LIVENESS_BUDGET;
+        if (is_bound[m] && !optDeadAt(next, &bound[m], &budget)) return false;
+        for (size_t k = 0; k < rule->len && is_bound[m]; k++) {
+            if (rule->pattern[k].op[0] != PO_L) continue;
+            if (!optDeadAt(optLabelIndex(window[k].op[0].id), &bound[m], &budget)) return false;
+        }
+    }
+    return true;
+}
+
+void optPeephole(codeBlock_T *block) {
+    genExpandHoists(block);
+    if (block->used == 0) return;
+
+    opt.in = block->ins;
+    opt.used = block->used;
+    opt.main = block == &code_main;
+    optIndexLabels();
+    opt.fixed[PO_FALSE] = genOperand("bool@false");
+    opt.fixed[PO_TRUE] = genOperand("bool@true");
+    opt.fixed[PO_COND] = genOperand(VAR_COND);
+
+    // náhrady sú kratšie ako vzory, výsledok sa preto zmestí do poľa veľkosti pôvodného bloku
+    ins_T *out = memMalloc(MEM_GENERATOR, block->used * sizeof(ins_T));
+    if (out == NULL) {
+        fprintf(stderr, "optPeephole() memory allocation error.\n");
+        exit(COMPILER_ERROR);
+    }
+    size_t used = 0;
+
+    for (size_t i = 0; i < block->used; i++) {
+        out[used++] = block->ins[i];
+
+        // pravidlá sa skúšajú na konci výstupu, kým sa niektoré dá použiť
+        bool rewritten = true;
+        while (rewritten) {
+            rewritten = false;
+            for (size_t r = 0; r < OPT_RULE_COUNT && !rewritten; r++) {
+                optRule_T *rule = &rules[r];
+                operand_T bound[PO_COUNT];
+                if (rule->len > used || !optMatch(rule, &out[used - rule->len], i + 1, bound)) continue;
+
+                for (unsigned char f = PO_FALSE; f < PO_COUNT; f++) bound[f] = opt.fixed[f];
+                used -= rule->len;
+                for (size_t k = 0; k < rule->out_len; k++) {
+                    ins_T *ins = &out[used++];
+                    ins->code = rule->replace[k].code;
+                    for (int o = 0; o < 3; o++) {
+                        unsigned char spec = rule->replace[k].op[o];
+                        ins->op[o] = spec == PO_NONE ? (operand_T){OPD_NONE, 0, 0} : bound[spec];
+                    }
+                }
+                rule->hits++;
+                rewritten = true;
+            }
+        }
+    }
+
+    memFree(MEM_OPTIMIZER, opt.labels);
+    opt.labels = NULL;
+    memFree(MEM_GENERATOR, block->ins);
+    block->ins = out;
+    block->size = block->used;
+    block->used = used;
+}
+
+bool opt_dce_report = false;
+
+/**
+ * @brief Zistí, či je inštrukcia skokom na náveštie v rámci bloku
+*/
+static bool optIsJump(unsigned char code) {
+    return code == INS_JUMP || code == INS_JUMPIFEQ || code == INS_JUMPIFNEQ ||
+        code == INS_JUMPIFEQS || code == INS_JUMPIFNEQS;
+}
+
+/**
+ * @brief Jeden prechod odstránenia mŕtveho kódu z opt.in, inštrukcie sa presúvajú na miesto odstránených
+ * @return nový počet inštrukcií
+*/
+static size_t optDeadCodePass() {
+    optIndexLabels();
+    bool *reachable = memCalloc(MEM_OPTIMIZER, opt.used, sizeof(bool));
+    size_t *pending = memMalloc(MEM_OPTIMIZER, opt.used * sizeof(size_t)); // začiatky ciest, ktoré ešte neboli prejdené
+    size_t *refs = memCalloc(MEM_OPTIMIZER, opt.used, sizeof(size_t));     // počet dosiahnuteľných skokov podľa indexu náveštia
+    if (reachable == NULL || pending == NULL || refs == NULL) {
+        fprintf(stderr, "optDeadCode() memory allocation error.\n");
+        exit(COMPILER_ERROR);
+    }
+
+    // dosiahnuteľnosť od začiatku bloku, každá inštrukcia sa do pending vloží najviac raz
+    size_t top = 0;
+    reachable[0] = true;
+    pending[top++] = 0;
+    while (top > 0) {
+        size_t pos = pending[--top];
+        while (true) {
+            ins_T *ins = &(opt.in[pos]);
+            if (optIsJump(ins->code)) {
+                size_t target = optLabelIndex(ins->op[0].id);
+                if (target < opt.used && !reachable[target]) {
+                    reachable[target] = true;
+                    pending[top++] = target;
+                }
+            }
+            if (ins->code == INS_JUMP || ins->code == INS_RETURN || ins->code == INS_EXIT) break;
+            if (pos + 1 >= opt.used || reachable[pos + 1]) break;
+            reachable[++pos] = true;
+        }
+    }
+    for (size_t i = 0; i < opt.used; i++) {
+        if (reachable[i] && optIsJump(opt.in[i].code)) {
+            size_t target = optLabelIndex(opt.in[i].op[0].id);
+            if (target < opt.used) refs[target]++;
+        }
+    }
+
+    size_t used = 0;
+    for (size_t i = 0; i < opt.used; i++) {
+        ins_T *ins = &(opt.in[i]);
+        if (!reachable[i]) continue;
+        // náveštie funkcie na začiatku bloku je cieľom CALL z iných blokov
+        if (ins->code == INS_LABEL && (i > 0 || opt.main) && refs[i] == 0) continue;
+        if (ins->code == INS_JUMP) {
+            // skok na náveštie, pred ktorým sú už iba náveštia a nedosiahnuteľný kód
+            size_t target = optLabelIndex(ins->op[0].id);
+            size_t k = i + 1;
+            while (k < target && (!reachable[k] || opt.in[k].code == INS_LABEL)) k++;
+            if (k == target && target < opt.used) {
+                refs[target]--;
+                continue;
+            }
+        }
+        opt.in[used++] = *ins;
+    }
+
+    memFree(MEM_OPTIMIZER, reachable);
+    memFree(MEM_OPTIMIZER, pending);
+    memFree(MEM_OPTIMIZER, refs);
+    memFree(MEM_OPTIMIZER, opt.labels);
+    opt.labels = NULL;
+    return used;
+}
+
+size_t optDeadCode(codeBlock_T *block) {
+    genExpandHoists(block);
+    size_t before = block->used;
+    opt.in = block->ins;
+    opt.used = block->used;
+    opt.main = block == &code_main;
+    // odstránenie skoku môže uvoľniť náveštie a naopak, prechody sa opakujú, kým niečo ubúda
+    while (opt.used > 0) {
+        size_t used = optDeadCodePass();
+        if (used == opt.used) break;
+        opt.used = used;
+    }
+    block->used = opt.used;
+    return before - block->used;
+}
+
+size_t optRuleCount() {
+    return OPT_RULE_COUNT;
+}
+
+const char *optRuleName(size_t rule) {
+    return rules[rule].name;
+}
+
+size_t optRuleHits(size_t rule) {
+    return rules[rule].hits;
+}
+
+/* Koniec súboru optimizer.c */
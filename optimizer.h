@@ -0,0 +1,64 @@
+/** Projekt IFJ2023
+ * @file optimizer.h
+ * @brief Optimalizácie vygenerovaného cieľového kódu
+ */
+
+#ifndef _OPTIMIZER_H_
+#define _OPTIMIZER_H_
+
+#include "generator.h"
+
+/**
+ * Pravidlá sú zapísané v tabuľke ako vzor súvislej postupnosti inštrukcií a jej náhrada.
+ * Napríklad:
+ *      PUSHS A, POPS B                                     =>  MOVE B A
+ *      PUSHS A, PUSHS B, EQS, PUSHS bool@false, JUMPIFEQS L  =>  JUMPIFNEQ L A B
+ *      MOVE T A, PUSHS T                                   =>  PUSHS A, ak je GF@!tmpN (T) ďalej nevyužitá
+ *
+ * Náhrada je vždy kratšia ako vzor, blok sa preto prejde iba raz a po každej náhrade sa
+ * pravidlá skúšajú znova na konci už optimalizovaného kódu. Na konci code_main (aj jeho odloženej
+ * časti, viď. streamMainBody) sú pomocné premenné GF@!tmpN mŕtve.
+ *
+ * @brief Peephole optimalizácia bloku kódu
+ * @param block blok kódu funkcie alebo hlavného tela programu
+*/
+void optPeephole(codeBlock_T *block);
+
+/**
+ * @brief Vypísať počet inštrukcií odstránených optDeadCode pre každú funkciu (prepínač --dce-report)
+*/
+extern bool opt_dce_report;
+
+/**
+ * Od začiatku bloku sa prejdú všetky cesty (podmienený skok pokračuje na náveští aj za sebou,
+ * JUMP iba na náveští, RETURN a EXIT nepokračujú). Odstránia sa:
+ *      - nedosiahnuteľné inštrukcie, napr. kód za return alebo vetva if s konštantnou podmienkou
+ *      - náveštia, na ktoré neskáče žiadny skok (okrem náveštia funkcie na začiatku bloku funkcie)
+ *      - JUMP na náveštie, ktoré za ním nasleduje
+ * Prechody sa opakujú, kým sa blok zmenšuje.
+ *
+ * @brief Odstráni mŕtvy kód bloku
+ * @param block blok kódu funkcie alebo hlavného tela programu
+ * @return počet odstránených inštrukcií
+*/
+size_t optDeadCode(codeBlock_T *block);
+
+/**
+ * @brief Počet pravidiel peephole optimalizácie
+*/
+size_t optRuleCount();
+
+/**
+ * @brief Názov pravidla peephole optimalizácie
+ * @param rule index pravidla, menší ako optRuleCount()
+*/
+const char *optRuleName(size_t rule);
+
+/**
+ * @brief Počet použití pravidla peephole optimalizácie od začiatku prekladu
+ * @param rule index pravidla, menší ako optRuleCount()
+*/
+size_t optRuleHits(size_t rule);
+
+#endif // ifndef _OPTIMIZER_H_
+/* Koniec súboru optimizer.h */
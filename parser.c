@@ -5,10 +5,16 @@
  * @date 22.11.2023
  */
 
+#include <limits.h>
+#include <math.h>
 #include "parser.h"
 #include "logErr.h"
 #include "exp.h"
 #include "generator.h"
+#include "optimizer.h"
+#include "emit.h"
+#include "timer.h"
+#include "stats.h"
 
 token_T* tkn = NULL;
 
@@ -16,15 +22,24 @@ SymTab_T symt;
 
 bool parser_inside_fn_def = false;
 
+bool parser_rotate_loops = false;
+
+size_t parser_stream_limit = PARSER_STREAM_LIMIT;
+
+/**
+ * @brief Názov funkcie, ktorej definícia je práve spracovávaná, mimo funkcie prázdny atóm
+*/
+static atom_T *fn_name;
+
 /**
- * @brief Názov funkcie, ktorej definícia je práve spracovávaná
+ * @brief Atóm "_", vynechaný názov alebo identifikátor parametra
 */
-static str_T fn_name;
+static atom_T *atom_underscore;
 
 /**
  * @brief Zoznam mien funkcií, pri ktorých treba na konci sémantickej analýzy skontrovať, či boli definované.
 */
-static DLLstr_T check_def_fns;
+static atomList_T check_def_fns;
 
 /**
  * @brief Indikuje, či sa parser nachádza vo vnútri cykla.
@@ -32,9 +47,9 @@ static DLLstr_T check_def_fns;
 static bool parser_inside_loop = false;
 
 /**
- * @brief Meno náveštia na najvrchnejší cyklus
+ * @brief Miesto pred náveštím najvrchnejšieho cyklu pre definície premenných, viď. genLoopHoistSlot
 */
-static str_T first_loop_label;
+static size_t first_loop_slot;
 
 /**
  * @brief Zoznam premenných,, ktoré musia byť dekalrované pred prvým nespracovaným cyklom
@@ -46,6 +61,21 @@ static DLLstr_T variables_declared_inside_loop;
 */
 static bool bifn_substring_called = false;
 
+/**
+ * @brief Aktuálny token bol vrátený cez saveToken, nextToken ho znova nezapočíta do štatistík
+*/
+static bool tkn_saved = false;
+
+/**
+ * @brief Počet inštrukcií odstránených ako mŕtvy kód z už odloženého kódu hlavného tela
+*/
+static size_t main_dce_removed = 0;
+
+/**
+ * @brief Stav tabuľky náveští po poslednom odložení kódu hlavného tela, viď. streamMainBody
+*/
+static genMark_T main_mark;
+
 /* ----------- PRIVATE FUNKCIE ----------- */
 
 /**
@@ -68,82 +98,6 @@ char convertNilTypeToNonNil(char nil_type) {
     return nil_type;
 }
 
-/**
- * @brief Zistí, či sa v zozname nachádzajú medzi sebou rôzne reťazce (pozor! reťazce "_" sú ignorované), resp. nie je možné nájsť dva totožné.
- * @param list zoznam
- * @param is_unique Ukazateľ na bool, kde sa zapíše false ak existujú dve položky zoznamu s rovnakým reťazcom, inak true
- * @warning Mení aktivitu zoznamu.
- * @return true v prípade úspechu, false v prípade chyby programu
-*/
-bool listHasUniqueValues(DLLstr_T* list, bool* is_unique) {
-    str_T a, b; // reťazce položiek A a B
-    StrInit(&a);
-    StrInit(&b);
-
-    DLLstr_First(list);
-    for (size_t i = 0; DLLstr_IsActive(list); i++) {
-        for (size_t j = 0; j < i; j++) {
-            DLLstr_Next(list);
-        }
-        if (!DLLstr_IsActive(list)) break;
-        if (!DLLstr_GetValue(list, &a)) return false; // načítanie položky A
-        if (strcmp(StrRead(&a), "_") != 0) { // reťazce "_" sú ignorované
-            DLLstr_Next(list);
-            while (DLLstr_IsActive(list)) { // porovnávanie s položkami napravo od položky A
-                if (!DLLstr_GetValue(list, &b)) return false; // načítanie položky B
-                if (strcmp(StrRead(&a), StrRead(&b)) == 0) {
-                    // totožné reťazce
-                    StrDestroy(&a);
-                    StrDestroy(&b);
-                    *is_unique = false;
-                    return true;
-                }
-                DLLstr_Next(list);
-            }
-        }
-        DLLstr_First(list);
-    }
-
-    StrDestroy(&a);
-    StrDestroy(&b);
-    *is_unique = true;
-    return true;
-}
-
-/**
- * Vstavané funkcie:
- *      "readString", "readInt", "readDouble",
- *      "write", "Int2Double", "Double2Int",
- *      "length", "substring", "ord", "chr"
- * @brief Zistí či funkcia je vstavaná.
- * @param function_name názov testovanej funkcie
- * @return true ak funkcia je vstavaná, inak false
-*/
-bool isBuiltInFunction(char* function_name) {
-    static size_t total_num_of_bif = 10;
-    static char* built_in_functions[] = {
-        "readString", "readInt", "readDouble",
-        "write", "Int2Double", "Double2Int",
-        "length", "substring", "ord", "chr"
-    };
-    for (size_t i = 0; i < total_num_of_bif; i++) {
-        if (strcmp(function_name, built_in_functions[i]) == 0) return true;
-    }
-    return false;
-}
-
-/**
- * Vlastný lokálny rámec si vytvárajú všetky uživateľom definované funkcie a vstavaná funkcia substring.
- * Pri ostatných vstavaných funkciach nie je potrebné popovať lokálny rámec
- *
- * @brief Určí či je potrebné pri volaní určitej funkcie pop-núť lokálny rámec
- * @param function_name Názov testovanej funkcie
- * @return true ak je potrebné zavolať popframe po vykonaní funkcie, inak false
-*/
-bool shouldPopFrame(char* function_name) {
-    return !isBuiltInFunction(function_name) || strcmp(function_name, "substring") == 0;
-}
-
 /**
  * @brief Vloží danú signatúru vstavanej funkcie do TS
  * @param name      Názov funkcie
@@ -157,13 +111,13 @@ void loadSingleBIFnSig(char* name, size_t count_par, char ret_type,
 
     TSData_T* fn = SymTabCreateElement(name);
     fn->type = SYM_TYPE_FUNC;
-    StrFillWith(&(fn->codename), name);
+    fn->codename = fn->id;
     fn->init = true;
     fn->let = false;
     fn->sig = SymTabCreateFuncSig();
     fn->sig->ret_type = ret_type;
     for (size_t i = 0; i < count_par; i++) {
-        DLLstr_InsertLast(&(fn->sig->par_names), par_names[i]);
+        AtomListAppend(&(fn->sig->par_names), AtomIntern(par_names[i]));
     }
     StrFillWith(&(fn->sig->par_types), par_types);
 
@@ -197,30 +151,31 @@ void loadBuiltInFunctionSignatures() {
  *      "write", "Int2Double", "Double2Int", "length", "ord", "chr"
  *
  * @brief Vygeneruje cieľovú inštrukciu príslušnej vstavanej funkcie s argumentom v cieľovom kóde
- * @param bif_name
+ * @param bif Druh atómu volanej funkcie
  * @param arg_codename
- * @return true ak bif_name je jedna z vstavaných funkcií
+ * @return true ak bif je jedna z vstavaných funkcií
  *          {"write", "Int2Double", "Double2Int", "length", "ord", "chr"},
  *          inak false
 */
-bool biFnGenInstruction(char* bif_name, char* arg_codename) {
-    if (strcmp(bif_name, "write") == 0) {
+bool biFnGenInstruction(atomKind_T bif, char* arg_codename) {
+    switch (bif) {
+    case ATOM_BIF_WRITE: {
         /*
             WRITE <arg>
         */
         genCode(INS_WRITE, arg_codename, NULL, NULL);
         return true;
     }
-    else if (strcmp(bif_name, "Int2Double") == 0) {
+    case ATOM_BIF_INT2DOUBLE: {
         /*
             PUSHS <arg>
             INT2FLOATS
         */
         genCode(INS_PUSHS, arg_codename, NULL, NULL);
-        genCode(INS_INT2FLOATS, NULL, NULL, NULL);
+        genInt2FloatS();
         return true;
     }
-    else if (strcmp(bif_name, "Double2Int") == 0) {
+    case ATOM_BIF_DOUBLE2INT: {
         /*
             PUSHS <arg>
             FLOAT2INTS
@@ -229,7 +184,7 @@ bool biFnGenInstruction(char* bif_name, char* arg_codename) {
         genCode(INS_FLOAT2INTS, NULL, NULL, NULL);
         return true;
     }
-    else if (strcmp(bif_name, "length") == 0) {
+    case ATOM_BIF_LENGTH: {
         /*
             STRLEN GF@!tmp1 <arg>
             PUSHS GF@!tmp1
@@ -238,7 +193,7 @@ bool biFnGenInstruction(char* bif_name, char* arg_codename) {
         genCode(INS_PUSHS, VAR_TMP1, NULL, NULL);
         return true;
     }
-    else if (strcmp(bif_name, "ord") == 0) {
+    case ATOM_BIF_ORD: {
         /*
             MOVE    GF@!tmp1    int@0
             STRLEN  GF@!tmp2    <arg>
@@ -249,27 +204,151 @@ bool biFnGenInstruction(char* bif_name, char* arg_codename) {
         */
         str_T label_empty_string;
         StrInit(&label_empty_string);
-        genUniqLabel(StrRead(&fn_name), "ord", &label_empty_string);
+        genUniqLabel(fn_name->text, "ord", &label_empty_string);
 
         genCode(INS_MOVE, VAR_TMP1, "int@0", NULL);
         genCode(INS_STRLEN, VAR_TMP2, arg_codename, NULL);
-        genCode("JUMPIFEQ", StrRead(&label_empty_string), VAR_TMP2, "int@0");
-        genCode("STRI2INT", VAR_TMP1, arg_codename, "int@0");
+        genCode(INS_JUMPIFEQ, StrRead(&label_empty_string), VAR_TMP2, "int@0");
+        genCode(INS_STRI2INT, VAR_TMP1, arg_codename, "int@0");
         genCode(INS_LABEL, StrRead(&label_empty_string), NULL, NULL);
         genCode(INS_PUSHS, VAR_TMP1, NULL, NULL);
         StrDestroy(&label_empty_string);
         return true;
     }
-    else if (strcmp(bif_name, "chr") == 0) {
+    case ATOM_BIF_CHR: {
         /*
             PUSHS <arg>
             INT2CHARS
         */
         genCode(INS_PUSHS, arg_codename, NULL, NULL);
-        genCode("INT2CHARS", NULL, NULL, NULL);
+        genCode(INS_INT2CHARS, NULL, NULL, NULL);
         return true;
     }
-    return false;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Pridá ASCII reťazec v tvare reťazcovej konštanty cieľového kódu (bez prefixu "string@")
+*/
+void biFnEncodeAscii(const char* text, size_t len, str_T* codename) {
+    for (size_t i = 0; i < len; i++) {
+        int c = (unsigned char)text[i];
+        if (c <= 32 || c == '#' || c == '\\') {
+            char escape[5];
+            snprintf(escape, sizeof(escape), "\\%03d", c);
+            StrCatString(codename, escape);
+        }
+        else {
+            StrAppend(codename, (char)c);
+        }
+    }
+}
+
+/**
+ * Vyhodnocuje sa iba to, čo má v interprete jednoznačný výsledok bez chyby: reťazce iba z ASCII znakov,
+ * chr v rozsahu 0..127 a Double2Int s hodnotou, ktorá sa zmestí do Int. Substring vracia nil v rovnakých
+ * prípadoch ako vygenerovaná funkcia substring (genSubstring): začiatok < 0, koniec < 0, začiatok >= dĺžka,
+ * koniec > dĺžka alebo začiatok > koniec.
+ *
+ * @brief Vypočíta volanie vstavanej funkcie s konštantnými argumentmi počas prekladu
+ * @param bif Druh atómu volanej funkcie
+ * @param argc Počet argumentov
+ * @param argv Argumenty v cieľovom kóde
+ * @param result Inicializovaný reťazec, do ktorého sa zapíše výsledok ako konštanta cieľového kódu
+ * @return true ak bol výsledok vypočítaný, inak false a volanie treba vygenerovať
+*/
+bool biFnConstEval(atomKind_T bif, size_t argc, char* argv[], str_T* result) {
+    char value[64];
+    str_T text;
+    StrInit(&text);
+    bool ok = false;
+    switch (bif) {
+    case ATOM_BIF_INT2DOUBLE:
+        if (argc != 1 || strncmp(argv[0], "int@", 4) != 0) break;
+        snprintf(value, sizeof(value), "%a", (double)strtoll(argv[0] + 4, NULL, 10));
+        StrFillWith(result, "");
+        genConstVal(DOUBLE_CONST, value, result);
+        ok = true;
+        break;
+    case ATOM_BIF_DOUBLE2INT: {
+        if (argc != 1 || strncmp(argv[0], "float@", 6) != 0) break;
+        double d = strtod(argv[0] + 6, NULL);
+        // FLOAT2INT orezáva desatinnú časť, hodnota mimo rozsahu Int je chybou interpretu
+        if (!isfinite(d) || d <= (double)LLONG_MIN || d >= (double)LLONG_MAX) break;
+        snprintf(value, sizeof(value), "int@%lld", (long long)d);
+        StrFillWith(result, value);
+        ok = true;
+        break;
+    }
+    case ATOM_BIF_LENGTH:
+    case ATOM_BIF_ORD:
+        if (argc != 1 || strncmp(argv[0], "string@", 7) != 0) break;
+        if (!decode_ascii_const(argv[0] + 7, &text)) break;
+        if (bif == ATOM_BIF_LENGTH) snprintf(value, sizeof(value), "int@%zu", strlen(StrRead(&text)));
+        else snprintf(value, sizeof(value), "int@%d", StrRead(&text)[0]); // prázdny reťazec má ord 0
+        StrFillWith(result, value);
+        ok = true;
+        break;
+    case ATOM_BIF_CHR: {
+        if (argc != 1 || strncmp(argv[0], "int@", 4) != 0) break;
+        long long code = strtoll(argv[0] + 4, NULL, 10);
+        if (code < 0 || code > 127) break;
+        char c = (char)code;
+        StrFillWith(result, "string@");
+        biFnEncodeAscii(&c, 1, result);
+        ok = true;
+        break;
+    }
+    case ATOM_BIF_SUBSTRING: {
+        if (argc != 3 || strncmp(argv[0], "string@", 7) != 0 ||
+            strncmp(argv[1], "int@", 4) != 0 || strncmp(argv[2], "int@", 4) != 0) break;
+        if (!decode_ascii_const(argv[0] + 7, &text)) break;
+        long long len = (long long)strlen(StrRead(&text));
+        long long begin = strtoll(argv[1] + 4, NULL, 10);
+        long long end = strtoll(argv[2] + 4, NULL, 10);
+        if (begin < 0 || end < 0 || begin >= len || end > len || begin > end) {
+            StrFillWith(result, "nil@nil");
+        }
+        else {
+            StrFillWith(result, "string@");
+            biFnEncodeAscii(StrRead(&text) + begin, (size_t)(end - begin), result);
+        }
+        ok = true;
+        break;
+    }
+    default:
+        break;
+    }
+    StrDestroy(&text);
+    return ok;
+}
+
+/**
+ * @brief Ak sa volanie vstavanej funkcie s argumentmi args dá vypočítať počas prekladu (biFnConstEval),
+ * vygeneruje vloženie výsledku na zásobník
+ * @return true ak bol výsledok vygenerovaný, inak false a volanie treba vygenerovať
+*/
+bool biFnConstCall(atomKind_T bif, DLLstr_T* args) {
+    str_T values[3];
+    char* argv[3];
+    size_t argc = 0;
+    for (DLLstr_First(args); DLLstr_IsActive(args); DLLstr_Next(args)) {
+        if (argc == 3) break;
+        StrInit(&values[argc]);
+        DLLstr_GetValue(args, &values[argc]);
+        argv[argc] = StrRead(&values[argc]);
+        argc++;
+    }
+
+    str_T result;
+    StrInit(&result);
+    bool evaluated = !DLLstr_IsActive(args) && biFnConstEval(bif, argc, argv, &result);
+    if (evaluated) genCode(INS_PUSHS, StrRead(&result), NULL, NULL);
+    StrDestroy(&result);
+    for (size_t i = 0; i < argc; i++) StrDestroy(&values[i]);
+    return evaluated;
 }
 
 /**
@@ -344,7 +423,7 @@ int parseTerm(char* term_type, str_T* term_codename) {
     switch (tkn->type)
     {
     case ID:; // premenná
-        TSData_T* variable = SymTabLookup(&symt, StrRead(&(tkn->atr)));
+        TSData_T* variable = SymTabLookupAtom(&symt, tkn->atom);
         if (variable == NULL) {
             // v TS nie je záznam s daným identifikátorom => nedeklarovaná premenná
             logErrSemantic(tkn, "%s was undeclared", StrRead(&(tkn->atr)));
@@ -361,7 +440,7 @@ int parseTerm(char* term_type, str_T* term_codename) {
             return SEM_ERR_UNDEF;
         }
         *term_type = variable->type;
-        StrFillWith(term_codename, StrRead(&(variable->codename)));
+        StrFillWith(term_codename, variable->codename->text);
         break;
     case INT_CONST: // konštanty
         *term_type = SYM_TYPE_INT;
@@ -398,13 +477,13 @@ int parseTerm(char* term_type, str_T* term_codename) {
  *  v ostatných prípadoch negeneruje inštrukcie, ale zapisuje argumenty v cieľovom kóde cez ukazateľ na inicializovaný zoznam.
  *
  * @brief Pravidlo pre spracovanie argumentu volanej funkcie, pričom cez svoje parametre vráti informácie o načítanom argumente.
- * @param par_name  načítaný názov parametru
+ * @param par_name  načítaný názov parametru, "_" ak bol vynechaný
  * @param term_type dátový typ termu
- * @param bif_name Ak volaná funkcia nie je vstavaná, potom NULL, inak názov vstavanej funkcie.
+ * @param bif Ak volaná funkcia nie je vstavaná, potom ATOM_ID, inak druh atómu vstavanej funkcie.
  * @param used_args Získané argumenty funkcie v cieľovom kóde.
  * @return 0 v prípade úspechu, inak číslo chyby
 */
-int parseFnArg(str_T* par_name, char* term_type, char* bif_name,
+int parseFnArg(atom_T** par_name, char* term_type, atomKind_T bif,
     DLLstr_T* used_args) {
     /*
         18. <PAR_IN> -> id : term
@@ -412,7 +491,7 @@ int parseFnArg(str_T* par_name, char* term_type, char* bif_name,
     */
     str_T arg_codename; // Tvar argumentu v cieľovom kóde
     StrInit(&arg_codename);
-    StrFillWith(par_name, StrRead(&(tkn->atr)));
+    *par_name = tkn->atom;
     switch (tkn->type)
     {
     case ID:
@@ -420,25 +499,25 @@ int parseFnArg(str_T* par_name, char* term_type, char* bif_name,
         if (tkn->type == COMMA || tkn->type == BRT_RND_R) {
             // 19. <PAR_IN> -> term
             // term je premenná a funkcia nemá názov pre parameter
-            TSData_T* variable = SymTabLookup(&symt, StrRead(par_name));
+            TSData_T* variable = SymTabLookupAtom(&symt, *par_name);
             if (variable == NULL) {
                 // v TS nie je záznam s daným identifikátorom => nedeklarovaná premenná
-                logErrSemantic(tkn, "%s was undeclared", StrRead(par_name));
+                logErrSemantic(tkn, "%s was undeclared", (*par_name)->text);
                 return SEM_ERR_UNDEF;
             }
             if (variable->type == SYM_TYPE_FUNC) {
                 // identifikátor označuje funkciu
-                logErrSemantic(tkn, "%s is a function", StrRead(par_name));
+                logErrSemantic(tkn, "%s is a function", (*par_name)->text);
                 return SEM_ERR_RETURN;
             }
             if (!(variable->init)) {
                 // premenná nebola inicializovaná
-                logErrSemantic(tkn, "%s was uninitialized", StrRead(par_name));
+                logErrSemantic(tkn, "%s was uninitialized", (*par_name)->text);
                 return SEM_ERR_UNDEF;
             }
             *term_type = variable->type;
-            StrFillWith(par_name, "_"); // funkcia má vynechaný názvo pre parameter
-            StrFillWith(&arg_codename, StrRead(&(variable->codename)));
+            *par_name = atom_underscore; // funkcia má vynechaný názvo pre parameter
+            StrFillWith(&arg_codename, variable->codename->text);
             saveToken();
         }
         // inak prvý token musí byť názov parametra
@@ -456,7 +535,7 @@ int parseFnArg(str_T* par_name, char* term_type, char* bif_name,
     case DOUBLE_CONST:
     case STRING_CONST:
     case NIL:
-        StrFillWith(par_name, "_");
+        *par_name = atom_underscore;
         TRY_OR_EXIT(parseTerm(term_type, &arg_codename));
         break;
     default:
@@ -464,11 +543,18 @@ int parseFnArg(str_T* par_name, char* term_type, char* bif_name,
         return SYN_ERR;
     }
 
+    char* arg = StrRead(&arg_codename);
+    str_T const_result; // výsledok vstavanej funkcie s konštantným argumentom
+    StrInit(&const_result);
+    if (bif != ATOM_BIF_SUBSTRING && biFnConstEval(bif, 1, &arg, &const_result)) {
+        genCode(INS_PUSHS, StrRead(&const_result), NULL, NULL);
+    }
     // generácia inštrukcií pre niektoré vstavané funkcie
-    if (!biFnGenInstruction(bif_name == NULL ? "" : bif_name, StrRead(&arg_codename))) {
+    else if (!biFnGenInstruction(bif, StrRead(&arg_codename))) {
         // inak je predaný identifikátor argumentu v cieľovom kóde naspäť volajúcemu
         DLLstr_InsertLast(used_args, StrRead(&arg_codename));
     }
+    StrDestroy(&const_result);
     StrDestroy(&arg_codename);
 
     return COMPILATION_OK;
@@ -483,12 +569,12 @@ int parseFnArg(str_T* par_name, char* term_type, char* bif_name,
  * @param defined Značí či bola funkcia definovaná
  * @param called_before Značí, či už bola daná funkcia predtým volaná
  * @param sig Signatúra funkcie, ktorá je volaná
- * @param bif_name Ak volaná funkcia nie je vstavaná, potom NULL, inak názov vstavanej funkcie.
+ * @param bif Ak volaná funkcia nie je vstavaná, potom ATOM_ID, inak druh atómu vstavanej funkcie.
  * @param used_args Získané argumenty funkcie v cieľovom kóde.
  * @return 0 v prípade úspechu, inak číslo chyby
 */
 int parseFnCallArgs(bool defined, bool called_before, func_sig_T* sig,
-    char* bif_name, DLLstr_T* used_args) {
+    atomKind_T bif, DLLstr_T* used_args) {
     /*
         13. <PAR_LIST> -> id : term <PAR_IN_NEXT>
         14. <PAR_LIST> -> term <PAR_IN_NEXT>
@@ -500,17 +586,11 @@ int parseFnCallArgs(bool defined, bool called_before, func_sig_T* sig,
     size_t loaded_args = 0; // počet načítaných argumentov
 
     char arg_type;  // typ aktuálne načítaného argumentu
-    str_T par_name, temp; // názov parametru, pomocné reťazcové úložisko
-    StrInit(&par_name);
-    StrInit(&temp);
-    DLLstr_First(&(sig->par_names));
+    atom_T *par_name; // názov parametru
 
     // Špeciálny prístup sémantickej kontroly pri vstavanej funkcii "write",
     // pretože môže mať variabilný počet argumentov.
-    bool write_function = false;
-    if (bif_name != NULL) {
-        if (strcmp(bif_name, "write") == 0) write_function = true;
-    }
+    bool write_function = bif == ATOM_BIF_WRITE;
 
     TRY_OR_EXIT(nextToken());
     while (tkn->type != BRT_RND_R)
@@ -550,11 +630,11 @@ int parseFnCallArgs(bool defined, bool called_before, func_sig_T* sig,
             }
         }
 
-        TRY_OR_EXIT(parseFnArg(&par_name, &arg_type, bif_name, used_args)); // príkaz na spracovanie jedného argumentu
+        TRY_OR_EXIT(parseFnArg(&par_name, &arg_type, bif, used_args)); // príkaz na spracovanie jedného argumentu
 
         // sémantická kontrola argumentu
         if (write_function) { // všetky argumenty vo funkcií "write" nemajú názov parametra
-            if (strcmp(StrRead(&par_name), "_") != 0) {
+            if (par_name != atom_underscore) {
                 logErrSemantic(tkn, "function \"write\" does not use parameter names");
                 return SEM_ERR_FUNC;
             }
@@ -567,8 +647,7 @@ int parseFnCallArgs(bool defined, bool called_before, func_sig_T* sig,
             }
 
             // kontrola názvu parametra s predpisom
-            DLLstr_GetValue(&(sig->par_names), &temp);
-            if (strcmp(StrRead(&par_name), StrRead(&temp)) != 0) {
+            if (par_name != sig->par_names.items[loaded_args]) {
                 logErrSemantic(tkn, "different parameter name");
                 return SEM_ERR_FUNC;
             }
@@ -597,12 +676,11 @@ int parseFnCallArgs(bool defined, bool called_before, func_sig_T* sig,
             }
 
             // zápis názvu parametru
-            DLLstr_InsertLast(&(sig->par_names), StrRead(&par_name));
+            AtomListAppend(&(sig->par_names), par_name);
         }
 
         TRY_OR_EXIT(nextToken());
         loaded_args++;
-        DLLstr_Next(&(sig->par_names));
     }
 
     if ((defined || called_before) && !write_function) { // kontrola, či bola funkcia zavolaná so správnym počtom argumentov
@@ -612,10 +690,6 @@ int parseFnCallArgs(bool defined, bool called_before, func_sig_T* sig,
         }
     }
 
-    // dealokácia pomocných reťazcov
-    StrDestroy(&par_name);
-    StrDestroy(&temp);
-
     return COMPILATION_OK;
 }
 
@@ -634,15 +708,15 @@ int parseFnCall(char* result_type) {
     // id ( <PAR_LIST> )
 
     // získanie informácii o funkcii z TS
-    TSData_T* fn = SymTabLookupGlobal(&symt, StrRead(&(tkn->atr)));
+    TSData_T* fn = SymTabLookupGlobalAtom(&symt, tkn->atom);
     bool called_before = fn != NULL;
-    bool built_in_fn = false;   // funkcia je vstavaná
+    atomKind_T bif = ATOM_ID;   // druh vstavanej funkcie, ATOM_ID ak funkcia nie je vstavaná
     if (fn == NULL) // funkcia nebola definovaná a ani volaná
     {
         // vytvorí sa o nej záznam do TS
-        fn = SymTabCreateElement(StrRead(&(tkn->atr)));
+        fn = SymTabCreateElementAtom(tkn->atom);
         if (fn == NULL) return COMPILER_ERROR;
-        StrFillWith(&(fn->codename), StrRead(&(tkn->atr)));
+        fn->codename = fn->id;
         fn->type = SYM_TYPE_FUNC;
         fn->sig = SymTabCreateFuncSig();
         if (fn->sig == NULL) {
@@ -654,10 +728,10 @@ int parseFnCall(char* result_type) {
         SymTabInsertGlobal(&symt, fn);
 
         // poznačiť názov funkcie do zoznamu nedefinovaných funkcií, pre kontrolu na koniec
-        DLLstr_InsertLast(&check_def_fns, fn->id);
+        AtomListAppend(&check_def_fns, fn->id);
     }
     else {
-        built_in_fn = isBuiltInFunction(fn->id);
+        if (ATOM_IS_BIF(fn->id->kind)) bif = fn->id->kind;
     }
 
     TRY_OR_EXIT(nextToken());
@@ -669,32 +743,46 @@ int parseFnCall(char* result_type) {
     // spracovanie argumentov funkcie
     DLLstr_T args_codenames;
     DLLstr_Init(&args_codenames);
-    TRY_OR_EXIT(parseFnCallArgs(fn->init, called_before, fn->sig, built_in_fn ? fn->id : NULL, &args_codenames));
+    TRY_OR_EXIT(parseFnCallArgs(fn->init, called_before, fn->sig, bif, &args_codenames));
 
-    if (strcmp(fn->id, "substring") == 0) {
-        // bude potrebné vložiť kód funkcie substring
-        bifn_substring_called = true;
-    }
+    // substring s konštantnými argumentmi sa vypočíta počas prekladu, so známymi hranicami sa vloží priamo
+    // do miesta volania, inak bude potrebné vložiť kód funkcie substring
+    bool evaluated = bif == ATOM_BIF_SUBSTRING &&
+        (biFnConstCall(bif, &args_codenames) || genSubstringInline(&args_codenames));
+    if (bif == ATOM_BIF_SUBSTRING && !evaluated) bifn_substring_called = true;
 
     // Generovanie cieľového kódu
-    if (!built_in_fn || strcmp(fn->id, "substring") == 0) {
+    switch (bif) {
+    case ATOM_ID:
+        // malá funkcia definovaná skôr sa vloží priamo do miesta volania
+        if (genInlineCall(fn->id->text, &args_codenames,
+            parser_inside_loop ? &variables_declared_inside_loop : NULL)) break;
+        // fall through
+    case ATOM_BIF_SUBSTRING:
+        if (evaluated) break;
         // generovanie vloženia argumentov na zásobník a volania funkcie
-        genFnCall(fn->id, &args_codenames);
-    }
+        genFnCall(fn->id->text, &args_codenames);
+        // je potrebné zbaviť sa lokálneho rámca vytvoreného volanou funkciou
+        genCode(INS_POPFRAME, NULL, NULL, NULL);
+        break;
     // špeciálne prípady generovania kódu pri týchto vstavaných funkciách
-    else if (strcmp(fn->id, "readString") == 0) {
+    case ATOM_BIF_READSTRING:
         genCode(INS_READ, VAR_TMP1, "string", NULL);
         genCode(INS_PUSHS, VAR_TMP1, NULL, NULL);
-    }
-    else if (strcmp(fn->id, "readInt") == 0) {
+        break;
+    case ATOM_BIF_READINT:
         genCode(INS_READ, VAR_TMP1, "int", NULL);
         genCode(INS_PUSHS, VAR_TMP1, NULL, NULL);
-    }
-    else if (strcmp(fn->id, "readDouble") == 0) {
+        break;
+    case ATOM_BIF_READDOUBLE:
         genCode(INS_READ, VAR_TMP1, "float", NULL);
         genCode(INS_PUSHS, VAR_TMP1, NULL, NULL);
+        break;
+    default:
+        break;
     }
     DLLstr_Dispose(&args_codenames);
+    if (stats_enabled) statsFunctionCalled(bif != ATOM_ID);
 
     *result_type = fn->sig->ret_type;
 
@@ -716,7 +804,7 @@ int parseFnCall(char* result_type) {
  * @param target_type Dátový typ premennej, ktorej je hodnota priraďovaná. Slúži len pre potreby implicitnej konverzie literálu Int na Double
  * @return 0 v prípade úspechu, inak číslo chyby
 */
-int parseAssignment(char* result_type, char* result_codename, char target_type) {
+int parseAssignment(char* result_type, atom_T* result_codename, char target_type) {
     bool possible_implicit_int_conversion = false;
     TRY_OR_EXIT(nextToken());
     token_T* first_tkn;
@@ -742,9 +830,7 @@ int parseAssignment(char* result_type, char* result_codename, char target_type)
             // 9. <ASSIGN> -> id ( <PAR_LIST> )
             saveToken();
             tkn = first_tkn;
-            bool popframe = shouldPopFrame(StrRead(&(tkn->atr))); // je potrebné zbaviť sa lokálneho rámca vytvoreného volanou funkciou
             TRY_OR_EXIT(parseFnCall(result_type));
-            if (popframe) genCode(INS_POPFRAME, NULL, NULL, NULL);
         }
         else {
             saveToken();
@@ -761,11 +847,11 @@ int parseAssignment(char* result_type, char* result_codename, char target_type)
         (target_type == SYM_TYPE_DOUBLE || target_type == SYM_TYPE_DOUBLE_NIL)) {
         // vo výraze sú celočíselné literály a výsledok má byť priradený do dátového typu Double(?)
         // musí byť vykonaná implicitná konverzia
-        genCode(INS_INT2FLOATS, NULL, NULL, NULL);
+        genInt2FloatS();
         *result_type = SYM_TYPE_DOUBLE;
     }
 
-    genCode(INS_POPS, result_codename, NULL, NULL); // priradenie výsledku do premennej
+    genCodeAtoms(INS_POPS, result_codename, NULL, NULL); // priradenie výsledku do premennej
 
     return COMPILATION_OK;
 }
@@ -796,12 +882,12 @@ int parseVariableDecl() {
     }
 
     // kontrola, či premenná s daným identifikátorom už nebola deklarovaná v tomto bloku
-    if (SymTabLookupLocal(&symt, StrRead(&(tkn->atr))) != NULL) {
+    if (SymTabLookupLocalAtom(&symt, tkn->atom) != NULL) {
         logErrSemantic(tkn, "%s is already declared in this block", StrRead(&(tkn->atr)));
         return SEM_ERR_REDEF;
     }
     // zápis novej premennej do TS
-    TSData_T* variable = SymTabCreateElement(StrRead(&(tkn->atr)));
+    TSData_T* variable = SymTabCreateElementAtom(tkn->atom);
     if (variable == NULL)
     {
         logErrCompilerMemAlloc();
@@ -813,13 +899,17 @@ int parseVariableDecl() {
     variable->type = SYM_TYPE_UNKNOWN;
 
     // Generovanie cieľového kódu
-    genUniqVar(parser_inside_fn_def ? "LF" : "GF", variable->id, &(variable->codename));
+    str_T codename;
+    StrInit(&codename);
+    genUniqVar(parser_inside_fn_def ? "LF" : "GF", variable->id->text, &codename);
+    variable->codename = AtomIntern(StrRead(&codename));
+    StrDestroy(&codename);
     if (parser_inside_loop) { // deklarácia premennej musí byť pred najvrchnejším cyklom
-        DLLstr_InsertLast(&variables_declared_inside_loop, StrRead(&(variable->codename)));
+        DLLstr_InsertLast(&variables_declared_inside_loop, variable->codename->text);
     }
     else {
         // deklarácia premennej nie je v cykle, čiže môže byť hneď zapísaná
-        genCode(INS_DEFVAR, StrRead(&(variable->codename)), NULL, NULL);
+        genCodeAtoms(INS_DEFVAR, variable->codename, NULL, NULL);
     }
 
     // ďalej musí nasledovať dátový typ alebo priradenie
@@ -835,7 +925,7 @@ int parseVariableDecl() {
         if (tkn->type == ASSIGN) {
             // 6. <INIT_VAL> -> = <ASSIGN>
             char assign_type = SYM_TYPE_UNKNOWN;
-            TRY_OR_EXIT(parseAssignment(&assign_type, StrRead(&(variable->codename)), variable->type));
+            TRY_OR_EXIT(parseAssignment(&assign_type, variable->codename, variable->type));
             variable->init = true;
 
             // kontrola výsledného typu výrazu s deklarovaným dátovým typom
@@ -853,7 +943,7 @@ int parseVariableDecl() {
             case SYM_TYPE_STRING_NIL:
                 // implicitne inicializované na nil v prípade dátového typu zahrňujúceho nil
                 variable->init = true;
-                genCode(INS_MOVE, StrRead(&(variable->codename)), "nil@nil", NULL);
+                genCode(INS_MOVE, variable->codename->text, "nil@nil", NULL);
                 break;
             default:
                 break;
@@ -862,7 +952,7 @@ int parseVariableDecl() {
         }
         break;
     case ASSIGN: // 5. <DEF_VAR> -> = <ASSIGN>
-        TRY_OR_EXIT(parseAssignment(&(variable->type), StrRead(&(variable->codename)), SYM_TYPE_UNKNOWN));
+        TRY_OR_EXIT(parseAssignment(&(variable->type), variable->codename, SYM_TYPE_UNKNOWN));
         variable->init = true;
 
         if (variable->type == SYM_TYPE_VOID) { // priradenie hodnoty z void funkcie
@@ -939,11 +1029,6 @@ int parseFunctionSignature(bool compare_and_update, func_sig_T* sig) {
     */
 
     size_t loaded_params = 0; // počet načítaných parametrov
-    DLLstr_First(&(sig->par_names));
-    DLLstr_First(&(sig->par_ids));
-
-    str_T tmp; // pomocný reťazec
-    StrInit(&tmp);
 
     TRY_OR_EXIT(nextToken());
     while (tkn->type != BRT_RND_R)
@@ -967,6 +1052,7 @@ int parseFunctionSignature(bool compare_and_update, func_sig_T* sig) {
 
         if (tkn->type == ID || tkn->type == UNDERSCORE) { // názov parametra musí byť identifikátor alebo '_'
 
+            atom_T *name = tkn->type == ID ? tkn->atom : atom_underscore;
             if (compare_and_update) { // funkcia bola volaná pred jej definíciou
                 /* Kontrola počtu parametrov s počtom argumentov v prvom volaní. */
                 if (strlen(StrRead(&(sig->par_types))) <= loaded_params) { // funkcia bola volaná s menším počtom argumentov
@@ -975,14 +1061,13 @@ int parseFunctionSignature(bool compare_and_update, func_sig_T* sig) {
                 }
 
                 /*  Treba skontrolovať názov parametra s prvým volaním. */
-                DLLstr_GetValue(&(sig->par_names), &tmp);
-                if (strcmp(StrRead(&tmp), StrRead(&(tkn->atr))) != 0) {
+                if (sig->par_names.items[loaded_params] != name) {
                     logErrSemantic(tkn, "different parameter name in definition and first call");
                     return SEM_ERR_FUNC;
                 }
             }
             else { // zápis názvu parametra do predpisu funkcie
-                DLLstr_InsertLast(&(sig->par_names), StrRead(&(tkn->atr)));
+                AtomListAppend(&(sig->par_names), name);
             }
         }
         else {
@@ -993,17 +1078,15 @@ int parseFunctionSignature(bool compare_and_update, func_sig_T* sig) {
         // nasleduje identifikátor parametra vo vnútri funkcie
         TRY_OR_EXIT(nextToken());
         if (tkn->type == ID) {
-            compare_and_update ? DLLstr_GetValue(&(sig->par_names), &tmp) : DLLstr_GetLast(&(sig->par_names), &tmp);
-
             // názov parametra a identifikátor parametra sa musia líšiť
-            if (strcmp(StrRead(&tmp), StrRead(&(tkn->atr))) == 0) {
+            if (sig->par_names.items[loaded_params] == tkn->atom) {
                 logErrSemantic(tkn, "parameter name and identifier must be different");
                 return SEM_ERR_OTHER;
             }
-            DLLstr_InsertLast(&(sig->par_ids), StrRead(&(tkn->atr)));
+            AtomListAppend(&(sig->par_ids), tkn->atom);
         }
         else if (tkn->type == UNDERSCORE) {
-            DLLstr_InsertLast(&(sig->par_ids), "_");
+            AtomListAppend(&(sig->par_ids), atom_underscore);
         }
         else {
             logErrSyntax(tkn, "parameter identifier");
@@ -1041,18 +1124,16 @@ int parseFunctionSignature(bool compare_and_update, func_sig_T* sig) {
             }
             if (type_before == SYM_TYPE_UNKNOWN) same_type = true;
             if (!same_type) {
-                logErrSemanticFn(StrRead(&fn_name), "parameter types does not correspond to previous call");
+                logErrSemanticFn(fn_name->text, "parameter types does not correspond to previous call");
                 return SEM_ERR_FUNC;
             }
-            sig->par_types.data[loaded_params] = data_type; // zapíše sa dátový typ zistení z definície
+            StrRead(&(sig->par_types))[loaded_params] = data_type; // zapíše sa dátový typ zistení z definície
         }
         else {
             StrAppend(&(sig->par_types), data_type);
         }
 
         loaded_params++;
-        DLLstr_Next(&(sig->par_names));
-        DLLstr_Next(&(sig->par_ids));
         TRY_OR_EXIT(nextToken());
     }
 
@@ -1063,22 +1144,16 @@ int parseFunctionSignature(bool compare_and_update, func_sig_T* sig) {
         }
     }
 
-    // kontrola názvov rôznych názvov a identifikátorov parametrov 
-    bool unique_names;
-    if (!listHasUniqueValues(&(sig->par_names), &unique_names)) return COMPILER_ERROR;
-    if (!unique_names) {
-        logErrSemanticFn(StrRead(&fn_name), "parameter names don't have different names");
+    // kontrola názvov rôznych názvov a identifikátorov parametrov, atómy "_" sa môžu opakovať
+    if (AtomListHasDuplicates(&(sig->par_names), atom_underscore)) {
+        logErrSemanticFn(fn_name->text, "parameter names don't have different names");
         return SEM_ERR_OTHER;
     }
-    if (!listHasUniqueValues(&(sig->par_ids), &unique_names)) return COMPILER_ERROR;
-    if (!unique_names) {
-        logErrSemanticFn(StrRead(&fn_name), "parameter identifiers don't have different names");
+    if (AtomListHasDuplicates(&(sig->par_ids), atom_underscore)) {
+        logErrSemanticFn(fn_name->text, "parameter identifiers don't have different names");
         return SEM_ERR_OTHER;
     }
 
-    // dealokácia pomocných štruktúr
-    StrDestroy(&tmp);
-
     return COMPILATION_OK;
 }
 
@@ -1107,14 +1182,14 @@ int parseFunction() {
         return SYN_ERR;
     }
 
-    TSData_T* fn = SymTabLookupGlobal(&symt, StrRead(&(tkn->atr)));
+    TSData_T* fn = SymTabLookupGlobalAtom(&symt, tkn->atom);
     bool already_called = fn != NULL; // funkcia bola volaná pred jej definíciou, pretože existuje záznam v TS
     if (fn == NULL) {
         // vytvorenie záznamu o funkcii do TS
-        fn = SymTabCreateElement(StrRead(&(tkn->atr)));
+        fn = SymTabCreateElementAtom(tkn->atom);
         if (fn == NULL) return COMPILER_ERROR;
         SymTabInsertGlobal(&symt, fn);
-        StrFillWith(&(fn->codename), StrRead(&(tkn->atr)));
+        fn->codename = fn->id;
         fn->type = SYM_TYPE_FUNC;
         fn->sig = SymTabCreateFuncSig();
         if (fn->sig == NULL) {
@@ -1134,8 +1209,9 @@ int parseFunction() {
         // v ostatných prípadoch záznam o funkcii existuje preto, lebo bola už volaná 
     }
     fn->init = true; // funkcia je odteraz definovaná
+    if (stats_enabled) statsFunctionDefined();
 
-    StrFillWith(&fn_name, fn->id); // zápis názvu aktuálne definovanej funkcie do globálnej premennej
+    fn_name = fn->id; // zápis názvu aktuálne definovanej funkcie do globálnej premennej
 
     TRY_OR_EXIT(nextToken());
     if (tkn->type != BRT_RND_L) {
@@ -1167,16 +1243,14 @@ int parseFunction() {
     // Príprava parametrov pre telo funkcie
     // parametre budú vo vlastnom lokálnom bloku TS
     SymTabAddLocalBlock(&symt);
-    DLLstr_First(&(fn->sig->par_ids));
-    str_T par_id;
-    StrInit(&par_id);
+    str_T par_codename;
+    StrInit(&par_codename);
     for (size_t i = 0; StrRead(&(fn->sig->par_types))[i] != '\0'; i++) {
-        DLLstr_GetValue(&(fn->sig->par_ids), &par_id);
-        if (strcmp(StrRead(&par_id), "_") == 0) { // parametre s identifikátorom '_' sa nepoužívajú vo vnútri funkcie
-            DLLstr_Next(&(fn->sig->par_ids));
+        atom_T *par_id = fn->sig->par_ids.items[i];
+        if (par_id == atom_underscore) { // parametre s identifikátorom '_' sa nepoužívajú vo vnútri funkcie
             continue;
         }
-        TSData_T* par = SymTabCreateElement(StrRead(&par_id));
+        TSData_T* par = SymTabCreateElementAtom(par_id);
         if (par == NULL) {
             logErrCompilerMemAlloc();
             return COMPILER_ERROR;
@@ -1188,15 +1262,15 @@ int parseFunction() {
         /*
             Ak je identifikátor parametra napr. "a", v cieľovom kóde bude mať tvar "LF@%a".
         */
-        StrFillWith(&(par->codename), "LF@");
-        StrCatString(&(par->codename), par->id);
-        StrAppend(&(par->codename), '%');
-        DLLstr_Next(&(fn->sig->par_ids));
+        StrFillWith(&par_codename, "LF@");
+        StrCatString(&par_codename, par->id->text);
+        StrAppend(&par_codename, '%');
+        par->codename = AtomIntern(StrRead(&par_codename));
     }
-    StrDestroy(&par_id);
+    StrDestroy(&par_codename);
 
     // vygenerovanie inštrukcií začiatku funkcie (náveštie, deklarácie parametrov a ich inicializácia)
-    genFnDefBegin(StrRead(&fn_name), &(fn->sig->par_ids));
+    genFnDefBegin(fn_name->text, &(fn->sig->par_ids));
 
     // Spracovanie tela funkcie
     SymTabAddLocalBlock(&symt);
@@ -1206,10 +1280,10 @@ int parseFunction() {
     }
     // kontrola, či funkcia s návratovou hodnotou má všade kde je to treba, príkaz return
     if (!SymTabCheckLocalReturn(&symt) && fn->sig->ret_type != SYM_TYPE_VOID) {
-        logErrSemanticFn(fn->id, "it is possible to exit function without return value");
+        logErrSemanticFn(fn->id->text, "it is possible to exit function without return value");
         return SEM_ERR_FUNC;
     }
-    if (!SymTabCheckLocalReturn(&symt)) {
+    if (!SymTabCheckLocalReturn(&symt) && !genTailCall(fn_name->text, &(fn->sig->par_ids))) {
         // aj void-funkcia musí mať na konci inštrukciu RETURN, pre vrátenie riadenie programu
         genCode(INS_RETURN, NULL, NULL, NULL);
     }
@@ -1217,8 +1291,9 @@ int parseFunction() {
 
     SymTabRemoveLocalBlock(&symt); // odstránenie lokálneho bloku s parametrami
 
+    genFnDefEnd();
     parser_inside_fn_def = code_inside_fn_def;
-    StrFillWith(&fn_name, "");
+    fn_name = AtomIntern("");
     return COMPILATION_OK;
 }
 
@@ -1230,6 +1305,8 @@ int parseFunction() {
  * Generuje cieľový kód:
  *      { kód vygenerovaný v funkcii parseExpression }
  *      RETURN
+ * Ak return iba vracia výsledok rekurzívneho volania, namiesto volania a RETURN sa vygeneruje
+ * skok na začiatok tela funkcie, viď. genTailCall.
  *
  * @brief Pravidlo pre spracovanie vrátenia návratovej hodnoty funkcie - return
  * @return 0 v prípade úspechu, inak číslo chyby
@@ -1248,7 +1325,7 @@ int parseReturn() {
     switch (tkn->type)
     {
     case ID:; // id môže byť začiatok výrazu alebo sa za return môže nachádzať volanie funkcie
-        TSData_T* id_data = SymTabLookup(&symt, StrRead(&(tkn->atr)));
+        TSData_T* id_data = SymTabLookupAtom(&symt, tkn->atom);
         if (id_data == NULL) { // za return je funkcia, ktorá nebola ešte volaná
             saveToken();
             result_type = SYM_TYPE_VOID;
@@ -1281,35 +1358,38 @@ int parseReturn() {
     }
 
     // získanie informácii o predpise aktuálnej funkcie
-    TSData_T* fn = SymTabLookupGlobal(&symt, StrRead(&fn_name));
+    TSData_T* fn = SymTabLookupGlobalAtom(&symt, fn_name);
 
     if (fn->sig->ret_type == SYM_TYPE_VOID) { // vo vnútri void funkcie
         if (result_type != SYM_TYPE_VOID) { // void funkcia nesmie vraciať hodnotu
-            logErrSemanticFn(fn->id, "void function returns a value");
+            logErrSemanticFn(fn->id->text, "void function returns a value");
             return SEM_ERR_RETURN;
         }
     }
     else { // funkcia má vraciať hodnotu
         if (result_type == SYM_TYPE_VOID) { // return nič nevracia
-            logErrSemanticFn(fn->id, "void return in non-void function");
+            logErrSemanticFn(fn->id->text, "void return in non-void function");
             return SEM_ERR_RETURN;
         }
         if (possible_implicit_int_conversion && result_type == SYM_TYPE_INT &&
             (fn->sig->ret_type == SYM_TYPE_DOUBLE || fn->sig->ret_type == SYM_TYPE_DOUBLE_NIL)) {
             // vo výraze sú celočíselné literály a výsledok má byť priradený do dátového typu Double(?)
             // musí byť vykonaná implicitná konverzia
-            genCode(INS_INT2FLOATS, NULL, NULL, NULL);
+            genInt2FloatS();
             result_type = SYM_TYPE_DOUBLE;
         }
         if (!isCompatibleAssign(fn->sig->ret_type, result_type)) { // návratový typ nesedí s predpisom funkcie
-            logErrSemanticFn(fn->id, "different return type");
+            logErrSemanticFn(fn->id->text, "different return type");
             return SEM_ERR_FUNC;
         }
     }
 
     SymTabModifyLocalReturn(&symt, true); // zapísať informáciu o prítomnosti return v aktuálnom bloku
 
-    genCode(INS_RETURN, NULL, NULL, NULL); // vloženie inštrukcie RETURN
+    // rekurzívne volanie tesne pred return sa nahradí skokom na začiatok funkcie
+    if (!genTailCall(fn_name->text, &(fn->sig->par_ids))) {
+        genCode(INS_RETURN, NULL, NULL, NULL); // vloženie inštrukcie RETURN
+    }
 
     return COMPILATION_OK;
 }
@@ -1320,7 +1400,7 @@ int parseReturn() {
  *  - po volaní:    BRT_CUR_R
  *
  * Generuje cieľový kód podmieneného bloku kódu:
- *      JUMPIFEQ/S  <if&XX!>
+ *      JUMPIFxx    <if&XX!>        (pri nesplnení podmienky, parseCondition)
  *      ... { kód pre if } ...
  *      JUMP        <if&XX*>
  *      LABEL       <if&XX!>
@@ -1339,7 +1419,7 @@ int parseIf() {
     StrInit(&cond_false);
     StrInit(&skip_cond_false);
 
-    genUniqLabel(StrRead(&fn_name), "if", &cond_false);
+    genUniqLabel(fn_name->text, "if", &cond_false);
     StrFillWith(&skip_cond_false, StrRead(&(cond_false)));
     StrAppend(&cond_false, '!');
     StrAppend(&skip_cond_false, '*');
@@ -1353,7 +1433,7 @@ int parseIf() {
             logErrSyntax(tkn, "identifier");
             return SYN_ERR;
         }
-        TSData_T* variable = SymTabLookup(&symt, StrRead(&(tkn->atr))); // informácie o premennej
+        TSData_T* variable = SymTabLookupAtom(&symt, tkn->atom); // informácie o premennej
         if (variable == NULL) { // premenná nebola deklarovaná
             logErrSemantic(tkn, "%s was undeclared", StrRead(&(tkn->atr)));
             return SEM_ERR_UNDEF;
@@ -1373,7 +1453,7 @@ int parseIf() {
 
         // premenná musí byť v samostatnom bloku, kde bude jej typ zmenený na typ nezahrňujúci nil
         SymTabAddLocalBlock(&symt);
-        let_variable = SymTabCreateElement(StrRead(&(tkn->atr)));
+        let_variable = SymTabCreateElementAtom(tkn->atom);
         if (let_variable == NULL)
         {
             return COMPILER_ERROR;
@@ -1382,11 +1462,11 @@ int parseIf() {
         let_variable->let = variable->let;
         let_variable->sig = NULL;
         let_variable->type = convertNilTypeToNonNil(variable->type);
-        StrFillWith(&(let_variable->codename), StrRead(&(variable->codename)));
+        let_variable->codename = variable->codename;
 
         SymTabInsertLocal(&symt, let_variable);
 
-        genCode("JUMPIFEQ", StrRead(&cond_false), StrRead(&(variable->codename)), "nil@nil");
+        genCode(INS_JUMPIFEQ, StrRead(&cond_false), variable->codename->text, "nil@nil");
         break;
     case ID:;    // v podminke je obyčajný výraz
     case BRT_RND_L:;
@@ -1396,15 +1476,11 @@ int parseIf() {
     case NIL:;
         // 36. <COND> -> exp
         char exp_type = SYM_TYPE_UNKNOWN; // ???
-        bool possible_implicit_int_conversion = false; // nie je využívané v if
-        TRY_OR_EXIT(parseExpression(&exp_type, &possible_implicit_int_conversion));
+        TRY_OR_EXIT(parseCondition(&exp_type, StrRead(&cond_false))); // pri nesplnení skok na cond_false
         if (exp_type != SYM_TYPE_BOOL && exp_type != SYM_TYPE_UNKNOWN) {
             logErrSemantic(tkn, "condition must return a bool");
             return SEM_ERR_TYPE;
         }
-        // na vrchole zásobníka je bool@true alebo bool@false
-        genCode(INS_PUSHS, "bool@false", NULL, NULL);
-        genCode(INS_JUMPIFEQS, StrRead(&cond_false), NULL, NULL);
         break;
     default:;
         logErrSyntax(tkn, "let or an expression");
@@ -1451,13 +1527,21 @@ int parseIf() {
  *
  * Generuje cieľový kód cyklu:
  *      LABEL   <while&XX>
- *      PUSHS   <výsledok podmienky>
- *      PUSHS   bool@false
- *      JUMPIFEQS <while&XX!>
+ *      ... { skok na <while&XX!> pri nesplnení podmienky, parseCondition } ...
  *      ... { kód cyklu } ...
  *      JUMP    <while&XX>
  *      LABEL   <while&XX!>
  *
+ * Pri parser_rotate_loops sa podmienka otestuje raz pred vstupom do cyklu a ďalej vždy za
+ * telom cyklu, iterácia tak nevykoná nepodmienený skok:
+ *      ... { skok na <while&XX!> pri nesplnení podmienky, parseLoopCondition } ...
+ *      LABEL   <while&XX>
+ *      ... { kód cyklu } ...
+ *      ... { skok na <while&XX> pri splnení podmienky, parseLoopCondition } ...
+ *      LABEL   <while&XX!>
+ * Kód testu za telom sa vygeneruje spolu s testom pred cyklom a pripojí sa až za kód tela
+ * (genCodePaste). Miesto pre definície premenných cyklu ostáva pred celým cyklom.
+ *
  * @brief Pravidlo pre spracovanie cyklu while
  * @return 0 v prípade úspechu, inak číslo chyby
 */
@@ -1468,14 +1552,15 @@ int parseWhile() {
     StrInit(&loop_start);
     StrInit(&loop_end);
 
-    genUniqLabel(StrRead(&fn_name), "while", &loop_start);
+    genUniqLabel(fn_name->text, "while", &loop_start);
     StrFillWith(&loop_end, StrRead(&(loop_start)));
     StrAppend(&loop_end, '!');
-    genCode(INS_LABEL, StrRead(&loop_start), NULL, NULL);
-
     bool loop_inside_loop = parser_inside_loop; // cyklus v cykle
     if (!loop_inside_loop) {
-        StrFillWith(&first_loop_label, StrRead(&loop_start));
+        first_loop_slot = genLoopHoistSlot();
+    }
+    if (!parser_rotate_loops) {
+        genCode(INS_LABEL, StrRead(&loop_start), NULL, NULL);
     }
     parser_inside_loop = true;
 
@@ -1496,25 +1581,34 @@ int parseWhile() {
     }
 
     char exp_type = SYM_TYPE_UNKNOWN; // ???
-    bool possible_implicit_int_conversion = false; // nie je využívané vo while
-    TRY_OR_EXIT(parseExpression(&exp_type, &possible_implicit_int_conversion));
+    codeBlock_T bottom_test = {NULL, 0, 0, 0, 0, false}; // test podmienky za telom rotovaného cyklu
+    if (parser_rotate_loops) {
+        TRY_OR_EXIT(parseLoopCondition(&exp_type, StrRead(&loop_end), StrRead(&loop_start), &bottom_test));
+        genCode(INS_LABEL, StrRead(&loop_start), NULL, NULL);
+    }
+    else {
+        TRY_OR_EXIT(parseCondition(&exp_type, StrRead(&loop_end))); // pri nesplnení skok za cyklus
+    }
     if (exp_type != SYM_TYPE_BOOL && exp_type != SYM_TYPE_UNKNOWN) {
         logErrSemantic(tkn, "condition must return a bool");
         return SEM_ERR_TYPE;
     }
-    genCode(INS_PUSHS, "bool@false", NULL, NULL);
-    genCode(INS_JUMPIFEQS, StrRead(&loop_end), NULL, NULL);
 
     TRY_OR_EXIT(nextToken());
     TRY_OR_EXIT(parseStatBlock(NULL));
 
-    genCode(INS_JUMP, StrRead(&loop_start), NULL, NULL);
+    if (parser_rotate_loops) {
+        genCodePaste(&bottom_test); // pri splnení podmienky skok na začiatok tela cyklu
+    }
+    else {
+        genCode(INS_JUMP, StrRead(&loop_start), NULL, NULL);
+    }
     genCode(INS_LABEL, StrRead(&loop_end), NULL, NULL);
 
     parser_inside_loop = loop_inside_loop;
     if (!parser_inside_loop) { // najvrchnejší cyklus bol opustený
         // inštrukcie pre definície premenných vo vnútri cyklu musia byť vložené pred samotným cyklom
-        genDefVarsBeforeLoop(StrRead(&first_loop_label), &variables_declared_inside_loop);
+        genDefVarsBeforeLoop(first_loop_slot, &variables_declared_inside_loop);
         DLLstr_Dispose(&variables_declared_inside_loop);
     }
 
@@ -1561,8 +1655,12 @@ bool isCompatibleAssign(char dest, char src) {
 
 int nextToken() {
     if (tkn != NULL) destroyToken(tkn);
+    TIMER_BEGIN(TIMER_SCAN);
     tkn = getToken();
+    TIMER_END();
     if (tkn == NULL) return COMPILER_ERROR;
+    if (stats_enabled && !tkn_saved) statsToken(tkn->type);
+    tkn_saved = false;
     logErrUpdateTokenInfo(tkn);
     if (tkn->type == INVALID) {
         logErrCodeAnalysis(LEX_ERR, tkn->ln, tkn->col, "invalid token");
@@ -1572,6 +1670,7 @@ int nextToken() {
 }
 
 void saveToken() {
+    tkn_saved = true;
     storeToken(tkn);
     tkn = NULL;
 }
@@ -1581,19 +1680,22 @@ bool initializeParser() {
 
     loadBuiltInFunctionSignatures();
 
-    StrInit(&fn_name);
+    fn_name = AtomIntern("");
+    atom_underscore = AtomIntern("_");
 
-    DLLstr_Init(&check_def_fns);
+    AtomListInit(&check_def_fns);
 
-    StrInit(&first_loop_label);
     DLLstr_Init(&variables_declared_inside_loop);
 
-    DLLstr_Init(&code_fn);
-    DLLstr_Init(&code_main);
+    genInit();
+    genMark(&main_mark);
     return true;
 }
 
-int parse() {
+/**
+ * @brief Spracovanie základného príkazu podľa jeho prvého tokenu, viď. parse
+*/
+static int parseStatement() {
     switch (tkn->type)
     {
     case LET:;
@@ -1611,14 +1713,12 @@ int parse() {
             // 12. <STAT> -> id ( <PAR_LIST> ) <STAT>
             saveToken();
             tkn = first_tkn;
-            bool popframe = shouldPopFrame(StrRead(&(tkn->atr)));
             TRY_OR_EXIT(parseFnCall(&result_type));
-            if (popframe) genCode(INS_POPFRAME, NULL, NULL, NULL);
             genCode(INS_CLEARS, NULL, NULL, NULL); // volaná funkcia môže zanechať návratovú hodnotu na zásobníku
         }
         else if (tkn->type == ASSIGN) {
             // 10. <STAT> -> id = <ASSIGN> <STAT>
-            TSData_T* variable = SymTabLookup(&symt, StrRead(&(first_tkn->atr)));
+            TSData_T* variable = SymTabLookupAtom(&symt, first_tkn->atom);
             if (variable == NULL) {
                 // v TS nie je záznam s daným identifikátorom => nedeklarovaná premenná
                 logErrSemantic(first_tkn, "%s was undeclared", StrRead(&(first_tkn->atr)));
@@ -1629,7 +1729,7 @@ int parse() {
                 logErrSemantic(first_tkn, "%s is unmodifiable and was already initialised", StrRead(&(first_tkn->atr)));
                 return SEM_ERR_OTHER;
             }
-            TRY_OR_EXIT(parseAssignment(&result_type, StrRead(&(variable->codename)), variable->type));
+            TRY_OR_EXIT(parseAssignment(&result_type, variable->codename, variable->type));
             if (!isCompatibleAssign(variable->type, result_type)) {
                 // nekompatibilný typ výsledku a premennej
                 logErrSemantic(first_tkn, "incompatible data types");
@@ -1674,40 +1774,111 @@ int parse() {
     return COMPILATION_OK;
 }
 
+/**
+ * @brief Fáza merania času pre príkaz začínajúci tokenom type
+*/
+static timerPhase_T parseStatementPhase(int type) {
+    switch (type) {
+    case LET:
+    case VAR: return TIMER_STAT_DECL;
+    case BRT_CUR_L: return TIMER_STAT_BLOCK;
+    case FUNC: return TIMER_STAT_FUNC;
+    case RETURN: return TIMER_STAT_RETURN;
+    case IF: return TIMER_STAT_IF;
+    case WHILE: return TIMER_STAT_WHILE;
+    default: return TIMER_STAT_ID;
+    }
+}
+
+int parse() {
+    if (!timer_enabled) return parseStatement();
+    timerBegin(parseStatementPhase(tkn->type));
+    int result = parseStatement();
+    timerEnd();
+    return result;
+}
+
 int checkIfAllFnDef() {
-    DLLstr_First(&check_def_fns);
-    while (DLLstr_IsActive(&check_def_fns))
-    {
-        DLLstr_GetValue(&check_def_fns, &fn_name);
-        TSData_T* fn_info = SymTabLookupGlobal(&symt, StrRead(&fn_name));
+    for (size_t i = 0; i < check_def_fns.used; i++) {
+        TSData_T* fn_info = SymTabLookupGlobalAtom(&symt, check_def_fns.items[i]);
         if (!fn_info->init) {
-            logErrSemanticFn(StrRead(&fn_name), "was not defined");
+            logErrSemanticFn(check_def_fns.items[i]->text, "was not defined");
             return SEM_ERR_REDEF;
         }
-        DLLstr_Next(&check_def_fns);
     }
     return COMPILATION_OK;
 }
 
+void streamMainBody() {
+    if (parser_stream_limit == 0 || parser_inside_loop || parser_inside_fn_def) return;
+    if (code_main.used < parser_stream_limit) return;
+    TIMER_BEGIN(TIMER_OPTIMIZE);
+    main_dce_removed += optDeadCode(&code_main);
+    optPeephole(&code_main);
+    TIMER_END();
+    TIMER_BEGIN(TIMER_EMIT);
+    emitSpillBegin();
+    genPrintBlock(&code_main);
+    emitSpillEnd();
+    TIMER_END();
+    code_main.used = 0; // pole inštrukcií sa ponechá pre ďalšie príkazy
+    // mená náveští, konštánt a premenných odloženého kódu už nie sú potrebné
+    genRelease(&main_mark);
+    genMark(&main_mark);
+}
+
 void printOutCompiledCode() {
-    printf(".IFJcode23\n"); // povinná hlavička
+    // dogenerovať inštrukcie pre vstavanú funkciu substring pokiaľ bola použitá
+    if (bifn_substring_called) genSubstring();
 
-    // pomocné premenné
-    printf("DEFVAR %s\n", VAR_TMP1);
-    printf("DEFVAR %s\n", VAR_TMP2);
-    printf("DEFVAR %s\n", VAR_TMP3);
+    // optimalizácie prebehnú pred výpisom, aby emitReport meral iba výpis
+    TIMER_BEGIN(TIMER_OPTIMIZE);
+    size_t estimate = 0; // odhad veľkosti výstupu, riadok kódu má v priemere menej ako 32 bajtov
+    for (size_t i = 0; i < code_fn.used; i++) {
+        codeBlock_T *block = &(code_fn.blocks[i]);
+        size_t removed = optDeadCode(block);
+        if (opt_dce_report && block->used > 0 && block->ins[0].code == INS_LABEL) {
+            fprintf(stderr, "dce: %s removed %zu instructions\n", genOperandText(&block->ins[0].op[0]), removed);
+        }
+        optPeephole(block);
+        estimate += block->used;
+    }
+    size_t removed = main_dce_removed + optDeadCode(&code_main);
+    if (opt_dce_report) fprintf(stderr, "dce: !main removed %zu instructions\n", removed);
+    optPeephole(&code_main);
+    estimate += code_main.used;
+    TIMER_END();
 
-    printf("JUMP !main\n"); // skok do hlavného tela programu
+    TIMER_BEGIN(TIMER_EMIT);
+    emitReserve(estimate * 32 + emitSpillBytes());
 
-    // dogenerovať inštrukcie pre vstavanú funkciu substring pokiaľ bola použitá
-    if (bifn_substring_called) genSubstring();
+    emitString(".IFJcode23\n"); // povinná hlavička
+
+    // pomocné premenné
+    const char *tmp_vars[] = { VAR_TMP1, VAR_TMP2, VAR_TMP3, VAR_COND };
+    for (size_t i = 0; i < sizeof(tmp_vars) / sizeof(tmp_vars[0]); i++) {
+        emitString("DEFVAR ");
+        emitString(tmp_vars[i]);
+        emitText("\n", 1);
+    }
+    for (int i = 0; i < genExpTempCount(); i++) { // medzivýsledky výrazov
+        emitString("DEFVAR ");
+        emitString(genExpTemp(i)->text);
+        emitText("\n", 1);
+    }
+
+    emitString("JUMP !main\n"); // skok do hlavného tela programu
 
-    DLLstr_printContent(&code_fn); // kód uživateľských funkcií
+    // kód uživateľských funkcií
+    for (size_t i = 0; i < code_fn.used; i++) genPrintBlock(&(code_fn.blocks[i]));
 
     // hlavné telo programu
-    printf("LABEL !main\n");
-    DLLstr_printContent(&code_main);
-    printf("EXIT int@0\n");
+    emitString("LABEL !main\n");
+    emitSpillCopy(); // už odložená časť hlavného tela
+    genPrintBlock(&code_main);
+    emitString("EXIT int@0\n");
+    emitFlush();
+    TIMER_END();
 }
 
 void destroyParser() {
@@ -1715,16 +1886,15 @@ void destroyParser() {
         destroyToken(tkn);
         tkn = NULL;
     }
+    destroyScanner();
     SymTabDestroy(&symt);
 
-    StrDestroy(&fn_name);
-    DLLstr_Dispose(&check_def_fns);
+    AtomListDestroy(&check_def_fns);
 
-    StrDestroy(&first_loop_label);
     DLLstr_Dispose(&variables_declared_inside_loop);
 
-    DLLstr_Dispose(&code_main);
-    DLLstr_Dispose(&code_fn);
+    genDestroy();
+    AtomPoolDestroy();
 }
 
 /* Koniec súboru parser.c */
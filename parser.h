@@ -52,6 +52,20 @@ extern SymTab_T symt;
 */
 extern bool parser_inside_fn_def;
 
+/**
+ * @brief Cykly while sa generujú s podmienkou za telom cyklu (prepínač --rotate-loops)
+ * @details Každá iterácia tak ušetrí nepodmienený skok, viď. parseWhile.
+*/
+extern bool parser_rotate_loops;
+
+#define PARSER_STREAM_LIMIT 0 ///< predvolená hodnota parser_stream_limit, odkladanie zapína až --stream=N
+
+/**
+ * @brief Počet inštrukcií hlavného tela, po ktorom sa hotový kód odloží mimo pamäť (0 odkladanie vypína)
+ * @details Viď. streamMainBody, prepínač --stream=N.
+*/
+extern size_t parser_stream_limit;
+
 /**
  * @brief Zistí kompatibilitu priradenia dvoch typov
  * @param dest dátový typ cieľa
@@ -94,7 +108,17 @@ int parse();
 int checkIfAllFnDef();
 
 /**
- * @brief Vypíše na stdout vygenerovaný IFJcode23.
+ * Volá sa po každom príkaze na najvyššej úrovni. Mimo cyklu je kód hlavného tela hotový (definície premenných
+ * z cyklov sú už doplnené), takže keď ho je aspoň parser_stream_limit inštrukcií, prebehnú nad ním optimalizácie
+ * a jeho text sa zapíše do odkladacieho súboru (emitSpillBegin). Náveštia, ktoré odložený kód pridal do tabuľky
+ * náveští generátora, sa uvoľnia (genRelease). V pamäti tak zostáva iba kód funkcií a rozpracovaný príkaz.
+ *
+ * @brief Odloží hotový kód hlavného tela do odkladacieho súboru
+*/
+void streamMainBody();
+
+/**
+ * @brief Vypíše vygenerovaný IFJcode23 cez emit.h (stdout alebo súbor z emitOpen).
 */
 void printOutCompiledCode();
 
@@ -15,6 +15,8 @@
 #include <stdbool.h>
 #include <string.h>
 #include "scanner.h"
+#include "srcBuf.h"
+#include "mem.h"
 
 #define END_OF_MULTILINE_STRING 3 //Počet uvozovek které jsou třeba k uknčení víceřádkového řetězce
 
@@ -49,61 +51,158 @@ typedef enum state {
     NESTED_COMMENT_S
 } state_t;
 
-///< úschovňa pre jeden token
+///< úschovňa pre jeden token vrátený parserom, namiesto posunu kurzora srcBuf späť (viď. storeToken)
 token_T *storage = NULL; 
 
+#define TOKEN_SLAB_SIZE 256              //Počet tokenů v jednom slabu
+#define TOKEN_ARENA_BLOCK_SIZE 65536     //Minimální velikost bloku arény pro atributy tokenů
+
+//Slab - pole tokenů alokované najednou
+typedef struct token_slab {
+    struct token_slab *next;
+    token_T tokens[TOKEN_SLAB_SIZE];
+} tokenSlab_T;
+
+//Blok arény, do kterého se postupně ukládají atributy tokenů
+typedef struct token_arena_block {
+    struct token_arena_block *next;
+    size_t size;    //velikost bloku data
+    size_t used;    //počet obsazených bajtů
+    char data[];
+} tokenArenaBlock_T;
+
+//Aréna skeneru - vlastní všechny tokeny a jejich atributy
+static struct {
+    tokenSlab_T *slabs;             //seznam slabů, první je aktuálně plněný
+    size_t slab_used;               //počet použitých tokenů v aktuálním slabu
+    token_T **free;                 //zásobník recyklovaných tokenů
+    size_t free_used;
+    size_t free_size;
+    tokenArenaBlock_T *blocks;      //první blok arény atributů
+    tokenArenaBlock_T *current;     //blok, do kterého se aktuálně alokuje
+    size_t live;                    //počet tokenů, které ještě nebyly zrušeny
+    str_T lexeme;                   //pracovní řetězec, do kterého se čte atribut tokenu
+    unsigned long lexeme_hash;      //StrHash pracovního řetězce, počítaný při přidávání znaků
+    bool lexeme_ready;
+} tkn_arena;
+
 /**
- * @brief Převede řetězec, který odpovídá klíčovému slovu na odpovídající token id. Tedy funkce slouží jako tabulka klíčových slov
+ * @brief Převede druh atomu, který odpovídá klíčovému slovu, na odpovídající token id.
+ * Druh atomu se určí jediný raz při jeho vytvoření, tabulka klíčových slov je tedy v atom.c
  * 
- * @param string 
- * @return int, 0 pokud string neodpovídá žádnému klíčovému slovu
+ * @param kind druh atomu
+ * @return int, 0 pokud atom neodpovídá žádnému klíčovému slovu
  */
-int keyw_token_num(char * string) {
-    if (strcmp(string, "Double") == 0) {
-        return DOUBLE_TYPE;
-    } else if (strcmp(string, "else") == 0) {
-        return ELSE;
-    } else if (strcmp(string, "func") == 0) {
-        return FUNC;
-    } else if (strcmp(string, "if") == 0) {
-        return IF;
-    } else if (strcmp(string, "Int") == 0) {
-        return INT_TYPE;
-    } else if (strcmp(string, "let") == 0) {
-        return LET;
-    } else if (strcmp(string, "var") == 0) {
-        return VAR;
-    } else if (strcmp(string, "nil") == 0) {
-        return NIL;
-    } else if (strcmp(string, "return") == 0) {
-        return RETURN;
-    } else if (strcmp(string, "String") == 0) {
-        return STRING_TYPE;
-    } else if (strcmp(string, "while") == 0) {
-        return WHILE;
+static int keyw_token_num(atomKind_T kind) {
+    switch (kind) {
+    case ATOM_KW_DOUBLE: return DOUBLE_TYPE;
+    case ATOM_KW_ELSE: return ELSE;
+    case ATOM_KW_FUNC: return FUNC;
+    case ATOM_KW_IF: return IF;
+    case ATOM_KW_INT: return INT_TYPE;
+    case ATOM_KW_LET: return LET;
+    case ATOM_KW_VAR: return VAR;
+    case ATOM_KW_NIL: return NIL;
+    case ATOM_KW_RETURN: return RETURN;
+    case ATOM_KW_STRING: return STRING_TYPE;
+    case ATOM_KW_WHILE: return WHILE;
+    default: return 0;
+    }
+}
+
+/**
+ * @brief Vrátí blok arény s alespoň n volnými bajty, případně alokuje nový
+ * 
+ * @param n požadovaný počet bajtů
+ * @return blok arény
+ */
+static tokenArenaBlock_T *arena_block_for(size_t n) {
+    tokenArenaBlock_T *block = tkn_arena.current;
+    //Nejdříve se zkusí znovu použít bloky, které zůstaly po posledním uvolnění arény
+    while (block != NULL && block->size - block->used < n) {
+        block = block->next;
+        if (block != NULL) block->used = 0;
+    }
+    if (block != NULL) {
+        tkn_arena.current = block;
+        return block;
+    }
+
+    size_t size = n > TOKEN_ARENA_BLOCK_SIZE ? n : TOKEN_ARENA_BLOCK_SIZE;
+    block = memMalloc(MEM_SCANNER, sizeof(tokenArenaBlock_T) + size);
+    if (block == NULL) {
+        fprintf(stderr, "arena_block_for() memory allocation error.\n");
+        exit(99);
+    }
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    if (tkn_arena.current == NULL) {
+        tkn_arena.blocks = block;
+    } else {
+        //nový blok se zařadí hned za aktuální, zbylé volné bloky zůstanou za ním
+        block->next = tkn_arena.current->next;
+        tkn_arena.current->next = block;
     }
-    return 0;
+    tkn_arena.current = block;
+    return block;
+}
+
+/**
+ * @brief Zkopíruje řetězec do arény atributů tokenů
+ * 
+ * @param src zdrojový řetězec
+ * @param len délka řetězce bez ukončovací nuly
+ * @return ukazatel na kopii v aréně
+ */
+static char *arena_strdup(const char *src, size_t len) {
+    tokenArenaBlock_T *block = arena_block_for(len + 1);
+    char *dest = block->data + block->used;
+    memcpy(dest, src, len + 1);
+    block->used += len + 1;
+    return dest;
 }
 
 /**
  * @brief Inicializuje strukturu token
+ * @details Token se vezme ze seznamu recyklovaných tokenů, případně z aktuálního slabu.
+ * Pokud neexistuje žádný živý token, uvolní se hromadně celá aréna atributů.
  * 
  * @param token token
  * @return ukazatel na token 
  */
 token_T* init_token(token_T **token) {
-    //alokace pameti pro token
-    *token = malloc(sizeof(token_T));
+    if (tkn_arena.live == 0 && tkn_arena.blocks != NULL) {
+        //Žádný atribut už není používán, aréna se může použít znovu od začátku
+        tkn_arena.current = tkn_arena.blocks;
+        tkn_arena.current->used = 0;
+    }
 
-    //alokace paměti pro token se nepovedla, vrať false
-    if (*token == NULL) {
-        return NULL;
-    } 
+    if (tkn_arena.free_used > 0) {
+        //recyklovaný token
+        *token = tkn_arena.free[--tkn_arena.free_used];
+    } else {
+        if (tkn_arena.slabs == NULL || tkn_arena.slab_used == TOKEN_SLAB_SIZE) {
+            //alokace nového slabu tokenů
+            tokenSlab_T *slab = memMalloc(MEM_SCANNER, sizeof(tokenSlab_T));
+            //alokace paměti pro slab se nepovedla, vrať NULL
+            if (slab == NULL) {
+                *token = NULL;
+                return NULL;
+            }
+            slab->next = tkn_arena.slabs;
+            tkn_arena.slabs = slab;
+            tkn_arena.slab_used = 0;
+        }
+        *token = &tkn_arena.slabs->tokens[tkn_arena.slab_used++];
+    }
+    tkn_arena.live++;
 
     //Inicializace struktury
     (*token)->type = INVALID;
     (*token)->ln = 0;
     (*token)->col = 0;
+    (*token)->atom = NULL;
 
     return *token;
 }
@@ -186,7 +285,7 @@ int escape_seq_process(char c) {
 }
 /**
  * @brief Funkce vypočítá výsledné odsazení nejbližší trojice uvozovek od místa použití funkce
- *          Funkce navrátí ukazatel do souboru na místo, odkud byla použita
+ *          Znaky se pouze nahlížejí ve vstupním bufferu, kurzor zůstává na místě, odkud byla použita
  * 
  * @return odsazení první nalezené """
  */
@@ -195,16 +294,10 @@ int get_indentation() {
     int indent = 0;
     bool possibility_to_find = true;
     int num_of_quotes = 0;
-    int num_of_readed_characters = 0;
+    size_t offset = 0; // vzdialenosť nahliadnutého znaku od kurzora, kurzor sa neposúva
     
-    // Čtení znaků ze vstupu a hledání prvních trojitých uvozovek
-    while ((c = fgetc(stdin)) != EOF) {
-        if (c == EOF) {
-            indent = 0;
-            break;
-        }
-    num_of_readed_characters++;
-      
+    // Nahliadanie na znaky vstupu a hledání prvních trojitých uvozovek
+    while ((c = SrcBufPeek(offset++)) != EOF) {
       if (isblank(c)) {
         if (possibility_to_find == true)
             indent++;
@@ -216,12 +309,10 @@ int get_indentation() {
             
             num_of_quotes = 1;
 
-            while ((c = fgetc(stdin)) == '"') {
+            while ((c = SrcBufPeek(offset++)) == '"') {
                 num_of_quotes++;
             }
 
-            num_of_readed_characters += num_of_quotes;
-
             if (num_of_quotes == END_OF_MULTILINE_STRING) {
                 break;
             } else {
@@ -235,7 +326,6 @@ int get_indentation() {
         indent = 0;
       }
     }
-    fseek(stdin, -num_of_readed_characters, SEEK_CUR);
     return indent + 1;
 }
 
@@ -263,6 +353,8 @@ token_T *getToken()
     
     //zde bude uložený nový token
     token_T *tkn = NULL;
+    //atom identifikátoru nebo klíčového slova
+    atom_T *word = NULL;
 
     if (storage != NULL) {
         tkn = storage;
@@ -275,11 +367,17 @@ token_T *getToken()
         return NULL;
     }
     //inicializace řetězce, kam se budou ukládat víceznakové tokeny
-    StrInit(&tkn->atr);
+    if (!tkn_arena.lexeme_ready) {
+        StrInit(&tkn_arena.lexeme);
+        tkn_arena.lexeme_ready = true;
+    }
+    str_T *lexeme = &tkn_arena.lexeme;
+    StrFillWith(lexeme, "");
+    tkn_arena.lexeme_hash = STR_HASH_INIT;
 /*===============================================================HLAVNÍ SMYČKA===============================================================*/
     while(true) {
-        //načtení znaku ze souboru
-        c = getc(stdin);
+        //načtení znaku ze vstupního bufferu
+        c = SrcBufGetc();
 
         //přečtený další znak na jednom řádku
         col++;
@@ -523,7 +621,9 @@ token_T *getToken()
                     
                 } else {
                     push_to_stream = true;
-                    if ((keyw = keyw_token_num(tkn->atr.data))) {
+                    //Identifikátor i klíčové slovo se internuje s již spočítanou rozptylovou hodnotou, druh atomu určí klíčové slovo
+                    word = AtomInternHashed(StrRead(lexeme), StrLen(lexeme), tkn_arena.lexeme_hash);
+                    if ((keyw = keyw_token_num(word->kind))) {
                         //Bylo nalezeno klíčové slovo, vrátí se token konkrétního klíčového slova
                         id_token = keyw;
                     } else {
@@ -639,7 +739,7 @@ token_T *getToken()
                         id_token = INVALID;
                     } else {
                         for (int i = 0; i < indentation; i++) {
-                            StrAppend(&tkn->atr, ' '); 
+                            StrAppend(lexeme, ' '); 
                         }
                     }
                     push_to_stream = true;
@@ -790,31 +890,43 @@ token_T *getToken()
                 ln--;
 
             col--;
-            ungetc(c, stdin);
+            SrcBufUngetc(c);
         }
         //Přidání znaku do atributu tokenu
         if (add_char_to_tkn) {
             if (id_token == EOF_TKN)
-                StrFillWith(&tkn->atr, "EOF");
-            else 
-                StrAppend(&tkn->atr, c);
+                StrFillWith(lexeme, "EOF");
+            else {
+                StrAppend(lexeme, c);
+                tkn_arena.lexeme_hash = STR_HASH_STEP(tkn_arena.lexeme_hash, c);
+            }
         } 
 
         //Odstraneni uvozovek a noveho radku
         if (id_token == STRING_CONST && state == MULTI_LINE_STRING_END_S) {
             //Odstrani se posledni tri uvozovky z multiline stringu
-            tkn->atr.data[strlen(StrRead(&tkn->atr)) - 3] = '\0'; 
+            StrTrunc(lexeme, StrLen(lexeme) - 3); 
             //Odstrani se posledni znak noveho radku
-            int multi_line_len = strlen(StrRead(&tkn->atr));
-            while (tkn->atr.data[multi_line_len] != '\n') {
+            int multi_line_len = StrLen(lexeme);
+            while (StrRead(lexeme)[multi_line_len] != '\n') {
                 multi_line_len--;
             } 
-            tkn->atr.data[multi_line_len] = '\0';
+            StrTrunc(lexeme, multi_line_len);
         }
 
         if (id_token != -1) {
-            //Token je zpracován, vrátí se
-            set_token(tkn, id_token, tkn->atr, line_begin_token, col_begin_token);
+            //Token je zpracován, atribut se přesune do arény a token se vrátí
+            size_t atr_len = StrLen(lexeme);
+            str_T atr = {.data = NULL, .size = atr_len + 1, .len = atr_len};
+            if (word != NULL) {
+                //Atribut identifikátoru a klíčového slova je text atomu
+                tkn->atom = word;
+                atr.data = word->text;
+            } else {
+                tkn->atom = NULL;
+                atr.data = arena_strdup(StrRead(lexeme), atr_len);
+            }
+            set_token(tkn, id_token, atr, line_begin_token, col_begin_token);
             return tkn;
         }
 
@@ -828,6 +940,36 @@ void storeToken(token_T *tkn)
 }
 
 void destroyToken(token_T *tkn) {
-    StrDestroy(&tkn->atr);
-    free(tkn);
+    //Atribut patří aréně, token se jen vrátí do zásobníku recyklovaných tokenů
+    if (tkn_arena.free_used == tkn_arena.free_size) {
+        tkn_arena.free_size = tkn_arena.free_size == 0 ? TOKEN_SLAB_SIZE : 2 * tkn_arena.free_size;
+        tkn_arena.free = memRealloc(MEM_SCANNER, tkn_arena.free, tkn_arena.free_size * sizeof(token_T *));
+        if (tkn_arena.free == NULL) {
+            fprintf(stderr, "destroyToken() memory allocation error.\n");
+            exit(99);
+        }
+    }
+    tkn_arena.free[tkn_arena.free_used++] = tkn;
+    tkn_arena.live--;
+}
+
+void destroyScanner() {
+    storage = NULL;
+
+    //hromadné uvolnění všech tokenů a jejich atributů
+    while (tkn_arena.slabs != NULL) {
+        tokenSlab_T *next = tkn_arena.slabs->next;
+        memFree(MEM_SCANNER, tkn_arena.slabs);
+        tkn_arena.slabs = next;
+    }
+    while (tkn_arena.blocks != NULL) {
+        tokenArenaBlock_T *next = tkn_arena.blocks->next;
+        memFree(MEM_SCANNER, tkn_arena.blocks);
+        tkn_arena.blocks = next;
+    }
+    memFree(MEM_SCANNER, tkn_arena.free);
+    if (tkn_arena.lexeme_ready) StrDestroy(&tkn_arena.lexeme);
+    memset(&tkn_arena, 0, sizeof(tkn_arena));
+
+    SrcBufDestroy();
 }
\ No newline at end of file
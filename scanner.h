@@ -9,6 +9,7 @@
 #define _SCANNER_H_
 
 #include "strR.h"
+#include "atom.h"
 
 /**
  * @brief ID tokenov
@@ -66,6 +67,7 @@ typedef struct token
 {
     int type;      ///< typ tokenu
     str_T atr;     ///< atribut tokenu, prečítaný reťazec
+    atom_T *atom;  ///< atóm názvu identifikátora (typ ID) alebo kľúčového slova, inak NULL
     int ln;        ///< riadok tokenu
     int col;       ///< pozícia prvého charakteru tokenu v riadku
 } token_T;
@@ -77,6 +79,7 @@ typedef struct token
  * a naplní ju prečítanými hodnotami:
  *  - type:     rozsah token_ids
  *  - atr:      náazov identifikátora, hodnota konštanty ako reťazec, v ostatných prípadoch nedefinované
+ *  - atom:     internovaný názov identifikátora (typ ID) alebo kľúčového slova, atr potom ukazuje na jeho text; inak NULL
  *  - ln:       riadok, ktorým začínal token
  *  - col:      stĺpec, ktorým začínal token
  */
@@ -85,15 +88,26 @@ token_T *getToken();
 /**
  * @brief Uloží token do pamäte skenera
  * @details Hodnota je uschovaná v globálnej premennej. NULL značí, že pamäť je prázdna.
+ * Vrátenie celého tokenu je rovnocenné posunu kurzora srcBuf späť na jeho začiatok: getToken ho vráti
+ * skôr, ako čokoľvek prečíta zo vstupu, a rovnaký vstup by dal rovnaký token. Na rozdiel od posunu sa však
+ * nemusia obnovovať riadok a stĺpec skenera, token sa neskenuje druhýkrát a úschova nepotrebuje bajty,
+ * ktoré srcBuf pri čítaní po blokoch už mohol zahodiť (SrcBufUngetc vracia iba jeden znak).
  */
 void storeToken(token_T *tkn);
 
 /**
- * @brief Dealokuje datovou strukturu token
+ * @brief Zruší token, jeho struktura se vrátí skeneru k opětovnému použití
+ * @details Atribut tokenu leží v aréně skeneru, ta se uvolní hromadně ve chvíli,
+ * kdy neexistuje žádný živý token, případně ve funkci destroyScanner.
  * 
  * @param tkn token
  */
 void destroyToken(token_T *tkn);
 
+/**
+ * @brief Uvoľní zdroje skenera - všetky tokeny, arénu ich atribútov a vyrovnávaciu pamäť vstupu
+ */
+void destroyScanner();
+
 #endif // ifndef _SCANNER_H_
 /* Koniec súboru scanner.h */
@@ -0,0 +1,139 @@
+/** Projekt IFJ2023
+ * @file srcBuf.c
+ * @brief Vyrovnávacia pamäť zdrojového kódu pre lexikálny analyzátor
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "srcBuf.h"
+#include "mem.h"
+
+/**
+ * @brief Stav vyrovnávacej pamäte
+ * @details Platné znaky sú data[0 .. len), kurzor ukazuje na nasledujúci nečítaný znak.
+ */
+typedef struct source_buffer {
+    unsigned char *data; ///< začiatok platných dát
+    size_t len;          ///< počet platných znakov v data
+    size_t pos;          ///< pozícia kurzora
+    size_t size;         ///< veľkosť alokovaného bufferu (pri mapovaní 0)
+    void *map;           ///< začiatok namapovaného súboru, inak NULL
+    size_t map_size;     ///< veľkosť namapovanej oblasti
+    bool eof;            ///< zo vstupu už nie je čo čítať
+    bool ready;          ///< buffer je inicializovaný
+} srcBuf_T;
+
+static srcBuf_T src = {NULL, 0, 0, 0, NULL, 0, false, false};
+
+/**
+ * @brief Pokúsi sa namapovať zvyšok STDIN do pamäte
+ * @return true ak je STDIN obyčajný súbor a mapovanie prebehlo úspešne
+ */
+static bool SrcBufMap() {
+    struct stat st;
+    int fd = fileno(stdin);
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return false;
+
+    // stdio mohlo z STDIN už niečo prečítať, pokračuje sa od logickej pozície streamu
+    long offset = ftell(stdin);
+    if (offset < 0) return false;
+    if ((off_t)offset >= st.st_size) {
+        src.len = 0;
+        src.eof = true;
+        return true;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) return false;
+    posix_madvise(map, st.st_size, POSIX_MADV_SEQUENTIAL);
+
+    src.map = map;
+    src.map_size = st.st_size;
+    src.data = (unsigned char *)map + offset;
+    src.len = st.st_size - offset;
+    src.eof = true; // celý zvyšok vstupu je už k dispozícii
+    return true;
+}
+
+/**
+ * @brief Inicializuje buffer pri prvom použití
+ */
+static void SrcBufInit() {
+    src.ready = true;
+    if (SrcBufMap()) return;
+
+    src.size = SRCBUF_BLOCK_SIZE;
+    src.data = memMalloc(MEM_SOURCE, src.size);
+    if (src.data == NULL) {
+        fprintf(stderr, "SrcBufInit() memory allocation error.\n");
+        exit(99);
+    }
+}
+
+/**
+ * @brief Doplní buffer tak, aby za kurzorom bolo aspoň need + 1 znakov
+ * @return true ak sa podarilo, false ak vstup skončil skôr
+ */
+static bool SrcBufFill(size_t need) {
+    if (!src.ready) SrcBufInit();
+
+    while (src.len - src.pos <= need && !src.eof) {
+        // už spracované znaky sa zahodia, ponechá sa iba krátka história pre SrcBufUngetc
+        if (src.pos > SRCBUF_HISTORY) {
+            size_t drop = src.pos - SRCBUF_HISTORY;
+            memmove(src.data, src.data + drop, src.len - drop);
+            src.len -= drop;
+            src.pos -= drop;
+        }
+
+        if (src.size - src.len < SRCBUF_BLOCK_SIZE) {
+            size_t new_size = src.size * 2;
+            if (new_size < src.len + SRCBUF_BLOCK_SIZE) new_size = src.len + SRCBUF_BLOCK_SIZE;
+            unsigned char *new_data = memRealloc(MEM_SOURCE, src.data, new_size);
+            if (new_data == NULL) {
+                fprintf(stderr, "SrcBufFill() memory allocation error.\n");
+                exit(99);
+            }
+            src.data = new_data;
+            src.size = new_size;
+        }
+
+        size_t n = fread(src.data + src.len, 1, src.size - src.len, stdin);
+        if (n == 0) src.eof = true;
+        src.len += n;
+    }
+
+    return src.len - src.pos > need;
+}
+
+int SrcBufGetc() {
+    if (src.pos >= src.len && !SrcBufFill(0)) return EOF;
+    return src.data[src.pos++];
+}
+
+void SrcBufUngetc(int c) {
+    if (c != EOF && src.pos > 0) src.pos--;
+}
+
+int SrcBufPeek(size_t offset) {
+    if (src.len - src.pos <= offset && !SrcBufFill(offset)) return EOF;
+    return src.data[src.pos + offset];
+}
+
+void SrcBufDestroy() {
+    if (src.map != NULL) {
+        munmap(src.map, src.map_size);
+    }
+    else {
+        memFree(MEM_SOURCE, src.data);
+    }
+    src = (srcBuf_T){NULL, 0, 0, 0, NULL, 0, false, false};
+}
+
+/* Koniec súboru srcBuf.c */
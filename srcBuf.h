@@ -0,0 +1,45 @@
+/** Projekt IFJ2023
+ * @file srcBuf.h
+ * @brief Vyrovnávacia pamäť zdrojového kódu pre lexikálny analyzátor
+ */
+
+#ifndef _SRCBUF_H_
+#define _SRCBUF_H_
+
+#include <stddef.h>
+
+/// Veľkosť bloku, ktorý sa naraz prečíta zo vstupu
+#define SRCBUF_BLOCK_SIZE 65536
+
+/// Počet už prečítaných znakov, ktoré sa pri posune bufferu zachovajú (pre SrcBufUngetc)
+#define SRCBUF_HISTORY 16
+
+/**
+ * @brief Prečíta ďalší znak zdrojového kódu a posunie kurzor
+ * @details Pri prvom volaní sa buffer inicializuje. Ak je STDIN obyčajný súbor, zvyšok
+ * súboru sa namapuje do pamäte, inak sa vstup číta po blokoch veľkosti SRCBUF_BLOCK_SIZE.
+ * @return znak ako unsigned char prevedený na int, EOF na konci vstupu
+ */
+int SrcBufGetc();
+
+/**
+ * @brief Vráti posledný prečítaný znak späť, kurzor sa posunie o jeden znak dozadu
+ * @param c naposledy prečítaný znak, pre EOF nemá funkcia žiadny efekt (rovnako ako ungetc)
+ */
+void SrcBufUngetc(int c);
+
+/**
+ * @brief Nahliadne na znak vo vzdialenosti offset od kurzora bez jeho posunutia
+ * @details Buffer sa podľa potreby doplní, preto je možné nahliadnuť ľubovoľne ďaleko.
+ * @param offset 0 značí znak, ktorý by vrátilo nasledujúce volanie SrcBufGetc
+ * @return znak, alebo EOF ak je pozícia za koncom vstupu
+ */
+int SrcBufPeek(size_t offset);
+
+/**
+ * @brief Uvoľní buffer, prípadne zruší namapovanie súboru
+ */
+void SrcBufDestroy();
+
+#endif // ifndef _SRCBUF_H_
+/* Koniec súboru srcBuf.h */
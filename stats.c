@@ -0,0 +1,129 @@
+/** Projekt IFJ2023
+ * @file stats.c
+ * @brief Štatistiky prekladu vo formáte JSON (prepínač --stats=json)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats.h"
+#include "scanner.h"
+#include "emit.h"
+#include "mem.h"
+
+bool stats_enabled = false;
+
+#define STATS_TOKEN_TYPES (EOF_TKN + 1) ///< počet typov tokenov
+
+/// Názvy typov tokenov vo výpise, indexované token_ids
+static const char *token_names[STATS_TOKEN_TYPES] = {
+    "INVALID", "ID", "INT_TYPE", "DOUBLE_TYPE", "STRING_TYPE", "INT_NIL_TYPE", "DOUBLE_NIL_TYPE",
+    "STRING_NIL_TYPE", "INT_CONST", "DOUBLE_CONST", "STRING_CONST", "VAR", "LET", "IF", "ELSE", "WHILE",
+    "FUNC", "RETURN", "NIL", "UNDERSCORE", "ARROW", "BRT_RND_L", "BRT_RND_R", "BRT_CUR_L", "BRT_CUR_R",
+    "OP_PLUS", "OP_MINUS", "OP_MUL", "OP_DIV", "ASSIGN", "EQ", "NEQ", "GT", "GTEQ", "LT", "LTEQ", "EXCL",
+    "QUEST_MARK", "TEST_NIL", "COMMA", "COLON", "EOF_TKN"
+};
+
+/**
+ * @brief Počet inštrukcií jednej funkcie
+*/
+typedef struct stats_fn {
+    const char *name;   ///< náveštie funkcie v tabuľke náveští generátora
+    size_t ins;
+} statsFn_T;
+
+static struct {
+    size_t tokens[STATS_TOKEN_TYPES];
+    size_t symbols[STATS_MAX_DEPTH];    ///< počet symbolov podľa hĺbky rozsahu platnosti
+    size_t max_depth;                   ///< najväčšia hĺbka vnorenia rozsahov platnosti
+    size_t fn_defined;
+    size_t fn_calls;
+    size_t bif_calls;
+    size_t main_ins;                    ///< inštrukcie hlavného tela vrátane odložených častí
+    size_t opcodes[INS_COUNT];
+    statsFn_T *fns;                     ///< funkcie v poradí výpisu
+    size_t fns_used;
+    size_t fns_size;
+} stats;
+
+void statsToken(int type) {
+    if (type >= 0 && type < STATS_TOKEN_TYPES) stats.tokens[type]++;
+}
+
+void statsScope(size_t depth) {
+    if (depth > stats.max_depth) stats.max_depth = depth;
+}
+
+void statsSymbol(size_t depth) {
+    stats.symbols[depth < STATS_MAX_DEPTH ? depth : STATS_MAX_DEPTH - 1]++;
+}
+
+void statsFunctionDefined() {
+    stats.fn_defined++;
+}
+
+void statsFunctionCalled(bool builtin) {
+    if (builtin) stats.bif_calls++;
+    else stats.fn_calls++;
+}
+
+void statsBlock(codeBlock_T *block) {
+    for (size_t i = 0; i < block->used; i++) stats.opcodes[block->ins[i].code]++;
+    if (block == &code_main) {
+        stats.main_ins += block->used;
+        return;
+    }
+    if (stats.fns_used == stats.fns_size) {
+        stats.fns_size = stats.fns_size == 0 ? 16 : 2 * stats.fns_size;
+        statsFn_T *fns = memRealloc(MEM_DIAG, stats.fns, stats.fns_size * sizeof(statsFn_T));
+        if (fns == NULL) {
+            fprintf(stderr, "stats memory allocation error.\n");
+            exit(COMPILER_ERROR);
+        }
+        stats.fns = fns;
+    }
+    bool named = block->used > 0 && block->ins[0].code == INS_LABEL;
+    stats.fns[stats.fns_used++] = (statsFn_T){named ? genOperandText(&block->ins[0].op[0]) : "", block->used};
+}
+
+void statsReport() {
+    // mená sú identifikátory a náveštia IFJcode23, v reťazcoch JSON ich netreba escapovať
+    size_t total = 0;
+    for (int t = 0; t < STATS_TOKEN_TYPES; t++) total += stats.tokens[t];
+    fprintf(stderr, "{\n  \"tokens\": {\n    \"total\": %zu,\n    \"by_type\": {", total);
+    for (int t = 0; t < STATS_TOKEN_TYPES; t++) {
+        fprintf(stderr, "%s\n      \"%s\": %zu", t > 0 ? "," : "", token_names[t], stats.tokens[t]);
+    }
+    fprintf(stderr, "\n    }\n  },\n");
+
+    size_t depths = stats.max_depth + 1 < STATS_MAX_DEPTH ? stats.max_depth + 1 : STATS_MAX_DEPTH;
+    fprintf(stderr, "  \"scopes\": {\n    \"max_depth\": %zu,\n    \"symbols_by_depth\": [", stats.max_depth);
+    for (size_t d = 0; d < depths; d++) fprintf(stderr, "%s%zu", d > 0 ? ", " : "", stats.symbols[d]);
+    fprintf(stderr, "]\n  },\n");
+
+    fprintf(stderr, "  \"functions\": {\n    \"defined\": %zu,\n    \"calls\": %zu,\n    \"builtin_calls\": %zu\n  },\n",
+        stats.fn_defined, stats.fn_calls, stats.bif_calls);
+
+    total = stats.main_ins;
+    for (size_t i = 0; i < stats.fns_used; i++) total += stats.fns[i].ins;
+    fprintf(stderr, "  \"instructions\": {\n    \"total\": %zu,\n    \"by_function\": {\n      \"!main\": %zu",
+        total, stats.main_ins);
+    for (size_t i = 0; i < stats.fns_used; i++) {
+        fprintf(stderr, ",\n      \"%s\": %zu", stats.fns[i].name, stats.fns[i].ins);
+    }
+    fprintf(stderr, "\n    },\n    \"by_opcode\": {");
+    // pseudo-inštrukcia HOIST sa pred výpisom rozvinie, na výstupe nie je
+    for (int c = 0; c < INS_HOIST; c++) {
+        fprintf(stderr, "%s\n      \"%s\": %zu", c > 0 ? "," : "", genInsName(c), stats.opcodes[c]);
+    }
+    fprintf(stderr, "\n    }\n  },\n");
+
+    fprintf(stderr, "  \"labels\": %d,\n  \"unique_variables\": %d,\n  \"output_bytes\": %zu\n}\n",
+        genUniqLabelCount(), genUniqVarCount(), emitBytes());
+
+    memFree(MEM_DIAG, stats.fns);
+    stats.fns = NULL;
+    stats.fns_used = stats.fns_size = 0;
+}
+
+/* Koniec súboru stats.c */
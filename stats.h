@@ -0,0 +1,70 @@
+/** Projekt IFJ2023
+ * @file stats.h
+ * @brief Štatistiky prekladu vo formáte JSON (prepínač --stats=json)
+ */
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "generator.h"
+
+#define STATS_MAX_DEPTH 64 ///< hlbšie rozsahy platnosti sa pri počte symbolov započítajú do najhlbšieho
+
+/**
+ * @brief Zber štatistík je zapnutý, inak sa háčiky v parseri, tabuľke symbolov a generátore nevolajú
+*/
+extern bool stats_enabled;
+
+/**
+ * @brief Prečítaný token typu type (token_ids), token vrátený cez saveToken sa nepočíta znova
+*/
+void statsToken(int type);
+
+/**
+ * @brief Vstup do rozsahu platnosti s hĺbkou depth, globálny rozsah má hĺbku 0
+*/
+void statsScope(size_t depth);
+
+/**
+ * @brief Symbol vložený do rozsahu platnosti s hĺbkou depth
+*/
+void statsSymbol(size_t depth);
+
+/**
+ * @brief Definícia používateľskej funkcie
+*/
+void statsFunctionDefined();
+
+/**
+ * @brief Volanie funkcie, builtin pre vstavané funkcie
+*/
+void statsFunctionCalled(bool builtin);
+
+/**
+ * Volá sa z genPrintBlock, počíta sa teda kód po optimalizáciách, ktorý naozaj ide na výstup.
+ * Funkcia je pomenovaná podľa náveštia na začiatku bloku, hlavné telo (aj jeho odložené časti) je "!main".
+ * Pevný úvod výstupu (DEFVAR pomocných premenných, JUMP !main, LABEL !main, EXIT) sa zapisuje ako text mimo
+ * blokov, do počtov inštrukcií preto nepatrí.
+ *
+ * @brief Započíta inštrukcie vypisovaného bloku podľa funkcie a operačného kódu
+*/
+void statsBlock(codeBlock_T *block);
+
+/**
+ * Objekt obsahuje:
+ *  - tokens: celkový počet a počty podľa token_ids
+ *  - scopes: najväčšia hĺbka vnorenia a počty symbolov podľa hĺbky (globálny rozsah má hĺbku 0)
+ *  - functions: definované funkcie, volania používateľských a vstavaných funkcií
+ *  - instructions: celkový počet, počty podľa funkcie ("!main" s odloženými časťami) a podľa operačného kódu
+ *  - labels, unique_variables: počítadlá genUniqLabelCount a genUniqVarCount
+ *  - output_bytes: objem výstupu z emitBytes, preto sa volá po emitClose
+ * Výstup pre vzorový program porovnáva tests/stats so súborom stats.json.
+ *
+ * @brief Vypíše na stderr nazbierané štatistiky ako jeden objekt JSON a uvoľní zdroje
+*/
+void statsReport();
+
+#endif // ifndef _STATS_H_
+/* Koniec súboru stats.h */
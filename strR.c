@@ -6,51 +6,84 @@
  */
 
 #include "strR.h"
+#include "mem.h"
 
-void StrInit(str_T *s)
+/**
+ * @brief Zabezpečí, aby sa do reťazca zmestilo len znakov a ukončovací znak \0
+ * @details Veľkosť rastie geometricky, prechod z sso na haldu skopíruje doterajší obsah.
+*/
+static void StrReserve(str_T *s, size_t len, const char *fn)
 {
-    s -> data = (char *)malloc(STR_INIT_SIZE * sizeof(char));
+    if (len < s->size) return;
+
+    size_t new_size = s->size * 2;
+    if (new_size <= len) new_size = len + 1;
+
+    char *new_data;
+    if (s->data == NULL) {
+        new_data = (char *)memMalloc(MEM_STRING, new_size);
+        if (new_data != NULL) memcpy(new_data, s->sso, s->len + 1);
+    }
+    else {
+        new_data = (char *)memRealloc(MEM_STRING, s->data, new_size);
+    }
 
-    if(s -> data == NULL) {
-        fprintf(stderr, "StrInit() memory allocation error.\n");
+    if (new_data == NULL) {
+        fprintf(stderr, "%s() memory allocation error.\n", fn);
         exit(99);
     }
 
+    s->data = new_data;
+    s->size = new_size;
+}
+
+void StrInit(str_T *s)
+{
+    s -> data = NULL;
+
     // inicializacia prveho znaku na '\0'
-    s -> data[0] = '\0';
+    s -> sso[0] = '\0';
     s -> size = STR_INIT_SIZE;
+    s -> len = 0;
 
 }
 
 void StrDestroy(str_T *s)
 {
-    free(s -> data);
+    memFree(MEM_STRING, s -> data);
     s -> data = NULL;
     s -> size = 0;
+    s -> len = 0;
+    s -> sso[0] = '\0';
 }
 
 char *StrRead(str_T *s)
 {
-    return s -> data;
+    return s -> data != NULL ? s -> data : s -> sso;
+}
+
+size_t StrLen(str_T *s)
+{
+    return s -> len;
+}
+
+void StrTrunc(str_T *s, size_t len)
+{
+    if (len < s->len) {
+        s->len = len;
+        StrRead(s)[len] = '\0';
+    }
 }
 
 void StrAppend(str_T *s, char c)
 {
     // realokovat ak je potrebne
-    if (strlen(s->data) + 1 == s->size) {
-        s->size *= 2;
-        s->data = (char *)realloc(s->data, s->size);
-
-        if (s->data == NULL) {
-            fprintf(stderr, "StrAppend() memory allocation error.\n");
-            exit(99);
-        }
-    }
+    StrReserve(s, s->len + 1, "StrAppend");
 
     // pridat znak na koniec a posunut koniec retezca
-    size_t len = strlen(s->data);
-    s->data[len] = c;
-    s->data[len + 1] = '\0';
+    char *data = StrRead(s);
+    data[s->len++] = c;
+    data[s->len] = '\0';
 }
 
 void StrFillWith(str_T *dest, char *src)
@@ -58,54 +91,41 @@ void StrFillWith(str_T *dest, char *src)
     size_t len = strlen(src);
 
     // realokovat ak je potrebne na len + 1
-    if (len >= dest->size) {
-        dest->size = len + 1;
-        dest->data = (char *)realloc(dest->data, dest->size);
-
-        if (dest->data == NULL) {
-            fprintf(stderr, "StrFillWith() memory allocation error..\n");
-            exit(99);
-        }
-    }
+    StrReserve(dest, len, "StrFillWith");
 
-    strcpy(dest->data, src);
+    memmove(StrRead(dest), src, len + 1);
+    dest->len = len;
 }
 
 void StrCat(str_T *dest, str_T *src)
 {
-    size_t len_dest = strlen(dest->data);
-    size_t len_src = strlen(src->data);
-    
+    size_t len_src = src->len;
+
     // realokovat ak je potrebne na dlzku dest + dlzku src + 1
-    if (len_dest + len_src + 1 >= dest->size) {
-        dest->size = len_dest + len_src + 1;
-        dest->data = (char *)realloc(dest->data, dest->size);
-        
-        if (dest->data == NULL) {
-            fprintf(stderr, "StrCat() memory allocation error.\n");
-            exit(99);
-        }
-    }
-    
-    strcat(dest->data, src->data);
+    StrReserve(dest, dest->len + len_src, "StrCat");
+
+    memmove(StrRead(dest) + dest->len, StrRead(src), len_src + 1);
+    dest->len += len_src;
 }
 
 void StrCatString(str_T *dest, char *src)
 {
-    size_t len_dest = strlen(dest->data);
     size_t len_src = strlen(src);
-    
+
     // realokovat ak je potrebne na dlzku dest + dlzku src + 1
-    if (len_dest + len_src + 1 >= dest->size) {
-        dest->size = len_dest + len_src + 1;
-        dest->data = (char *)realloc(dest->data, dest->size);
-        
-        if (dest->data == NULL) {
-            fprintf(stderr, "StrCatString() memory allocation error.\n");
-            exit(99);
-        }
-    }
+    StrReserve(dest, dest->len + len_src, "StrCatString");
 
-    strcat(dest->data, src);
+    memmove(StrRead(dest) + dest->len, src, len_src + 1);
+    dest->len += len_src;
 }
+unsigned long StrHash(const char *s)
+{
+    unsigned long hash = STR_HASH_INIT;
+    while (*s != '\0') {
+        hash = STR_HASH_STEP(hash, *s);
+        s++;
+    }
+    return hash;
+}
+
 /* Koniec súboru strR.c */
@@ -12,16 +12,23 @@
 #include <stdio.h>
 #include <string.h>
 
-#define STR_INIT_SIZE 16 ///< veľkosť novo inicializovaného str_T
+#define STR_INIT_SIZE 24 ///< veľkosť novo inicializovaného str_T, krátke reťazce sú uložené priamo v štruktúre
+
+#define STR_HASH_INIT 5381UL ///< počiatočná hodnota rozptylovej funkcie djb2
+#define STR_HASH_STEP(hash, c) (((hash) << 5) + (hash) + (unsigned char)(c)) ///< hash * 33 + c
 
 /**
  * @brief reťazec s automatickou realokáciu veľkosti
  * @details Na prácu s reťazcom treba používať vytvorené metódy nižšie, ktoré automaticky
  * realokujú potrebné miesto pre reťazec. (Vždy zdvojnásobiť veľkosť.)
+ * Reťazec kratší ako STR_INIT_SIZE je uložený priamo v poli sso a data je NULL,
+ * preto sa k obsahu pristupuje výhradne cez StrRead. Kópia štruktúry je tak vždy platná.
 */
 typedef struct stringR {
-    char *data; ///< alokované pole znakov
+    char *data; ///< alokované pole znakov, NULL ak je reťazec uložený v sso
     size_t size; ///< alokovaná veľkosť
+    size_t len; ///< dĺžka reťazca bez znaku \0
+    char sso[STR_INIT_SIZE]; ///< krátky reťazec uložený bez alokácie
 } str_T;
 
 /**
@@ -36,10 +43,20 @@ void StrDestroy(str_T *s);
 
 /**
  * @brief Prečíta reťazec, vrati ukazatel na data
- * @return ukazateľ na reťazec, s->data
+ * @return ukazateľ na reťazec, s->data alebo s->sso
 */
 char *StrRead(str_T *s);
 
+/**
+ * @brief Dĺžka reťazca v konštantnom čase
+*/
+size_t StrLen(str_T *s);
+
+/**
+ * @brief Skráti reťazec na dĺžku len, ak je kratší, nič sa nezmení
+*/
+void StrTrunc(str_T *s, size_t len);
+
 /**
  * @brief Pridá znak na koniec reťazca
 */
@@ -60,5 +77,10 @@ void StrCat(str_T *dest, str_T *src);
 */
 void StrCatString(str_T *dest, char *src);
 
+/**
+ * @brief Rozptylová funkcia djb2, rovnakú hodnotu počíta skener postupne pre identifikátory
+*/
+unsigned long StrHash(const char *s);
+
 #endif // ifndef _STRR_H_
 /* Koniec súboru strR.h */
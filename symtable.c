@@ -6,32 +6,262 @@
  */
 
 #include "symtable.h"
+#include "timer.h"
+#include "mem.h"
+#include "stats.h"
 
-//djb2 hash function
-unsigned long hashOne(const char *str)
-{
-    unsigned long hash = 5381;
-    int c;
+/**
+ * @brief Vyhľadá položku rozptylovej tabuľky s daným kľúčom
+ * @return index položky s kľúčom, alebo index prázdnej položky, kam by kľúč patril
+ */
+static size_t SymTabFindSlot(TSSlot_T *slots, size_t size, atom_T *key) {
+    size_t mask = size - 1;
+    size_t index = key->hash & mask;
+    while (slots[index].data != NULL) {
+        if (slots[index].data->id == key) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
 
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+/**
+ * @brief Vloží položku s kľúčom, ktorý sa v tabuľke ešte nenachádza
+ */
+static void SymTabPlaceSlot(TSSlot_T *slots, size_t size, TSSlot_T slot) {
+    size_t mask = size - 1;
+    size_t index = slot.hash & mask;
+    while (slots[index].data != NULL) {
+        index = (index + 1) & mask;
     }
-    return hash;
+    slots[index] = slot;
 }
 
-unsigned long hashTwo(const char *str)
-{
-    unsigned long hash = 5381;
-    int c;
+/**
+ * @brief Odstráni položku z rozptylovej tabuľky bez zanechania náhrobku
+ * @details Nasledujúce položky toho istého zhluku sa posunú dozadu tak, aby ostali dosiahnuteľné.
+ */
+static void SymTabDeleteSlot(TSSlot_T *slots, size_t size, size_t index) {
+    size_t mask = size - 1;
+    size_t next = index;
+    while (true) {
+        next = (next + 1) & mask;
+        if (slots[next].data == NULL) break;
+        size_t home = slots[next].hash & mask;
+        // položka sa presunie, ak jej domovský index neleží cyklicky v intervale (index, next]
+        bool stays = (index <= next) ? (index < home && home <= next) : (index < home || home <= next);
+        if (!stays) {
+            slots[index] = slots[next];
+            index = next;
+        }
+    }
+    slots[index].data = NULL;
+}
+
+/**
+ * @brief Presunie do novej tabuľky aspoň count položiek pôvodnej tabuľky
+ * @details Presúvajú sa vždy celé zhluky, zvyšok pôvodnej tabuľky preto ostáva
+ * prehľadávateľný lineárnym skúšaním. Po prejdení celej pôvodnej tabuľky sa uvoľní.
+ */
+static void SymTabMigrate(SymTab_T *st, size_t count) {
+    if (st->old_slots == NULL) {
+        return;
+    }
+
+    size_t mask = st->old_size - 1;
+    while (st->migrate_left > 0 && (count > 0 || st->old_slots[st->migrate_pos].data != NULL)) {
+        TSSlot_T *slot = &(st->old_slots[st->migrate_pos]);
+        if (slot->data != NULL) {
+            SymTabPlaceSlot(st->slots, st->size, *slot);
+            slot->data = NULL;
+        }
+        st->migrate_pos = (st->migrate_pos + 1) & mask;
+        st->migrate_left--;
+        if (count > 0) count--;
+    }
+
+    if (st->migrate_left == 0) {
+        memFree(MEM_SYMTAB, st->old_slots);
+        st->old_slots = NULL;
+        st->old_size = 0;
+    }
+}
+
+/**
+ * @brief Zdvojnásobí veľkosť rozptylovej tabuľky
+ * @details Položky sa nepresúvajú naraz, ale postupne pri ďalších vloženiach (SymTabMigrate).
+ */
+static void SymTabGrow(SymTab_T *st) {
+    // predchádzajúce zväčšovanie sa musí dokončiť
+    SymTabMigrate(st, st->old_size);
+
+    size_t new_size = st->size * 2;
+    TSSlot_T *new_slots = memCalloc(MEM_SYMTAB, new_size, sizeof(TSSlot_T));
+    if (new_slots == NULL) {
+        fprintf(stderr, "SymTabGrow() - memory allocation error\n");
+        exit(99);
+    }
+
+    st->old_slots = st->slots;
+    st->old_size = st->size;
+    st->slots = new_slots;
+    st->size = new_size;
+
+    // presúvanie začína na prázdnej položke, teda na začiatku zhluku
+    st->migrate_pos = 0;
+    while (st->old_slots[st->migrate_pos].data != NULL) {
+        st->migrate_pos++;
+    }
+    st->migrate_left = st->old_size;
+}
+
+/**
+ * @brief Vyhľadá položku s daným kľúčom, počas zväčšovania aj v pôvodnej tabuľke
+ * @return položka s kľúčom alebo NULL ak sa kľúč v tabuľke nenachádza
+ */
+static TSSlot_T *SymTabFind(SymTab_T *st, atom_T *key) {
+    TSSlot_T *slot = &(st->slots[SymTabFindSlot(st->slots, st->size, key)]);
+    if (slot->data == NULL && st->old_slots != NULL) {
+        slot = &(st->old_slots[SymTabFindSlot(st->old_slots, st->old_size, key)]);
+    }
+    return slot->data != NULL ? slot : NULL;
+}
+
+/**
+ * @brief Vyhľadá položku s daným kľúčom v novej tabuľke
+ * @details Ak je kľúč ešte v pôvodnej tabuľke, presunie sa najprv do novej.
+ * @return index položky s kľúčom, alebo index prázdnej položky, kam by kľúč patril
+ */
+static size_t SymTabFindPulled(SymTab_T *st, atom_T *key) {
+    if (st->old_slots != NULL) {
+        size_t old_index = SymTabFindSlot(st->old_slots, st->old_size, key);
+        if (st->old_slots[old_index].data != NULL) {
+            SymTabPlaceSlot(st->slots, st->size, st->old_slots[old_index]);
+            SymTabDeleteSlot(st->old_slots, st->old_size, old_index);
+        }
+    }
+    return SymTabFindSlot(st->slots, st->size, key);
+}
+
+/**
+ * @brief Vyhľadá prvok s daným kľúčom vložený priamo do zadaného bloku
+ */
+static TSData_T *SymTabBlockLookUp(SymTab_T *st, TSBlock_T *block, atom_T *key) {
+    if (block == NULL || st->slots == NULL || key == NULL) {
+        return NULL;
+    }
+
+    TSSlot_T *slot = SymTabFind(st, key);
+    TSData_T *data = slot != NULL ? slot->data : NULL;
+    // prvky s rovnakým kľúčom sú zoradené od najhlbšieho bloku
+    while (data != NULL && data->block->depth > block->depth) {
+        data = data->shadowed;
+    }
+    if (data != NULL && data->block == block) {
+        return data;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Vloží prvok do zadaného bloku, prvok zatieni prvky s rovnakým kľúčom z obklopujúcich blokov
+ */
+static void SymTabBlockInsert(SymTab_T *st, TSBlock_T *block, TSData_T *elem) {
+    // zaplnenie rozptylovej tabuľky sa udržuje najviac na polovici
+    if (2 * (st->used + 1) > st->size) {
+        SymTabGrow(st);
+    }
+    SymTabMigrate(st, SYMTABLE_MIGRATE_STEP);
+
+    size_t index = SymTabFindPulled(st, elem->id);
+    TSSlot_T *slot = &(st->slots[index]);
+
+    if (slot->data == NULL) {
+        // prvý prvok s daným kľúčom
+        slot->hash = elem->id->hash;
+        slot->data = elem;
+        elem->shadowed = NULL;
+        st->used++;
+    }
+    else if (slot->data->block->depth <= block->depth) {
+        // prvok zatieni doteraz viditeľný prvok
+        elem->shadowed = slot->data;
+        slot->data = elem;
+    }
+    else {
+        // vloženie do obklopujúceho bloku (napr. globálneho), zoznam ostáva zoradený podľa hĺbky
+        TSData_T *prev = slot->data;
+        while (prev->shadowed != NULL && prev->shadowed->block->depth > block->depth) {
+            prev = prev->shadowed;
+        }
+        elem->shadowed = prev->shadowed;
+        prev->shadowed = elem;
+    }
+
+    elem->block = block;
+    elem->block_next = block->symbols;
+    block->symbols = elem;
+    block->used++;
+}
+
+/**
+ * @brief Vyradí prvok z rozptylovej tabuľky, zatienený prvok sa opäť stane viditeľným
+ */
+static void SymTabUnlink(SymTab_T *st, TSData_T *elem) {
+    size_t index = SymTabFindPulled(st, elem->id);
+    TSSlot_T *slot = &(st->slots[index]);
+    if (slot->data == NULL) {
+        return;
+    }
+
+    if (slot->data == elem) {
+        if (elem->shadowed != NULL) {
+            slot->data = elem->shadowed;
+        }
+        else {
+            SymTabDeleteSlot(st->slots, st->size, index);
+            st->used--;
+        }
+        return;
+    }
+
+    TSData_T *prev = slot->data;
+    while (prev->shadowed != NULL && prev->shadowed != elem) {
+        prev = prev->shadowed;
+    }
+    if (prev->shadowed == elem) {
+        prev->shadowed = elem->shadowed;
+    }
+}
 
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) ^ c;
+/**
+ * @brief Pripraví blok na použitie, prednostne z odstránených blokov
+ */
+static TSBlock_T *SymTabNewBlock(SymTab_T *st) {
+    TSBlock_T *block = st->spare;
+    if (block != NULL) {
+        st->spare = block->next;
+    }
+    else {
+        block = memMalloc(MEM_SYMTAB, sizeof(TSBlock_T));
+        if (block == NULL) {
+            fprintf(stderr, "SymTabAddLocalBlock() - new block memory allocation error\n");
+            exit(99);
+        }
     }
-    return hash;
+
+    block->used = 0;
+    block->depth = 0;
+    block->prev = NULL;
+    block->next = NULL;
+    block->has_return = false;
+    block->symbols = NULL;
+    return block;
 }
 
 func_sig_T *SymTabCreateFuncSig() {
-    func_sig_T *f = malloc(sizeof(func_sig_T));
+    func_sig_T *f = memMalloc(MEM_SYMTAB, sizeof(func_sig_T));
     if (f == NULL) {
         fprintf(stderr, "SymTabCreateFuncSig() - memory allocation error\n");
         exit(99);
@@ -39,28 +269,30 @@ func_sig_T *SymTabCreateFuncSig() {
     //inicilizacia
     f->ret_type = SYM_TYPE_UNKNOWN;
     StrInit(&(f->par_types));
-    DLLstr_Init(&(f->par_names));
-    DLLstr_Init(&(f->par_ids));
+    AtomListInit(&(f->par_names));
+    AtomListInit(&(f->par_ids));
     return f;
 }
 
 TSData_T *SymTabCreateElement(char *key)
 {
-    TSData_T *elem = malloc(sizeof(TSData_T));
+    return SymTabCreateElementAtom(AtomIntern(key));
+}
+
+TSData_T *SymTabCreateElementAtom(atom_T *key)
+{
+    TSData_T *elem = memMalloc(MEM_SYMTAB, sizeof(TSData_T));
     if(elem == NULL) {
         fprintf(stderr, "SymTabCreateElement() - memory allocation error\n");
         exit(99);
     }
-    elem->id = malloc(sizeof(char)*(strlen(key)+1));
-    if(elem->id == NULL) {
-        free(elem);
-        fprintf(stderr, "SymTabCreateElement() - memory allocation error\n");
-        exit(99);
-    }
-    //inicializacia
+    //inicializacia, kluc aj kodove meno patria tabulke atomov
+    elem->id = key;
+    elem->codename = NULL;
     elem->type = SYM_TYPE_UNKNOWN;
-    strcpy(elem->id, key);
-    StrInit(&(elem->codename));
+    elem->block = NULL;
+    elem->shadowed = NULL;
+    elem->block_next = NULL;
     return elem; 
 }
 
@@ -69,83 +301,78 @@ void SymTabDestroyElement(TSData_T *elem) {
         //ak je to funkcia, treba uvolniť aj jej signatúru
         if(elem->type == SYM_TYPE_FUNC) {
             StrDestroy(&(elem->sig->par_types));
-            DLLstr_Dispose(&(elem->sig->par_names));
-            DLLstr_Dispose(&(elem->sig->par_ids));
-            free(elem->sig);
+            AtomListDestroy(&(elem->sig->par_names));
+            AtomListDestroy(&(elem->sig->par_ids));
+            memFree(MEM_SYMTAB, elem->sig);
         }
-        free(elem->id);
-        StrDestroy(&(elem->codename));
-        free(elem);
+        memFree(MEM_SYMTAB, elem);
     }
 }
 
 void SymTabInit(SymTab_T *st) {
 
-    st -> global = malloc(sizeof (TSBlock_T) + sizeof(TSData_T*) * SYMTABLE_MAX_SIZE);
+    st->size = SYMTABLE_INIT_SIZE;
+    st->used = 0;
+    st->spare = NULL;
+    st->old_slots = NULL;
+    st->old_size = 0;
+    st->migrate_pos = 0;
+    st->migrate_left = 0;
+    st->slots = memCalloc(MEM_SYMTAB, st->size, sizeof(TSSlot_T));
 
-    if(st -> global == NULL) {
+    if(st->slots == NULL) {
         fprintf(stderr, "SymTabInit() - memory allocation error\n");
         exit(99);
     }
 
-    //inicializacia
-    st -> global -> used = 0;
-    st -> global -> prev = NULL;
-    st -> global -> next = NULL;
-    st -> global -> has_return = false;
-
-    // NULL značí prázdne (voľné) miesto v tabuľke
-    for (size_t i = 0; i < SYMTABLE_MAX_SIZE; i++) {
-        st -> global -> array[i] = NULL;
-    }
-
-    st -> local = st -> global;
+    st->global = SymTabNewBlock(st);
+    st->local = st->global;
 }
 
 void SymTabAddLocalBlock(SymTab_T *st) {
-    if (st == NULL) {
+    if (st == NULL || st->local == NULL) {
         fprintf(stderr, "SymTabAddLocalBlock() - symbol table not initialized\n");
         exit(99);
     }
-    
-    TSBlock_T *newBlock = malloc(sizeof (TSBlock_T) + sizeof(TSData_T*) * SYMTABLE_MAX_SIZE);
 
-    if(newBlock == NULL) { 
-        fprintf(stderr, "SymTabAddLocalBlock() - new block memory allocation error\n");
-        exit(99);
-    }
-
-    newBlock -> used = 0;
-
-    for (size_t i = 0; i < SYMTABLE_MAX_SIZE; i++) {
-        newBlock -> array[i] = NULL;
-    }
+    TIMER_BEGIN(TIMER_SYMTAB);
+    TSBlock_T *newBlock = SymTabNewBlock(st);
 
     //pridanie noveho bloku do zoznamu blokov
-    if(st -> local != NULL) {
-        st -> local -> next = newBlock;
-    }
-
-    newBlock -> prev = st -> local;
-    newBlock -> next = NULL;
-    newBlock -> has_return = false;
+    st->local->next = newBlock;
+    newBlock->prev = st->local;
+    newBlock->depth = st->local->depth + 1;
 
-    st -> local = newBlock;
+    st->local = newBlock;
+    if (stats_enabled) statsScope(newBlock->depth);
+    TIMER_END();
 }
 
 void SymTabRemoveLocalBlock(SymTab_T *st) {
+    TIMER_BEGIN(TIMER_SYMTAB);
     TSBlock_T *currentLocal = st->local;
     st->local = currentLocal->prev;
+    if (st->local != NULL) {
+        st->local->next = NULL;
+    }
+    else {
+        st->global = NULL;
+    }
 
-    //uvolnenie bloku a kazdeho prvku v nom
-    for (size_t i = 0; i < SYMTABLE_MAX_SIZE; i++) {
-        TSData_T *data = currentLocal->array[i];
-        if(data != NULL) {
-            SymTabDestroyElement(data);
-        }
-    }   
+    //uvolnenie kazdeho prvku bloku, od naposledy vlozeneho
+    TSData_T *data = currentLocal->symbols;
+    while (data != NULL) {
+        TSData_T *next = data->block_next;
+        SymTabUnlink(st, data);
+        SymTabDestroyElement(data);
+        data = next;
+    }
 
-    free(currentLocal); 
+    //blok sa odlozi na opatovne pouzitie
+    currentLocal->symbols = NULL;
+    currentLocal->next = st->spare;
+    st->spare = currentLocal;
+    TIMER_END();
 }
 
 void SymTabDestroy(SymTab_T *st) {
@@ -154,45 +381,70 @@ void SymTabDestroy(SymTab_T *st) {
         SymTabRemoveLocalBlock(st);
     }
 
+    while (st->spare != NULL) {
+        TSBlock_T *next = st->spare->next;
+        memFree(MEM_SYMTAB, st->spare);
+        st->spare = next;
+    }
+
+    memFree(MEM_SYMTAB, st->slots);
+    memFree(MEM_SYMTAB, st->old_slots);
+    st->slots = NULL;
+    st->old_slots = NULL;
+    st->size = 0;
+    st->old_size = 0;
+    st->used = 0;
     st->global = NULL;
     st->local = NULL;
 }
 
 TSData_T *SymTabLookup(SymTab_T *st, char *key) {
-    if (st == NULL || st->global == NULL) {
-        return NULL;
-    }
+    //kluc, ktory nie je atomom, nemoze byt ani v tabulke
+    return SymTabLookupAtom(st, AtomFind(key, StrHash(key)));
+}
 
-    //hladanie od posledneho lokalneho az po globalny
-    TSBlock_T *currentBlock = st->local;
-    TSData_T *result = NULL;
-    while (currentBlock != NULL) {
-        result = SymTabBlockLookUp(currentBlock, key);
-        if(result != NULL) {
-            return result;
-        }
-        currentBlock = currentBlock->prev;
+TSData_T *SymTabLookupAtom(SymTab_T *st, atom_T *key) {
+    if (st == NULL || st->global == NULL || key == NULL) {
+        return NULL;
     }
 
-    return NULL;
+    //najvnutornejsi prvok s danym klucom je priamo v rozptylovej tabulke
+    TIMER_BEGIN(TIMER_SYMTAB);
+    TSSlot_T *slot = SymTabFind(st, key);
+    TIMER_END();
+    return slot != NULL ? slot->data : NULL;
 }
 
 TSData_T *SymTabLookupGlobal(SymTab_T *st, char *key) {
+    return SymTabLookupGlobalAtom(st, AtomFind(key, StrHash(key)));
+}
+
+TSData_T *SymTabLookupGlobalAtom(SymTab_T *st, atom_T *key) {
 
     if(st->global == NULL) {
         return NULL;
     }
 
-    return SymTabBlockLookUp(st->global, key);
+    TIMER_BEGIN(TIMER_SYMTAB);
+    TSData_T *data = SymTabBlockLookUp(st, st->global, key);
+    TIMER_END();
+    return data;
 }
 
 TSData_T *SymTabLookupLocal(SymTab_T *st, char *key) {
+    return SymTabLookupLocalAtom(st, AtomFind(key, StrHash(key)));
+}
+
+TSData_T *SymTabLookupLocalAtom(SymTab_T *st, atom_T *key) {
 
     if(st->local == NULL) {
         return NULL;
     }
 
-    return SymTabBlockLookUp(st->local, key);
+    TIMER_BEGIN(TIMER_SYMTAB);
+    TSData_T *data = SymTabBlockLookUp(st, st->local, key);
+    TIMER_END();
+    return data;
 }
 
 void SymTabInsertGlobal(SymTab_T *st, TSData_T *elem) {
@@ -202,7 +454,10 @@ void SymTabInsertGlobal(SymTab_T *st, TSData_T *elem) {
         exit(99);
     }
 
-    SymTabBlockInsert(st->global, elem);
+    TIMER_BEGIN(TIMER_SYMTAB);
+    SymTabBlockInsert(st, st->global, elem);
+    if (stats_enabled) statsSymbol(st->global->depth);
+    TIMER_END();
 }
 
 void SymTabInsertLocal(SymTab_T *st, TSData_T *elem) {
@@ -212,7 +467,10 @@ void SymTabInsertLocal(SymTab_T *st, TSData_T *elem) {
             exit(99);
         }
 
-    SymTabBlockInsert(st->local, elem);
+    TIMER_BEGIN(TIMER_SYMTAB);
+    SymTabBlockInsert(st, st->local, elem);
+    if (stats_enabled) statsSymbol(st->local->depth);
+    TIMER_END();
 }
 
 bool SymTabCheckLocalReturn(SymTab_T *st) {
@@ -223,48 +481,4 @@ void SymTabModifyLocalReturn(SymTab_T *st, bool value) {
     st->local->has_return = value;
 }
 
-TSData_T *SymTabBlockLookUp(TSBlock_T *block, char *key) {
-
-    //primarny a sekundarny hash
-    size_t h1 = hashOne(key) % SYMTABLE_MAX_SIZE;
-    size_t h2 = (hashTwo(key) % (SYMTABLE_MAX_SIZE - 1)) + 1;
-    for (size_t i = 0; i < SYMTABLE_MAX_SIZE; i++) {
-        //index v tabulke
-        size_t index = (h1 + i * h2) % SYMTABLE_MAX_SIZE;
-        if (block->array[index] == NULL) {
-            return NULL;
-        }
-        else {
-            //ak sa najde zhoda, vratime prvok s danym klucom
-            if (strcmp(block->array[index]->id, key) == 0) {
-                return block->array[index];
-            }
-        }
-    }
-    
-    return NULL;
-}
-
-void SymTabBlockInsert(TSBlock_T *block, TSData_T *elem) {
-
-    if(block->used + 1 == SYMTABLE_MAX_SIZE) {
-        fprintf(stderr, "SymTabBlockInsert() - symbol table is full\n");
-        exit(99);
-    }
-
-    //primarny a sekundarny hash
-    size_t h1 = hashOne(elem->id) % SYMTABLE_MAX_SIZE;
-    size_t h2 = (hashTwo(elem->id) % (SYMTABLE_MAX_SIZE - 1)) + 1;
-    for (size_t i = 0; i < SYMTABLE_MAX_SIZE; i++)
-    {
-        //index v tabulke
-        size_t index = (h1 + i * h2) % SYMTABLE_MAX_SIZE;
-        //ak je na danom indexe volne miesto, vlozime tam prvok
-        if (block->array[index] == NULL) {
-            block->array[index] = elem;
-            block->used++;
-            return;
-        }
-    }
-}
 /* Koniec súboru symtable.c */
@@ -12,7 +12,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include "strR.h"
-#include "dll.h"
+#include "atom.h"
 
 #define SYM_TYPE_FUNC       'F'
 #define SYM_TYPE_INT        'i'
@@ -26,7 +26,8 @@
 #define SYM_TYPE_UNKNOWN    'U'
 #define SYM_TYPE_NIL        'N'
 
-#define SYMTABLE_MAX_SIZE 997 // musí byť prvočíslo
+#define SYMTABLE_INIT_SIZE 256 // počiatočná veľkosť rozptylovej tabuľky, musí byť mocnina dvojky
+#define SYMTABLE_MIGRATE_STEP 4 // počet položiek starej tabuľky presunutých pri jednom vložení
 
 /**
  * @brief Signatúra funkcie
@@ -34,8 +35,8 @@
 typedef struct func_signature {
     char ret_type;        ///< typ návratovej hodnoty
     str_T par_types;   ///< dátové typy parametrov
-    DLLstr_T par_names;   ///< názvy parametrov
-    DLLstr_T par_ids;     ///< identifikátory parametrov používané vo vnútri funkcie
+    atomList_T par_names; ///< názvy parametrov
+    atomList_T par_ids;   ///< identifikátory parametrov používané vo vnútri funkcie, "_" ak sa nepoužíva
     // func <názov_funkcie> (par_name par_id : par_type, ...) -> ret_type {}
 } func_sig_T;
 
@@ -43,32 +44,61 @@ typedef struct func_signature {
  * @brief Dátový element / prvok tabuľky symbolov, obsahuje informácie o symbole/identifikátore premennej alebo funkcie
  */
 typedef struct TSData {
-    char *id;       ///< názov identifikátoru, zároveň kľúč v tabuľke
-    str_T codename; ///< identifikátor v cieľovom kóde
+    atom_T *id;     ///< názov identifikátoru, zároveň kľúč v tabuľke
+    atom_T *codename; ///< identifikátor v cieľovom kóde, NULL kým nie je určený
     char type;      ///< typ premennej/funkcia, používa hodnoty SYM_TYPE_XXX
     bool let;       ///< true znamená premenná let inak var 
     bool init;      ///< true znamená, že je premenná inicializovaná alebo funkcia definovaná
     func_sig_T *sig; ///< signatúra funkcie, v prípade premennej sig=NULL
+    struct TSBlock *block;      ///< blok, do ktorého bol prvok vložený
+    struct TSData *shadowed;    ///< prvok s rovnakým kľúčom z obklopujúceho bloku, ktorý je týmto prvkom zatienený
+    struct TSData *block_next;  ///< predchádzajúci prvok vložený do toho istého bloku
 } TSData_T;
 
 /**
  * @brief Dielčí blok/rámec tabuľky symbolov
+ * @details Blok neobsahuje vlastnú rozptylovú tabuľku, iba zoznam svojich prvkov, podľa ktorého
+ * sa pri odstránení bloku obnoví stav spoločnej rozptylovej tabuľky.
  */
 typedef struct TSBlock {
-    size_t used;            ///< počet zaplnených miest
+    size_t used;            ///< počet prvkov v bloku
+    size_t depth;           ///< hĺbka zanorenia, globálny blok má hĺbku 0
     struct TSBlock *prev;   ///< ukazateľ na predchádzajúci blok
     struct TSBlock *next;   ///< ukazateľ na nasledujúci blok
     bool has_return;        ///< pomocná premenná pre sémantickú analýzu, značí či daný blok kódu obsahoval príkaz return
-    TSData_T *array[];      ///< pole ukazateľov na symboly
+    TSData_T *symbols;      ///< prvky bloku od naposledy vloženého
 } TSBlock_T;
 
+/**
+ * @brief Položka rozptylovej tabuľky
+ * @details Ukazuje na najvnútornejší viditeľný prvok s daným kľúčom, ostatné prvky s rovnakým
+ * kľúčom sú dostupné cez TSData_T::shadowed. Prázdna položka má data=NULL.
+ * Kľúče sú atómy, porovnávajú sa iba ukazatele.
+ */
+typedef struct TSSlot {
+    unsigned long hash;     ///< rozptylová hodnota kľúča, kópia data->id->hash
+    TSData_T *data;         ///< najvnútornejší prvok s daným kľúčom
+} TSSlot_T;
+
 /**
  * @brief Tabuľka symbolov
  * @details Ak tabuľka obsahuje len globálny rámec, potom local ukazuje aj na globálny.
+ * Všetky bloky zdieľajú jednu rozptylovú tabuľku s otvoreným adresovaním (lineárne skúšanie),
+ * preto vyhľadanie symbolu nezávisí od počtu zanorených blokov.
+ * Tabuľka sa zväčšuje postupne: po zdvojnásobení ostávajú nepresunuté položky v old_slots
+ * a každé vloženie presunie do novej tabuľky niekoľko ďalších celých zhlukov.
  */
 typedef struct SymbolsTable {
     TSBlock_T *global;      ///< ukazateľ na globálny blok (prvý blok)
     TSBlock_T *local;       ///< ukazateľ na lokálny blok  (posledný blok)
+    TSSlot_T *slots;        ///< rozptylová tabuľka, veľkosť je mocnina dvojky
+    size_t size;            ///< počet položiek rozptylovej tabuľky
+    size_t used;            ///< počet rôznych kľúčov v slots aj old_slots
+    TSSlot_T *old_slots;    ///< pôvodná tabuľka počas postupného zväčšovania, inak NULL
+    size_t old_size;        ///< počet položiek pôvodnej tabuľky
+    size_t migrate_pos;     ///< index nasledujúcej presúvanej položky pôvodnej tabuľky
+    size_t migrate_left;    ///< počet položiek pôvodnej tabuľky, ktoré ešte neboli prejdené
+    TSBlock_T *spare;       ///< odstránené bloky pripravené na opätovné použitie
 } SymTab_T;
 
 /**
@@ -79,11 +109,18 @@ func_sig_T *SymTabCreateFuncSig();
 
 /**
  * @brief Alokuje prvok tabuľky symbolov
- * @param key Kľúč, ktorý sa uloží do prvku
+ * @param key Kľúč, ktorý sa internuje a uloží do prvku
  * @return Ukazateľ na alokovaný prvok, NULL v prípade neúspechu
 */
 TSData_T *SymTabCreateElement(char *key);
 
+/**
+ * @brief Alokuje prvok tabuľky symbolov s kľúčom v podobe atómu
+ * @param key Kľúč, napr. token_T::atom identifikátoru
+ * @return Ukazateľ na alokovaný prvok, NULL v prípade neúspechu
+*/
+TSData_T *SymTabCreateElementAtom(atom_T *key);
+
 /**
  * @brief Dealokuje zdroje používané prvkom tabuľky symbolov
 */
@@ -97,12 +134,13 @@ void SymTabInit(SymTab_T *st);
 
 /**
  * @brief Vytvorí a pridá do tabuľky symbolov nový dielčí lokálny rámec/blok
- * @return true v prípade úspechu, inak false
+ * @details Blok sa prednostne použije z predtým odstránených blokov, cena nezávisí od veľkosti tabuľky.
 */
 void SymTabAddLocalBlock(SymTab_T *st);
 
 /**
  * @brief Uvoľní všetok obsah alokovaný v poslednom lokálnom bloku tabuľky a odstráni tento blok z tabuľky.
+ * @details Prejdú sa iba prvky bloku, zatienené prvky z obklopujúcich blokov sa opäť stanú viditeľnými.
 */
 void SymTabRemoveLocalBlock(SymTab_T *st);
 
@@ -113,12 +151,20 @@ void SymTabDestroy(SymTab_T *st);
 
 /**
  * @brief Vyhľadá tabuľke symbolov prvú položku s daným kľúčom/symbolom. Vyhľadáva od posledného lokálneho až po globálny.
+ * @details Najvnútornejší prvok je priamo v rozptylovej tabuľke, vyhľadanie nezávisí od hĺbky zanorenia.
  * @param st tabuľka symbolov
  * @param key hľadaný klúč/symbol
  * @return položka s daným kľúčom alebo NULL ak sa v tabuľke nenachádza
 */
 TSData_T *SymTabLookup(SymTab_T *st, char *key);
 
+/**
+ * @brief SymTabLookup s kľúčom v podobe atómu
+ * @details Kľúč sa porovnáva iba ako ukazateľ, znaky kľúča sa nečítajú.
+ * @param key kľúč, napr. token_T::atom identifikátoru
+*/
+TSData_T *SymTabLookupAtom(SymTab_T *st, atom_T *key);
+
 /**
  * @brief Vyhľadá len v globálnom bloku tabuľky symbolov položku s daným kľúčom/symbolom.
  * @param st tabuľka symbolov
@@ -127,6 +173,12 @@ TSData_T *SymTabLookup(SymTab_T *st, char *key);
 */
 TSData_T *SymTabLookupGlobal(SymTab_T *st, char *key);
 
+/**
+ * @brief SymTabLookupGlobal s kľúčom v podobe atómu
+ * @param key kľúč, napr. token_T::atom identifikátoru
+*/
+TSData_T *SymTabLookupGlobalAtom(SymTab_T *st, atom_T *key);
+
 /**
  * @brief Vyhľadá len v lokálnom bloku tabuľky symbolov položku s daným kľúčom/symbolom.
  * @param st tabuľka symbolov
@@ -135,6 +187,12 @@ TSData_T *SymTabLookupGlobal(SymTab_T *st, char *key);
 */
 TSData_T *SymTabLookupLocal(SymTab_T *st, char *key);
 
+/**
+ * @brief SymTabLookupLocal s kľúčom v podobe atómu
+ * @param key kľúč, napr. token_T::atom identifikátoru
+*/
+TSData_T *SymTabLookupLocalAtom(SymTab_T *st, atom_T *key);
+
 /**
  * @brief Vloží do globálneho bloku tabuľky symbolov nový prvok.
  * @param st tabuľka symbolov
@@ -162,9 +220,5 @@ bool SymTabCheckLocalReturn(SymTab_T *st);
 */
 void SymTabModifyLocalReturn(SymTab_T *st, bool value);
 
-TSData_T *SymTabBlockLookUp(TSBlock_T *block, char *key);
-
-void SymTabBlockInsert(TSBlock_T *block, TSData_T *elem);
-
 #endif // ifndef _SYMTABLE_H_
 /* Koniec súboru symtable.h */
@@ -7,6 +7,9 @@
 # bash test.sh symtable
 # bash test.sh syntax_dbg
 # bash test.sh semantic_dbg
+# bash test.sh optimizer
+# bash test.sh emit
+# bash test.sh benchmark
 
 if [ $# -gt 0 ]; then
     if [ ! -d "tests/$1" ]; then 
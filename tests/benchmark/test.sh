@@ -0,0 +1,244 @@
+#!/bin/bash
+
+# výkonnostné testy prekladača, vstupy sa generujú do adresára gen/
+# loops ... N najvrchnejších cyklov, v každom K definícií premenných (presun DEFVAR pred cyklus)
+# symbols ... G globálnych premenných a F funkcií (zväčšovanie tabuľky symbolov)
+# emit ... výpis viac megabajtov cieľového kódu do súboru (-o) a na stdout, priepustnosť z --emit-report
+# stream ... maximálna rezidentná pamäť pri preklade hlavného tela veľkosti MAIN_MB (predvolene 20 MB) s odkladaním a bez neho
+# substring ... výrez reťazca dĺžky 1 KB až 1 MB (čas interpretu)
+# instructions ... počet vykonaných inštrukcií programov z tests/system_run, výrazy na zásobníku, s --tac, s --rotate-loops a s --inline=16
+
+make || exit 1
+
+echo "Executing benchmarks"
+
+mkdir -p gen
+TIMEFORMAT="%R"
+bench_ok=true
+
+# vygeneruje program s $1 cyklami, v tele každého cyklu je $2 definícií premenných
+gen_loops() {
+    awk -v n="$1" -v k="$2" 'BEGIN {
+        print "var i = 0"
+        for (l = 0; l < n; l++) {
+            print "i = 0"
+            print "while i < 2 {"
+            for (j = 0; j < k; j++) print "    let x" j " = i + " j
+            print "    i = i + 1"
+            print "}"
+        }
+    }'
+}
+
+# vygeneruje program s $1 globálnymi premennými a $2 funkciami
+gen_symbols() {
+    awk -v g="$1" -v f="$2" 'BEGIN {
+        for (i = 0; i < g; i++) print "let g" i " = " i
+        for (i = 0; i < f; i++) {
+            print "func f" i "(_ x : Int) -> Int {"
+            print "    return x + " i
+            print "}"
+        }
+        print "let r = f" (f - 1) "(g" (g - 1) ")"
+        print "write(r)"
+    }'
+}
+
+# zmeria čas prekladu súboru $1 v sekundách
+compile_time() {
+    { time ./main.out <"$1" >/dev/null 2>&1; } 2>&1
+}
+
+echo "loops: N outermost loops, 20 hoisted variables each"
+printf "%8s %10s %14s\n" "N" "time [s]" "us per loop"
+first_per_loop=""
+for n in 1000 2000 4000 8000 16000
+do
+    gen_loops ${n} 20 >"gen/loops_${n}.swift"
+    t=$(compile_time "gen/loops_${n}.swift")
+    per_loop=$(awk -v t="${t}" -v n="${n}" 'BEGIN { printf "%.2f", t * 1000000 / n }')
+    printf "%8d %10s %14s\n" "${n}" "${t}" "${per_loop}"
+    [ -z "${first_per_loop}" ] && first_per_loop=${per_loop}
+    last_per_loop=${per_loop}
+done
+# pri lineárnej zložitosti je čas na jeden cyklus približne konštantný
+if awk -v a="${first_per_loop}" -v b="${last_per_loop}" 'BEGIN { exit !(b > 3 * a) }'; then
+    echo "[WARN] loops: time per loop grows with N"
+    bench_ok=false
+fi
+
+echo "symbols: 1000000 global variables, 100000 functions"
+gen_symbols 1000000 100000 >"gen/symbols.swift"
+if t=$(compile_time "gen/symbols.swift"); then
+    printf "%8s %10s\n" "" "${t}"
+else
+    echo "[FAIL] symbols: compilation failed"
+    bench_ok=false
+fi
+
+echo "emit: output of gen/loops_16000.swift"
+printf "%8s %12s %10s %10s\n" "target" "bytes" "time [s]" "MB/s"
+for target in file stdout
+do
+    if [ ${target} = file ]; then
+        report=$(./main.out -o gen/emit.prog --emit-report <gen/loops_16000.swift 2>&1 >/dev/null)
+    else
+        report=$(./main.out --emit-report <gen/loops_16000.swift 2>&1 >gen/emit_stdout.prog)
+    fi
+    # emit: N bytes in S s (X MB/s)
+    echo "${report}" | awk -v t="${target}" '/^emit:/ { gsub(/[()]/, ""); printf "%8s %12s %10s %10s\n", t, $2, $5, $7 }'
+done
+if ! cmp -s gen/emit.prog gen/emit_stdout.prog; then
+    echo "[FAIL] emit: output written with -o differs from stdout"
+    bench_ok=false
+fi
+
+# vygeneruje hlavné telo programu veľkosti aspoň $1 MB, príkazy mimo cyklov a každý stý príkaz cyklus
+gen_main() {
+    awk -v mb="$1" 'BEGIN {
+        print "var a = 0"
+        print "var s = \"\""
+        limit = mb * 1024 * 1024
+        bytes = 0
+        for (i = 0; bytes < limit; i++) {
+            line = "a = a + " i " * 2 - 1\n"
+            line = line "s = \"x\" + s\n"
+            line = line "if a > " i " { write(a, \"\\n\") } else { a = a - 1 }\n"
+            if (i % 100 == 0) line = line "while a < " i " {\n    let b = a + 1\n    a = b\n}\n"
+            printf "%s", line
+            bytes += length(line)
+        }
+    }'
+}
+
+# preloží súbor $1 s prepínačmi $2.. do gen/main.prog, vypíše čas a maximálnu rezidentnú pamäť prekladača v KB
+peak_rss() {
+    python3 -c '
+import resource, subprocess, sys, time
+start = time.time()
+with open(sys.argv[1]) as src:
+    code = subprocess.run(["./main.out", "-o", "gen/main.prog"] + sys.argv[2:], stdin=src).returncode
+if code != 0: sys.exit(1)
+print("%.3f %d" % (time.time() - start, resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss))
+' "$@"
+}
+
+MAIN_MB=${MAIN_MB:-20}
+echo "stream: main body of ${MAIN_MB} MB, peak resident memory (stdin is a file, the source is mapped)"
+printf "%16s %10s %12s\n" "option" "time [s]" "peak [KB]"
+if command -v python3 >/dev/null; then
+    gen_main "${MAIN_MB}" >"gen/main.swift"
+    for option in default --stream=65536
+    do
+        [ ${option} = default ] && args="" || args=${option}
+        if ! result=$(peak_rss gen/main.swift ${args}); then
+            echo "[FAIL] stream: compilation failed with ${option}"
+            bench_ok=false
+            continue
+        fi
+        printf "%16s %10s %12s\n" "${option}" ${result}
+        mv gen/main.prog "gen/main_${option#--}.prog"
+    done
+    if ! cmp -s "gen/main_default.prog" "gen/main_stream=65536.prog"; then
+        echo "[FAIL] stream: output differs from the output without streaming"
+        bench_ok=false
+    fi
+else
+    echo "python3 not found, skipped"
+fi
+
+echo "memory: allocations of gen/loops_16000.swift and gen/symbols.swift by subsystem"
+for f in loops_16000 symbols
+do
+    report=$(./main.out --mem-report <"gen/${f}.swift" 2>&1 >/dev/null)
+    echo "${report}" | awk -v f="${f}" '$1 == "total" { printf "%16s peak %12s B, %10s allocations\n", f, $6, $2 }'
+    # po destroyParser nesmie zostať nič alokované
+    if echo "${report}" | grep -q "^leaked:"; then
+        echo "[FAIL] memory: ${f} $(echo "${report}" | grep "^leaked:")"
+        bench_ok=false
+    fi
+done
+
+# vygeneruje program, ktorý zdvojovaním vytvorí reťazec dĺžky $1 a vypíše dĺžku jeho výrezu bez prvého a posledného znaku
+gen_substring() {
+    awk -v n="$1" 'BEGIN {
+        print "var s = \"0123456789abcdef\""
+        print "var n = 16"
+        print "while n < " n " {"
+        print "    s = s + s"
+        print "    n = n * 2"
+        print "}"
+        print "let e = n - 1"
+        print "let t = substring(of: s, startingAt: 1, endingBefore: e)"
+        print "if let t {"
+        print "    let l = length(t)"
+        print "    write(l)"
+        print "} else {}"
+    }'
+}
+
+echo "substring: slice of a string of N characters, interpreter time"
+printf "%8s %10s %14s\n" "N" "time [s]" "us per KB"
+first_per_kb=""
+for n in 1024 16384 65536 262144 1048576
+do
+    gen_substring ${n} >"gen/substring_${n}.swift"
+    ./main.out <"gen/substring_${n}.swift" >"gen/substring_${n}.prog"
+    if ! t=$( { time ../system_run/ic23int "gen/substring_${n}.prog" >"gen/substring_${n}.out"; } 2>&1 ) ||
+       [ "$(cat "gen/substring_${n}.out")" != "$((n - 2))" ]; then
+        echo "[FAIL] substring: wrong result for N=${n}"
+        bench_ok=false
+        continue
+    fi
+    per_kb=$(awk -v t="${t}" -v n="${n}" 'BEGIN { printf "%.2f", t * 1000000 * 1024 / n }')
+    printf "%8d %10s %14s\n" "${n}" "${t}" "${per_kb}"
+    # pri malých N prevláda čas spustenia interpretu
+    [ ${n} -eq 16384 ] && first_per_kb=${per_kb}
+    last_per_kb=${per_kb}
+done
+if awk -v a="${first_per_kb}" -v b="${last_per_kb}" 'BEGIN { exit !(b > 3 * a) }'; then
+    echo "[WARN] substring: time per KB grows with N"
+    bench_ok=false
+fi
+
+# spočíta vykonané inštrukcie programu $1 so vstupom $2, výstup porovná s $3
+count_instructions() {
+    local out
+    out=$(timeout 5 ../system_run/ic23int -v "$1" <"$2" 2>"gen/trace.txt") || return 1
+    [ "${out}" == "$(cat "$3")" ] || return 1
+    grep -c "Executing instruction" "gen/trace.txt"
+}
+
+echo "instructions: executed instructions of tests/system_run programs"
+printf "%-24s %10s %10s %10s %10s\n" "program" "stack" "--tac" "--rotate" "--inline"
+total_stack=0
+total_tac=0
+total_rotate=0
+total_inline=0
+for f in ../system_compile/*.swift
+do
+    sample=$(basename "${f%.*}")
+    ./main.out <"${f}" >"gen/${sample}.prog" 2>/dev/null
+    ./main.out --tac <"${f}" >"gen/${sample}.tac.prog" 2>/dev/null
+    ./main.out --rotate-loops <"${f}" >"gen/${sample}.rotate.prog" 2>/dev/null
+    ./main.out --inline=16 <"${f}" >"gen/${sample}.inline.prog" 2>/dev/null
+    run="../system_run/${sample}"
+    if ! stack=$(count_instructions "gen/${sample}.prog" "${run}.stdin" "${run}.stdout") ||
+       ! tac=$(count_instructions "gen/${sample}.tac.prog" "${run}.stdin" "${run}.stdout") ||
+       ! rotate=$(count_instructions "gen/${sample}.rotate.prog" "${run}.stdin" "${run}.stdout") ||
+       ! inline=$(count_instructions "gen/${sample}.inline.prog" "${run}.stdin" "${run}.stdout"); then
+        echo "[FAIL] instructions: ${sample} produced a different output"
+        bench_ok=false
+        continue
+    fi
+    printf "%-24s %10d %10d %10d %10d\n" "${sample}" "${stack}" "${tac}" "${rotate}" "${inline}"
+    total_stack=$((total_stack + stack))
+    total_tac=$((total_tac + tac))
+    total_rotate=$((total_rotate + rotate))
+    total_inline=$((total_inline + inline))
+done
+printf "%-24s %10d %10d %10d %10d\n" "total" "${total_stack}" "${total_tac}" "${total_rotate}" "${total_inline}"
+
+if ${bench_ok}; then
+    echo "[PASS] - Everything scales linearly"
+fi
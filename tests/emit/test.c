@@ -0,0 +1,96 @@
+#include "../../emit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int failures = 0;
+
+#define TEST(cond)                                    \
+    if (!(cond))                                      \
+    {                                                 \
+        printf("FAIL[ln %d]\t%s\n", __LINE__, #cond); \
+        failures++;                                   \
+    }
+
+#define FILE_NAME "emit_test.prog"
+
+/**
+ * @brief Načíta celý súbor, vracia alokovaný obsah a jeho dĺžku v len
+*/
+char *readFile(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    *len = (size_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc(*len + 1);
+    if (data != NULL && fread(data, 1, *len, f) != *len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+int main()
+{
+    size_t len;
+    char *data;
+
+    // krátky výstup, súbor je predalokovaný na viac, než sa zapíše
+    TEST(emitOpen(FILE_NAME));
+    emitReserve(1 << 20);
+    emitString(".IFJcode23\n");
+    emitText("JUMP !main\nXYZ", 11);
+    TEST(emitBytes() == 22);
+    emitClose();
+    data = readFile(FILE_NAME, &len);
+    TEST(data != NULL && len == 22);
+    TEST(data != NULL && memcmp(data, ".IFJcode23\nJUMP !main\n", 22) == 0);
+    free(data);
+
+    // výstup cez viac vyrovnávacích pamätí aj cez viac volaní writev
+    size_t lines = (EMIT_BUFFERS + 2) * EMIT_BUFFER_SIZE / 10;
+    char line[16];
+    TEST(emitOpen(FILE_NAME));
+    for (size_t i = 0; i < lines; i++) {
+        snprintf(line, sizeof(line), "%09zu\n", i);
+        emitString(line);
+    }
+    // jeden zápis dlhší než vyrovnávacia pamäť
+    char *big = malloc(EMIT_BUFFER_SIZE * 3);
+    memset(big, 'a', EMIT_BUFFER_SIZE * 3);
+    emitText(big, EMIT_BUFFER_SIZE * 3);
+    TEST(emitBytes() == lines * 10 + EMIT_BUFFER_SIZE * 3);
+    emitClose();
+    data = readFile(FILE_NAME, &len);
+    TEST(data != NULL && len == lines * 10 + EMIT_BUFFER_SIZE * 3);
+    bool ok = data != NULL;
+    for (size_t i = 0; ok && i < lines; i++) {
+        snprintf(line, sizeof(line), "%09zu\n", i);
+        ok = memcmp(data + i * 10, line, 10) == 0;
+    }
+    TEST(ok);
+    TEST(data != NULL && memcmp(data + lines * 10, big, EMIT_BUFFER_SIZE * 3) == 0);
+    free(data);
+    free(big);
+
+    // opätovné otvorenie súbor skráti
+    TEST(emitOpen(FILE_NAME));
+    emitClose();
+    data = readFile(FILE_NAME, &len);
+    TEST(data != NULL && len == 0);
+    free(data);
+
+    TEST(!emitOpen("nonexistent_dir/" FILE_NAME));
+    remove(FILE_NAME);
+
+    if(failures != 0)
+    {
+        printf("Total tests failed: %d\n", failures);
+    }
+    else{
+        printf("Everything OK\n");
+    }
+    return 0;
+}
@@ -0,0 +1,5 @@
+#!/bin/bash
+
+make test.out  || exit 1
+echo "Executing emit unit tests"
+./test.out
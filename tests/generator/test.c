@@ -12,10 +12,34 @@ int failures = 0;
         failures++;                                   \
     }
 
+/**
+ * @brief Textový tvar inštrukcie bloku, back = 0 je posledná inštrukcia
+*/
+char *ins(codeBlock_T *block, size_t back)
+{
+    static str_T text;
+    static bool init = false;
+    if (!init) {
+        StrInit(&text);
+        init = true;
+    }
+    StrFillWith(&text, "");
+    if (back < block->used) genRenderIns(&(block->ins[block->used - 1 - back]), &text);
+    return StrRead(&text);
+}
+
+/**
+ * @brief Blok, do ktorého generátor práve zapisuje
+*/
+codeBlock_T *current()
+{
+    if (parser_inside_fn_def) return &(code_fn.blocks[code_fn.used - 1]);
+    return &code_main;
+}
+
 int main()
 {
-    DLLstr_Init(&code_main);
-    DLLstr_Init(&code_fn);
+    genInit();
 
     str_T s;
     StrInit(&s);
@@ -73,29 +97,42 @@ int main()
 
     StrDestroy(&s);
 
-    genCode("ADD", "GF@x", "GF@y", "LF@z");
-    if(parser_inside_fn_def) {
-        TEST(strcmp(code_fn.last->string, "ADD GF@x GF@y LF@z") == 0);
-    }
-    else {
-        TEST(strcmp(code_main.last->string, "ADD GF@x GF@y LF@z") == 0);
-    }
-
-    genCode("PUSHFRAME", NULL, NULL, NULL);
-    if(parser_inside_fn_def) {
-        TEST(strcmp(code_fn.last->string, "PUSHFRAME") == 0);
-    }
-    else {
-        TEST(strcmp(code_main.last->string, "PUSHFRAME") == 0);
-    }
-
-    genCode("DEFVAR", NULL, "GF@x", NULL);
-    if(parser_inside_fn_def) {
-        TEST(strcmp(code_fn.last->string, "DEFVAR GF@x") == 0);
-    }
-    else {
-        TEST(strcmp(code_main.last->string, "DEFVAR GF@x") == 0);
-    }
+    genCode(INS_ADD, "GF@x", "GF@y", "LF@z");
+    TEST(strcmp(ins(current(), 0), "ADD GF@x GF@y LF@z") == 0);
+    TEST(current()->ins[current()->used - 1].op[0].kind == OPD_VAR);
+    TEST(current()->ins[current()->used - 1].op[0].sub == FRAME_GF);
+    TEST(current()->ins[current()->used - 1].op[2].sub == FRAME_LF);
+
+    genCode(INS_PUSHFRAME, NULL, NULL, NULL);
+    TEST(strcmp(ins(current(), 0), "PUSHFRAME") == 0);
+
+    genCode(INS_DEFVAR, "GF@x", NULL, NULL);
+    TEST(strcmp(ins(current(), 0), "DEFVAR GF@x") == 0);
+    // rovnaké kódové mená sú ten istý atóm
+    TEST(current()->ins[current()->used - 1].op[0].id == current()->ins[current()->used - 3].op[0].id);
+    TEST(current()->ins[current()->used - 1].op[0].id == AtomIntern("GF@x")->id);
+
+    // operandy z atómov, druh operandu určuje druh atómu
+    genCodeAtoms(INS_MOVE, AtomIntern("LF@z"), AtomIntern("float@0x1p+0"), NULL);
+    TEST(strcmp(ins(current(), 0), "MOVE LF@z float@0x1p+0") == 0);
+    TEST(current()->ins[current()->used - 1].op[0].id == current()->ins[current()->used - 4].op[2].id);
+    TEST(current()->ins[current()->used - 1].op[1].kind == OPD_CONST);
+    TEST(current()->ins[current()->used - 1].op[1].sub == CONST_FLOAT);
+    genCodeAtoms(INS_JUMPIFEQ, AtomIntern("&atom1"), AtomIntern("TF@t"), AtomIntern("nil@nil"));
+    TEST(strcmp(ins(current(), 0), "JUMPIFEQ &atom1 TF@t nil@nil") == 0);
+    TEST(current()->ins[current()->used - 1].op[0].kind == OPD_LABEL);
+    TEST(current()->ins[current()->used - 1].op[0].id == genLabel("&atom1"));
+    TEST(current()->ins[current()->used - 1].op[1].sub == FRAME_TF);
+
+    genCode(INS_PUSHS, "string@a\\032b@c", NULL, NULL);
+    TEST(strcmp(ins(current(), 0), "PUSHS string@a\\032b@c") == 0);
+    TEST(current()->ins[current()->used - 1].op[0].kind == OPD_CONST);
+    TEST(current()->ins[current()->used - 1].op[0].sub == CONST_STRING);
+
+    size_t slot = genLoopHoistSlot();
+    genCode(INS_LABEL, "&while25", NULL, NULL);
+    genCode(INS_ADD, "GF@x", "GF@x", "int@1");
+    TEST(current()->ins[current()->used - 3].code == INS_HOIST);
 
     DLLstr_T *variables = malloc(sizeof(DLLstr_T));
     if(variables == NULL) {
@@ -107,39 +144,40 @@ int main()
     DLLstr_InsertLast(variables, "LF@x$1");
     DLLstr_InsertLast(variables, "LF@y$2");
 
-    genDefVarsBeforeLoop("&while25", variables);
+    genDefVarsBeforeLoop(slot, variables);
+    genExpandHoists(current());
+    TEST(current()->hoists == 0);
 
-    if(parser_inside_fn_def) {
-        TEST(strcmp(code_fn.last->string, "DEFVAR LF@y$2") == 0);
-        TEST(strcmp(code_fn.last->prev->string, "DEFVAR LF@x$1") == 0);
-    }
-    else {
-        TEST(strcmp(code_main.last->string, "DEFVAR LF@y$2") == 0);
-        TEST(strcmp(code_main.last->prev->string, "DEFVAR LF@x$1") == 0);
-    }
+    TEST(strcmp(ins(current(), 0), "ADD GF@x GF@x int@1") == 0);
+    TEST(strcmp(ins(current(), 1), "LABEL &while25") == 0);
+    TEST(strcmp(ins(current(), 2), "DEFVAR LF@y$2") == 0);
+    TEST(strcmp(ins(current(), 3), "DEFVAR LF@x$1") == 0);
 
     DLLstr_Dispose(variables);
     free(variables);
 
-    DLLstr_T *variables2 = malloc(sizeof(DLLstr_T));
-    DLLstr_Init(variables2);
-    DLLstr_InsertLast(variables2, "a");
-    DLLstr_InsertLast(variables2, "b");
+    atomList_T params;
+    AtomListInit(&params);
+    AtomListAppend(&params, AtomIntern("a"));
+    AtomListAppend(&params, AtomIntern("b"));
 
     parser_inside_fn_def = true;
 
-    genFnDefBegin("main", variables2);
+    genFnDefBegin("main", &params);
 
-    TEST(strcmp(code_fn.last->prev->prev->prev->prev->prev->prev->string, "LABEL main") == 0);
-    TEST(strcmp(code_fn.last->prev->prev->prev->prev->prev->string, "CREATEFRAME") == 0);
-    TEST(strcmp(code_fn.last->prev->prev->prev->prev->string, "PUSHFRAME") == 0);
-    TEST(strcmp(code_fn.last->prev->prev->prev->string, "DEFVAR LF@a%") == 0);
-    TEST(strcmp(code_fn.last->prev->prev->string, "POPS LF@a%") == 0);
-    TEST(strcmp(code_fn.last->prev->string, "DEFVAR LF@b%") == 0);
-    TEST(strcmp(code_fn.last->string, "POPS LF@b%") == 0);
+    // každá funkcia má vlastný blok kódu
+    TEST(code_fn.used == 1);
+    TEST(code_fn.blocks[0].used == 7);
+    TEST(strcmp(ins(&code_fn.blocks[0], 6), "LABEL main") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[0], 5), "CREATEFRAME") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[0], 4), "PUSHFRAME") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[0], 3), "DEFVAR LF@a%") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[0], 2), "POPS LF@a%") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[0], 1), "DEFVAR LF@b%") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[0], 0), "POPS LF@b%") == 0);
+    TEST(code_fn.blocks[0].ins[0].op[0].kind == OPD_LABEL);
 
-    DLLstr_Dispose(variables2);
-    free(variables2);
+    AtomListDestroy(&params);
 
     DLLstr_T *variables3 = malloc(sizeof(DLLstr_T));
     DLLstr_Init(variables3);
@@ -148,22 +186,97 @@ int main()
 
     genFnCall("sum", variables3);
 
-    if(parser_inside_fn_def) {
-        TEST(strcmp(code_fn.last->prev->prev->string, "PUSH LF@x$1") == 0);
-        TEST(strcmp(code_fn.last->prev->string, "PUSH int@6") == 0);
-        TEST(strcmp(code_fn.last->string, "CALL sum") == 0);
-    }
-    else {
-        TEST(strcmp(code_main.last->prev->prev->string, "PUSH LF@x$1") == 0);
-        TEST(strcmp(code_main.last->prev->string, "PUSH int@6") == 0);
-        TEST(strcmp(code_main.last->string, "CALL sum") == 0);
-    }
+    TEST(strcmp(ins(current(), 2), "PUSHS LF@x$1") == 0);
+    TEST(strcmp(ins(current(), 1), "PUSHS int@6") == 0);
+    TEST(strcmp(ins(current(), 0), "CALL sum") == 0);
+    genFnDefEnd();
 
     DLLstr_Dispose(variables3);
     free(variables3);
 
-    DLLstr_Dispose(&code_fn);
-    DLLstr_Dispose(&code_main);
+    // rekurzívne volanie, ktorého výsledok sa hneď vracia, sa nahradí skokom na začiatok tela
+    AtomListInit(&params);
+    AtomListAppend(&params, AtomIntern("n"));
+    genFnDefBegin("fact", &params);
+    genCode(INS_DEFVAR, "LF@r$1", NULL, NULL);
+    genCode(INS_PUSHS, "LF@n%", NULL, NULL);
+    genCode(INS_CALL, "fact", NULL, NULL);
+    genCode(INS_POPFRAME, NULL, NULL, NULL);
+    genCode(INS_POPS, "LF@r$1", NULL, NULL);
+    genCode(INS_PUSHS, "LF@r$1", NULL, NULL);
+    TEST(genTailCall("fact", &params));
+    TEST(strcmp(ins(current(), 1), "POPS LF@n%") == 0);
+    TEST(strcmp(ins(current(), 0), "JUMP fact&body") == 0);
+
+    // volanie inej funkcie sa nenahradí
+    genCode(INS_PUSHS, "LF@n%", NULL, NULL);
+    genCode(INS_CALL, "sum", NULL, NULL);
+    genCode(INS_POPFRAME, NULL, NULL, NULL);
+    genCode(INS_CLEARS, NULL, NULL, NULL);
+    TEST(!genTailCall("fact", &params));
+    genCode(INS_RETURN, NULL, NULL, NULL);
+    genFnDefEnd();
+
+    // definície premenných tela sú pred náveštím, na ktoré sa skáče
+    TEST(strcmp(ins(&code_fn.blocks[1], 9), "DEFVAR LF@r$1") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[1], 8), "LABEL fact&body") == 0);
+    TEST(strcmp(ins(&code_fn.blocks[1], 7), "PUSHS LF@n%") == 0);
+    AtomListDestroy(&params);
+
+    // malá funkcia sa vloží do miesta volania s premenovanými premennými, návratová hodnota ostane na zásobníku
+    gen_inline_limit = 8;
+    AtomListInit(&params);
+    AtomListAppend(&params, AtomIntern("x"));
+    genFnDefBegin("dec", &params);
+    genCode(INS_DEFVAR, "LF@d$1", NULL, NULL);
+    genCode(INS_PUSHS, "LF@x%", NULL, NULL);
+    genCode(INS_PUSHS, "int@1", NULL, NULL);
+    genCode(INS_SUBS, NULL, NULL, NULL);
+    genCode(INS_POPS, "LF@d$1", NULL, NULL);
+    genCode(INS_PUSHS, "LF@d$1", NULL, NULL);
+    genCode(INS_RETURN, NULL, NULL, NULL);
+    genFnDefEnd();
+    AtomListDestroy(&params);
+
+    DLLstr_T args;
+    DLLstr_Init(&args);
+    DLLstr_InsertLast(&args, "GF@a$9");
+    parser_inside_fn_def = false; // volanie v hlavnom tele programu
+    TEST(genInlineCall("dec", &args, NULL));
+    TEST(strncmp(ins(current(), 7), "DEFVAR GF@x$", 12) == 0);
+    TEST(strncmp(ins(current(), 6), "DEFVAR GF@d$", 12) == 0);
+    TEST(strncmp(ins(current(), 5), "MOVE GF@x$", 10) == 0);
+    TEST(strcmp(ins(current(), 2), "SUBS") == 0);
+    TEST(strncmp(ins(current(), 0), "PUSHS GF@d$", 11) == 0);
+
+    // funkcie s volaním nahradeným skokom a funkcie nad limitom sa nevkladajú
+    TEST(!genInlineCall("fact", &args, NULL));
+    gen_inline_limit = 0;
+    TEST(!genInlineCall("dec", &args, NULL));
+    DLLstr_Dispose(&args);
+
+    // náveštia pridané po značke sa uvoľnia, staršie zostanú
+    genMark_T mark;
+    genMark(&mark);
+    unsigned int kept = genLabel("fact");
+    unsigned int added = genLabel("&if99");
+    TEST(added == mark.labels);
+    TEST(genRelease(&mark));
+    TEST(genLabel("fact") == kept);
+    TEST(genLabel("&else99") == added);
+    operand_T label = {OPD_LABEL, 0, added};
+    TEST(strcmp(genOperandText(&label), "&else99") == 0);
+    genMark(&mark);
+    genLabel("&if100");
+    parser_inside_fn_def = true; // nová funkcia môže náveštie používať, nič sa neuvoľní
+    genCode(INS_LABEL, "g", NULL, NULL);
+    genFnDefEnd();
+    parser_inside_fn_def = false;
+    TEST(!genRelease(&mark));
+    TEST(genLabel("&if100") == mark.labels);
+
+    genDestroy();
+    AtomPoolDestroy();
 
     if(failures != 0)
     {
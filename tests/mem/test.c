@@ -0,0 +1,71 @@
+#include "../../mem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int failures = 0;
+
+#define TEST(cond)                                    \
+    if (!(cond))                                      \
+    {                                                 \
+        printf("FAIL[ln %d]\t%s\n", __LINE__, #cond); \
+        failures++;                                   \
+    }
+
+int main()
+{
+    const memStats_T *gen = memStats(MEM_GENERATOR);
+    const memStats_T *str = memStats(MEM_STRING);
+
+    // vypnuté sledovanie nič nezapočíta
+    void *ptr = memMalloc(MEM_GENERATOR, 100);
+    TEST(ptr != NULL);
+    memFree(MEM_GENERATOR, ptr);
+    TEST(gen->allocs == 0 && gen->frees == 0 && gen->bytes == 0);
+
+    mem_enabled = true;
+    char *a = memMalloc(MEM_GENERATOR, 100);
+    TEST(a != NULL);
+    TEST(gen->allocs == 1);
+    TEST(gen->live >= 100 && gen->live == gen->bytes && gen->peak == gen->live);
+
+    // zväčšenie sa počíta ako realokácia, objem narastie iba o rozdiel
+    memset(a, 'x', 100);
+    a = memRealloc(MEM_GENERATOR, a, 10000);
+    TEST(a != NULL && a[99] == 'x');
+    TEST(gen->allocs == 1 && gen->reallocs == 1);
+    TEST(gen->live >= 10000 && gen->bytes == gen->live);
+    size_t grown = gen->live;
+
+    // zmenšenie znižuje živé bajty, špička zostáva
+    a = memRealloc(MEM_GENERATOR, a, 50);
+    TEST(gen->live < grown && gen->peak == grown && gen->bytes == grown);
+
+    // realloc z NULL je nová alokácia, calloc vynuluje obsah
+    char *s = memRealloc(MEM_STRING, NULL, 64);
+    int *zeros = memCalloc(MEM_STRING, 16, sizeof(int));
+    TEST(s != NULL && zeros != NULL);
+    TEST(str->allocs == 2 && str->reallocs == 0);
+    TEST(zeros != NULL && zeros[0] == 0 && zeros[15] == 0);
+    TEST(memPeak() >= grown);
+    TEST(memPeak() >= gen->live + str->live);
+
+    // uvoľnenie, značky sa navzájom neovplyvňujú
+    memFree(MEM_GENERATOR, a);
+    TEST(gen->frees == 1 && gen->live == 0);
+    TEST(str->live > 0);
+    memFree(MEM_STRING, s);
+    memFree(MEM_STRING, zeros);
+    memFree(MEM_STRING, NULL);
+    TEST(str->frees == 2 && str->live == 0);
+    TEST(memStats(MEM_SYMTAB)->allocs == 0);
+
+    if(failures != 0)
+    {
+        printf("Total tests failed: %d\n", failures);
+    }
+    else{
+        printf("Everything OK\n");
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include "../../optimizer.h"
+#include "../../strR.h"
+#include <stdio.h>
+#include <string.h>
+
+int failures = 0;
+
+#define TEST(cond)                                    \
+    if (!(cond))                                      \
+    {                                                 \
+        printf("FAIL[ln %d]\t%s\n", __LINE__, #cond); \
+        failures++;                                   \
+    }
+
+/**
+ * @brief Optimalizuje blok a vráti jeho textový tvar, inštrukcie sú oddelené znakom ';'
+*/
+char *optimizedBlock(codeBlock_T *block)
+{
+    static str_T text;
+    static bool init = false;
+    if (!init) {
+        StrInit(&text);
+        init = true;
+    }
+    optPeephole(block);
+    StrFillWith(&text, "");
+    for (size_t i = 0; i < block->used; i++) {
+        if (i > 0) StrAppend(&text, ';');
+        genRenderIns(&(block->ins[i]), &text);
+    }
+    block->used = 0;
+    return StrRead(&text);
+}
+
+/**
+ * @brief Optimalizuje code_main a vráti jeho textový tvar
+*/
+char *optimized()
+{
+    return optimizedBlock(&code_main);
+}
+
+/**
+ * @brief Počet použití pravidla s daným názvom
+*/
+size_t hits(const char *name)
+{
+    for (size_t r = 0; r < optRuleCount(); r++) {
+        if (strcmp(optRuleName(r), name) == 0) return optRuleHits(r);
+    }
+    return (size_t)-1;
+}
+
+int main()
+{
+    genInit();
+
+    // priradenie
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_POPS, "LF@b$2", NULL, NULL);
+    TEST(strcmp(optimized(), "MOVE LF@b$2 LF@a$1") == 0);
+    TEST(hits("push-pop-move") == 1);
+
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_POPS, "LF@a$1", NULL, NULL);
+    TEST(strcmp(optimized(), "") == 0);
+
+    // podmienky
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_PUSHS, "int@3", NULL, NULL);
+    genCode(INS_GTS, NULL, NULL, NULL);
+    genCode(INS_NOTS, NULL, NULL, NULL);
+    genCode(INS_PUSHS, "bool@false", NULL, NULL);
+    genCode(INS_JUMPIFEQS, "&if1", NULL, NULL);
+    TEST(strcmp(optimized(), "GT GF@!cond LF@a$1 int@3;JUMPIFEQ &if1 GF@!cond bool@true") == 0);
+    TEST(hits("not-jump-false") == 1);
+    TEST(hits("gt-jump") == 1);
+
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_PUSHS, "nil@nil", NULL, NULL);
+    genCode(INS_EQS, NULL, NULL, NULL);
+    genCode(INS_NOTS, NULL, NULL, NULL);
+    genCode(INS_PUSHS, "bool@false", NULL, NULL);
+    genCode(INS_JUMPIFEQS, "&while2!", NULL, NULL);
+    TEST(strcmp(optimized(), "JUMPIFEQ &while2! LF@a$1 nil@nil") == 0);
+
+    // x == x sa neprepíše, metapremenné sa viažu na rôzne operandy
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_EQS, NULL, NULL, NULL);
+    genCode(INS_PUSHS, "bool@false", NULL, NULL);
+    genCode(INS_JUMPIFEQS, "&if3", NULL, NULL);
+    TEST(strcmp(optimized(), "PUSHS LF@a$1;PUSHS LF@a$1;EQS;PUSHS bool@false;JUMPIFEQS &if3") == 0);
+
+    // konkatenácia
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_PUSHS, "string@x", NULL, NULL);
+    genCode(INS_POPS, VAR_TMP2, NULL, NULL);
+    genCode(INS_POPS, VAR_TMP1, NULL, NULL);
+    genCode(INS_CONCAT, VAR_TMP3, VAR_TMP1, VAR_TMP2);
+    genCode(INS_PUSHS, VAR_TMP3, NULL, NULL);
+    genCode(INS_POPS, "LF@b$2", NULL, NULL);
+    genCode(INS_MOVE, VAR_TMP3, "int@0", NULL);
+    genCode(INS_MOVE, VAR_TMP2, "int@0", NULL);
+    genCode(INS_MOVE, VAR_TMP1, "int@0", NULL);
+    genCode(INS_EXIT, "int@0", NULL, NULL);
+    TEST(strcmp(optimized(), "CONCAT LF@b$2 LF@a$1 string@x;EXIT int@0") == 0);
+
+    // pomocná premenná čítaná za náveštím sa nesmie zahodiť
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_POPS, VAR_TMP1, NULL, NULL);
+    genCode(INS_JUMP, "&l1", NULL, NULL);
+    genCode(INS_LABEL, "&l2", NULL, NULL);
+    genCode(INS_MOVE, VAR_TMP1, "int@0", NULL);
+    genCode(INS_LABEL, "&l1", NULL, NULL);
+    genCode(INS_WRITE, VAR_TMP1, NULL, NULL);
+    TEST(strcmp(optimized(), "MOVE GF@!tmp1 LF@a$1;JUMP &l1;LABEL &l2;MOVE GF@!tmp1 int@0;LABEL &l1;WRITE GF@!tmp1") == 0);
+
+    // pri volaní funkcie sa predpokladá, že pomocná premenná je živá
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    genCode(INS_POPS, VAR_TMP1, NULL, NULL);
+    genCode(INS_CALL, "f", NULL, NULL);
+    TEST(strcmp(optimized(), "MOVE GF@!tmp1 LF@a$1;CALL f") == 0);
+
+    // trojadresný kód, cieľ sa smie zhodovať s operandom
+    genCode(INS_MUL, "GF@!tmp4", "LF@a$1", "LF@a$1");
+    genCode(INS_ADD, "GF@!tmp4", "GF@!tmp4", "int@1");
+    genCode(INS_PUSHS, "GF@!tmp4", NULL, NULL);
+    genCode(INS_POPS, "LF@a$1", NULL, NULL);
+    genCode(INS_EXIT, "int@0", NULL, NULL);
+    TEST(strcmp(optimized(), "MUL GF@!tmp4 LF@a$1 LF@a$1;ADD LF@a$1 GF@!tmp4 int@1;EXIT int@0") == 0);
+    TEST(hits("add-move") == 1);
+
+    genCode(INS_GT, "GF@!tmp4", "LF@a$1", "int@0");
+    genCode(INS_NOT, "GF@!tmp4", "GF@!tmp4", NULL);
+    genCode(INS_PUSHS, "GF@!tmp4", NULL, NULL);
+    genCode(INS_PUSHS, "bool@false", NULL, NULL);
+    genCode(INS_JUMPIFEQS, "&if4", NULL, NULL);
+    genCode(INS_LABEL, "&if4", NULL, NULL);
+    genCode(INS_EXIT, "int@0", NULL, NULL);
+    TEST(strcmp(optimized(), "GT GF@!tmp4 LF@a$1 int@0;JUMPIFEQ &if4 GF@!tmp4 bool@true;LABEL &if4;EXIT int@0") == 0);
+    TEST(hits("not-jump-temp") == 1);
+
+    // na konci hlavného tela (alebo jeho odloženej časti) sú pomocné premenné mŕtve
+    genCode(INS_PUSHS, "GF@a$1", NULL, NULL);
+    genCode(INS_POPS, VAR_TMP1, NULL, NULL);
+    TEST(strcmp(optimized(), "") == 0);
+
+    // v bloku funkcie môže pomocnú premennú čítať volajúci
+    parser_inside_fn_def = true;
+    genCode(INS_PUSHS, "LF@a$1", NULL, NULL);
+    codeBlock_T *fn = &code_fn.blocks[code_fn.used - 1];
+    genCode(INS_POPS, VAR_TMP1, NULL, NULL);
+    TEST(strcmp(optimizedBlock(fn), "MOVE GF@!tmp1 LF@a$1") == 0);
+
+    // mŕtvy kód: za RETURN, vetva s konštantnou podmienkou, skok na nasledujúce náveštie
+    genCode(INS_LABEL, "f", NULL, NULL);
+    genCode(INS_JUMPIFEQ, "f&if1", "LF@a$1", "int@0");
+    genCode(INS_PUSHS, "int@1", NULL, NULL);
+    genCode(INS_RETURN, NULL, NULL, NULL);
+    genCode(INS_JUMP, "f&if1*", NULL, NULL);
+    genCode(INS_LABEL, "f&if1", NULL, NULL);
+    genCode(INS_JUMP, "f&if2", NULL, NULL);
+    genCode(INS_WRITE, "string@never", NULL, NULL);
+    genCode(INS_LABEL, "f&if2", NULL, NULL);
+    genCode(INS_LABEL, "f&if1*", NULL, NULL);
+    genCode(INS_PUSHS, "int@2", NULL, NULL);
+    genCode(INS_RETURN, NULL, NULL, NULL);
+    genCode(INS_CALL, "f", NULL, NULL);
+    TEST(optDeadCode(fn) == 6);
+    TEST(strcmp(optimizedBlock(fn), "LABEL f;JUMPIFEQ f&if1 LF@a$1 int@0;PUSHS int@1;RETURN;LABEL f&if1;PUSHS int@2;RETURN") == 0);
+    parser_inside_fn_def = false;
+
+    // náveštie na začiatku hlavného tela nie je cieľom CALL
+    genCode(INS_LABEL, "&if5", NULL, NULL);
+    genCode(INS_WRITE, "int@1", NULL, NULL);
+    TEST(optDeadCode(&code_main) == 1);
+    TEST(strcmp(optimized(), "WRITE int@1") == 0);
+
+    // cyklus sa neodstráni, skok späť nie je prázdny
+    genCode(INS_LABEL, "&while1", NULL, NULL);
+    genCode(INS_JUMPIFEQ, "&while1!", "GF@a$1", "int@0");
+    genCode(INS_JUMP, "&while1", NULL, NULL);
+    genCode(INS_LABEL, "&while1!", NULL, NULL);
+    TEST(optDeadCode(&code_main) == 0);
+    code_main.used = 0;
+
+    genDestroy();
+    AtomPoolDestroy();
+
+    if(failures != 0)
+    {
+        printf("Total tests failed: %d\n", failures);
+    }
+    else{
+        printf("Everything OK\n");
+    }
+
+    return 0;
+}
@@ -56,6 +56,10 @@ int main()
         if (tkn != NULL)
         {
             printf("%s\n", tkn_ids[tkn->type]);
+            // identifikátor je atóm s rozptylovou hodnotou počítanou skenerom
+            if (tkn->type == ID && (tkn->atom != AtomIntern(StrRead(&(tkn->atr))) ||
+                tkn->atom->hash != StrHash(StrRead(&(tkn->atr)))))
+                printf("BAD ATOM %s\n", StrRead(&(tkn->atr)));
             destroyToken(tkn);
         }
         tkn = getToken();
@@ -69,6 +73,8 @@ int main()
         }
         destroyToken(tkn);
     } 
+    destroyScanner();
+    AtomPoolDestroy();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+func add(_ a: Int, _ b: Int) -> Int {
+    let c = a + b
+    return c
+}
+
+func greet(name n: String) {
+    write("hello ", n, "\n")
+}
+
+var i = 0
+while i < 3 {
+    let s = add(i, 1)
+    if s > 2 {
+        let t = s * 2
+        write(t, "\n")
+    } else {
+        greet(name: "x")
+    }
+    i = i + 1
+}
+let l = length("abc")
+write(l, "\n")
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+make || exit 1
+
+echo "Executing stats tests"
+
+# štatistiky idú na stderr, vygenerovaný kód sa zahodí
+./main.out --stats=json <stats.swift 2>stats.result >/dev/null
+result=$?
+if [ ${result} -ne 0 ]; then
+    echo "[FAIL] stats.swift failed to compile, err #${result}"
+    exit 0
+fi
+
+if diff -u stats.json stats.result; then
+    echo "[PASS] - statistics match stats.json"
+else
+    echo "[FAIL] - statistics differ from stats.json"
+fi
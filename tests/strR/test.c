@@ -16,7 +16,8 @@ int main()
     str_T s;
     StrInit(&s);
     TEST(s.size == STR_INIT_SIZE);
-    TEST(s.data[0] == '\0');
+    TEST(s.data == NULL);   // krátky reťazec je uložený priamo v štruktúre
+    TEST(StrLen(&s) == 0);
     TEST(StrRead(&s)[0] == '\0');
 
     StrFillWith(&s, "C retazec");
@@ -35,6 +36,29 @@ int main()
 
     StrCatString(&alphabet, "C retazec");
     TEST(strcmp(StrRead(&alphabet), "abcdefghijklmnopqrstuvwxyzC retazecC retazec") == 0);
+    TEST(StrLen(&alphabet) == strlen(StrRead(&alphabet)));
+    TEST(alphabet.data != NULL);
+
+    // kópia krátkeho reťazca je nezávislá na originále
+    str_T copy = s;
+    StrAppend(&copy, '!');
+    TEST(strcmp(StrRead(&s), "C retazec") == 0);
+    TEST(strcmp(StrRead(&copy), "C retazec!") == 0);
+
+    StrTrunc(&alphabet, 3);
+    TEST(strcmp(StrRead(&alphabet), "abc") == 0);
+    TEST(StrLen(&alphabet) == 3);
+
+    StrCat(&alphabet, &alphabet);
+    TEST(strcmp(StrRead(&alphabet), "abcabc") == 0);
+
+    str_T big;
+    StrInit(&big);
+    for (int i = 0; i < 100000; i++) StrAppend(&big, 'a' + i % 26);
+    TEST(StrLen(&big) == 100000);
+    TEST(StrRead(&big)[99999] == 'a' + 99999 % 26);
+    TEST(StrRead(&big)[100000] == '\0');
+    StrDestroy(&big);
 
     if(failures != 0)
     {
@@ -27,7 +27,7 @@ void test() {
     SymTabInsertGlobal(table, element);
     TEST(table->global->used == 1);
     TEST((element = SymTabLookup(table, keys[0])) != NULL);
-    TEST(strcmp(element->id, keys[0]) == 0);
+    TEST(strcmp(element->id->text, keys[0]) == 0);
     
     SymTabAddLocalBlock(table);
     TEST(table->global->next == table->local);
@@ -36,11 +36,11 @@ void test() {
 
     TEST(SymTabLookupLocal(table, keys[0]) == NULL);
     TEST((element = SymTabLookupGlobal(table, keys[0])) != NULL);
-    TEST(strcmp(element->id, keys[0]) == 0);
+    TEST(strcmp(element->id->text, keys[0]) == 0);
     TEST((element = SymTabLookupLocal(table, keys[1])) != NULL);
-    TEST(strcmp(element->id, keys[1]) == 0);
+    TEST(strcmp(element->id->text, keys[1]) == 0);
     TEST((element = SymTabLookup(table, keys[0])) != NULL);
-    TEST(strcmp(element->id, keys[0]) == 0);
+    TEST(strcmp(element->id->text, keys[0]) == 0);
 
     SymTabRemoveLocalBlock(table);
     SymTabDestroy(table);
@@ -48,9 +48,180 @@ void test() {
     free(table);
 }
 
+void test_shadowing() {
+    SymTab_T table;
+    SymTabInit(&table);
+
+    TSData_T *global = SymTabCreateElement("x");
+    SymTabInsertGlobal(&table, global);
+
+    SymTabAddLocalBlock(&table);
+    TSData_T *outer = SymTabCreateElement("x");
+    SymTabInsertLocal(&table, outer);
+    SymTabAddLocalBlock(&table);
+    SymTabAddLocalBlock(&table);
+    TSData_T *inner = SymTabCreateElement("x");
+    SymTabInsertLocal(&table, inner);
+
+    TEST(table.local->depth == 3);
+    TEST(SymTabLookup(&table, "x") == inner);
+    TEST(SymTabLookupLocal(&table, "x") == inner);
+    TEST(SymTabLookupGlobal(&table, "x") == global);
+
+    // vloženie do globálneho bloku pod zatieneným kľúčom
+    TSData_T *fn = SymTabCreateElement("f");
+    SymTabInsertLocal(&table, fn);
+    TSData_T *fn_global = SymTabCreateElement("f");
+    SymTabInsertGlobal(&table, fn_global);
+    TEST(SymTabLookup(&table, "f") == fn);
+    TEST(SymTabLookupGlobal(&table, "f") == fn_global);
+
+    SymTabRemoveLocalBlock(&table);
+    TEST(SymTabLookup(&table, "x") == outer);
+    TEST(SymTabLookupLocal(&table, "x") == NULL);
+    TEST(SymTabLookup(&table, "f") == fn_global);
+    SymTabRemoveLocalBlock(&table);
+    TEST(SymTabLookupLocal(&table, "x") == outer);
+    SymTabRemoveLocalBlock(&table);
+    TEST(SymTabLookup(&table, "x") == global);
+    TEST(table.local == table.global);
+    TEST(table.global->next == NULL);
+
+    // bloky sa používajú opakovane
+    SymTabAddLocalBlock(&table);
+    TEST(table.spare != NULL);
+    TEST(table.local->used == 0);
+    TEST(SymTabLookupLocal(&table, "x") == NULL);
+    SymTabRemoveLocalBlock(&table);
+
+    SymTabDestroy(&table);
+}
+
+void test_many() {
+    SymTab_T table;
+    SymTabInit(&table);
+    char key[32];
+
+    for (int i = 0; i < 900; i++) {
+        sprintf(key, "g%d", i);
+        SymTabInsertGlobal(&table, SymTabCreateElement(key));
+    }
+    SymTabAddLocalBlock(&table);
+    for (int i = 0; i < 900; i += 2) {
+        sprintf(key, "g%d", i);
+        SymTabInsertLocal(&table, SymTabCreateElement(key));
+    }
+    TEST(table.size >= 2 * table.used);
+
+    int wrong = 0;
+    for (int i = 0; i < 900; i++) {
+        sprintf(key, "g%d", i);
+        TSData_T *elem = SymTabLookup(&table, key);
+        if (elem == NULL || elem->block != (i % 2 == 0 ? table.local : table.global)) wrong++;
+    }
+    TEST(wrong == 0);
+
+    SymTabRemoveLocalBlock(&table);
+    wrong = 0;
+    for (int i = 0; i < 900; i++) {
+        sprintf(key, "g%d", i);
+        TSData_T *elem = SymTabLookup(&table, key);
+        if (elem == NULL || elem->block != table.global) wrong++;
+    }
+    TEST(wrong == 0);
+    TEST(table.used == 900);
+
+    SymTabDestroy(&table);
+}
+
+void test_atoms() {
+    SymTab_T table;
+    SymTabInit(&table);
+
+    atom_T *abc = AtomIntern("abc");
+    TEST(AtomIntern("abc") == abc);
+    TEST(AtomFind("abc", StrHash("abc")) == abc);
+    TEST(AtomFind("abd", StrHash("abd")) == NULL);
+
+    // druh atómu
+    TEST(abc->kind == ATOM_ID);
+    TEST(AtomIntern("while")->kind == ATOM_KW_WHILE);
+    TEST(AtomIntern("write")->kind == ATOM_BIF_WRITE);
+    TEST(AtomIntern("String")->kind == ATOM_KW_STRING);
+    TEST(AtomIntern("readString")->kind == ATOM_BIF_READSTRING);
+    TEST(AtomIntern("readDouble")->kind == ATOM_BIF_READDOUBLE);
+    TEST(AtomIntern("readDoublE")->kind == ATOM_ID);
+    TEST(AtomIntern("string")->kind == ATOM_ID);
+    TEST(ATOM_IS_KEYWORD(AtomIntern("nil")->kind));
+    TEST(ATOM_IS_BIF(AtomIntern("chr")->kind));
+
+    TSData_T *elem = SymTabCreateElementAtom(abc);
+    TEST(elem->id == abc);
+    SymTabInsertGlobal(&table, elem);
+    TEST(SymTabLookupAtom(&table, abc) == elem);
+    TEST(SymTabLookupGlobalAtom(&table, abc) == elem);
+    TEST(SymTabLookupLocalAtom(&table, abc) == elem);
+    TEST(SymTabLookup(&table, "abc") == elem);
+    TEST(SymTabLookupAtom(&table, AtomIntern("abd")) == NULL);
+    TEST(SymTabLookupAtom(&table, NULL) == NULL);
+
+    // prvok vytvorený z reťazca zdieľa atóm
+    TSData_T *plain = SymTabCreateElement("abc");
+    TEST(plain->id == abc);
+    SymTabDestroyElement(plain);
+
+    SymTabDestroy(&table);
+}
+
+void test_growth() {
+    SymTab_T table;
+    SymTabInit(&table);
+    char key[32];
+    int wrong = 0;
+    bool migrated = false;
+
+    // kľúče vkladané a odstraňované aj počas postupného zväčšovania tabuľky
+    for (int i = 0; i < 100000; i++) {
+        sprintf(key, "v%d", i);
+        SymTabInsertGlobal(&table, SymTabCreateElement(key));
+        if (table.old_slots != NULL) migrated = true;
+        if (i % 1000 == 0) {
+            SymTabAddLocalBlock(&table);
+            for (int j = 0; j < 50; j++) {
+                sprintf(key, "v%d", i - j);
+                SymTabInsertLocal(&table, SymTabCreateElement(key));
+                sprintf(key, "l%d_%d", i, j);
+                SymTabInsertLocal(&table, SymTabCreateElement(key));
+            }
+            sprintf(key, "v%d", i);
+            if (SymTabLookup(&table, key)->block != table.local) wrong++;
+            SymTabRemoveLocalBlock(&table);
+        }
+    }
+    TEST(migrated);
+    TEST(table.used == 100000);
+    TEST(table.global->used == 100000);
+    TEST(table.size >= 2 * table.used);
+
+    for (int i = 0; i < 100000; i++) {
+        sprintf(key, "v%d", i);
+        TSData_T *elem = SymTabLookup(&table, key);
+        if (elem == NULL || strcmp(elem->id->text, key) != 0 || elem->block != table.global) wrong++;
+        sprintf(key, "l%d_0", i);
+        if (SymTabLookup(&table, key) != NULL) wrong++;
+    }
+    TEST(wrong == 0);
+
+    SymTabDestroy(&table);
+}
+
 int main()
 {
     test();
+    test_shadowing();
+    test_many();
+    test_atoms();
+    test_growth();
     if(failures != 0)
     {
         printf("Total tests failed: %d\n", failures);
@@ -58,5 +229,6 @@ int main()
     else{
         printf("Everything OK\n");
     }
+    AtomPoolDestroy();
     return 0;
 }
\ No newline at end of file
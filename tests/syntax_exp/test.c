@@ -3,6 +3,7 @@
 
 void create_variable_info(char* id, char var_type, bool init) {
     TSData_T* var = SymTabCreateElement(id);
+    var->codename = var->id;
     var->type = var_type;
     var->init = init;
 
@@ -0,0 +1,19 @@
+// vstavané funkcie s konštantnými argumentmi sa vyhodnocujú počas prekladu
+let a = length("abc")
+let b = ord("A")
+let c = ord("")
+let d = chr(65)
+let e = chr(35)
+let f = chr(32)
+let g = Int2Double(3)
+let h = Double2Int(2.5)
+let i = substring(of: "hello", startingAt: 1, endingBefore: 3)
+let j = substring(of: "hello", startingAt: 5, endingBefore: 5)
+let k = substring(of: "hello", startingAt: 2, endingBefore: 2)
+let l = substring(of: "hello", startingAt: 3, endingBefore: 2)
+let m = substring(of: "hello", startingAt: 0, endingBefore: 6)
+let n = substring(of: "a b#c\\d\n", startingAt: 1, endingBefore: 8)
+let o = substring(of: "", startingAt: 0, endingBefore: 0)
+let p = length("a\tb\u{41}")
+let r = length("čau")
+write(a, " ", b, " ", c, " [", d, e, f, "] ", g, " ", h, " ", i, " ", j, " [", k, "] ", l, " ", m, " [", n, "] ", o, " ", p, " ", r, "\n")
@@ -0,0 +1,40 @@
+var i = 0
+var s = ""
+while i + 1 <= 5 {
+    if i != 2 {
+        s = s + "a"
+    } else {
+        s = s + "b"
+    }
+    if i * 2 >= 6 {
+        s = s + "c"
+    } else {}
+    if i == 4 {
+        s = s + "d"
+    } else {}
+    if (i < 1) == (i > 3) {
+        s = s + "e"
+    } else {}
+    i = i + 1
+}
+write(s, "\n")
+let x : Double? = nil
+if x == nil {
+    write("nil\n")
+} else {
+    write("value\n")
+}
+let d = 2.5
+if d > 2 {
+    write("gt\n")
+} else {
+    write("le\n")
+}
+if "abc" < "abd" {
+    write("lt\n")
+} else {
+    write("ge\n")
+}
+while 1 > 2 {
+    write("never\n")
+}
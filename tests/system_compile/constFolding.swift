@@ -0,0 +1,49 @@
+func half() -> Double {
+    return 1 + 2
+}
+let a = 2 * 3 + 4
+write(a, "\n")
+let b = (0 - 7) / 2
+write(b, "\n")
+let c = 7 / (0 - 2)
+write(c, "\n")
+let big = 9223372036854775807 + 1
+write(big, "\n")
+var d : Double = 10 / 4
+write(d, "\n")
+d = 1.5 * 2 + 1
+write(d, "\n")
+let s = "a b" + "#c" + "\\"
+write(s, "\n")
+if 1 < 2 {
+    write("lt\n")
+} else {
+    write("ge\n")
+}
+if "ab" >= "b" {
+    write("ge\n")
+} else {
+    write("lt\n")
+}
+if (1 == 1) == (2.0 != 2) {
+    write("eq\n")
+} else {
+    write("neq\n")
+}
+let n = nil ?? 5 + 1
+write(n, "\n")
+let m = a ?? 8
+write(m, "\n")
+let h = half()
+write(h, "\n")
+// Int literal vľavo od Double sa prevedie rovnako ako vpravo
+let lt = 3 < 4.5
+write(lt, "\n")
+let eqd = 3 == 4.5
+write(eqd, "\n")
+var dv = 1.5
+if 2 >= dv {
+    write("ge\n")
+} else {
+    write("lt\n")
+}
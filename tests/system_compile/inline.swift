@@ -0,0 +1,46 @@
+// malé funkcie, ktoré sa s --inline vkladajú do miesta volania
+func clamp(_ x : Int, max m : Int) -> Int {
+    if x > m {
+        return m
+    } else {}
+    return x
+}
+
+func square(_ x : Int) -> Int {
+    let y = x * x
+    return y
+}
+
+func sign(_ x : Int, _ _ : Int) -> String {
+    if x < 0 {
+        return "-"
+    } else {
+        if x == 0 {
+            return "0"
+        } else {
+            return "+"
+        }
+    }
+}
+
+func sumSquares(_ n : Int) -> Int {
+    var s = 0
+    var i = 1
+    while i <= n {
+        let q = square(i)
+        s = s + q
+        i = i + 1
+    }
+    return s
+}
+
+var i = 0 - 2
+while i < 3 {
+    let c = clamp(i, max: 1)
+    let g = sign(i, 0)
+    write(g, c, " ")
+    i = i + 1
+}
+let t = sumSquares(10)
+let u = square(t)
+write("\n", t, " ", u, "\n")
@@ -0,0 +1,40 @@
+func triangle(_ n : Int) -> Int {
+    var sum = 0
+    var i = 1
+    while i <= n {
+        let step = i
+        sum = sum + step
+        i = i + 1
+    }
+    return sum
+}
+
+var i = 0
+var out = ""
+while i < 3 {
+    var j = 0
+    while j < i {
+        let mark = "*"
+        out = out + mark
+        j = j + 1
+    }
+    out = out + "|"
+    i = i + 1
+}
+write(out, "\n")
+
+var never = 0
+while never > 0 {
+    never = never - 1
+}
+while 1 > 2 {
+    write("unreachable\n")
+}
+let limit : Int? = nil
+var k = 0
+while k < (limit ?? 4) {
+    k = k + 1
+}
+let t10 = triangle(10)
+let t0 = triangle(0)
+write(never, " ", k, " ", t10, " ", t0, "\n")
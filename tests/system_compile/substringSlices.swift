@@ -0,0 +1,32 @@
+// výrezy s konštantnými hranicami sa vkladajú do miesta volania, dlhé výrezy skladá funkcia substring po úsekoch
+var s = "Hello, world"
+let a = substring(of: s, startingAt: 0, endingBefore: 5)
+let b = substring(of: s, startingAt: 7, endingBefore: 12)
+let c = substring(of: s, startingAt: 12, endingBefore: 12)
+let d = substring(of: s, startingAt: 8, endingBefore: 13)
+let e = substring(of: s, startingAt: 3, endingBefore: 2)
+let f = substring(of: s, startingAt: 11, endingBefore: 11)
+write(a, "|", b, "|", c, "|", d, "|", e, "|", f, "|\n")
+
+var big = "0123456789"
+var k = 0
+while k < 7 {
+    big = big + big
+    k = k + 1
+}
+var i = 0
+var j = 1280
+let whole = substring(of: big, startingAt: i, endingBefore: j)
+i = 3
+j = 1277
+let part = substring(of: big, startingAt: i, endingBefore: j)
+if let whole {
+    let n = length(whole)
+    write(n, " ")
+} else {}
+if let part {
+    let n = length(part)
+    let head = substring(of: part, startingAt: 0, endingBefore: 4)
+    let tail = substring(of: part, startingAt: 1270, endingBefore: 1274)
+    write(n, " ", head, " ", tail, "\n")
+} else {}
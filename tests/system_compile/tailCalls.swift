@@ -0,0 +1,57 @@
+// rekurzia v koncovej pozícii sa prekladá ako skok, hĺbka rekurzie nie je obmedzená zásobníkom rámcov
+func sumTo(_ n : Int, _ acc : Int) -> Int {
+    if n == 0 {
+        return acc
+    } else {
+        let m = n - 1
+        let a = acc + n
+        let r = sumTo(m, a)
+        return r
+    }
+}
+
+func swapCount(_ a : Int, _ b : Int, times k : Int) -> Int {
+    if k == 0 {
+        let d = a * 10 + b
+        return d
+    } else {
+        let j = k - 1
+        let r = swapCount(b, a, times: j)
+        return r
+    }
+}
+
+func stars(_ n : Int, _ line : String) {
+    if n > 0 {
+        var i = 0
+        var s = line
+        while i < n {
+            let star = "*"
+            s = s + star
+            i = i + 1
+        }
+        write(s, "\n")
+        let m = n - 1
+        stars(m, line)
+    } else {}
+}
+
+func skip(_ n : Int, _ _ : Int) -> Int? {
+    var left : Int? = nil
+    if n > 0 {
+        let m = n - 1
+        let r = skip(m, n)
+        return r
+    } else {
+        return left
+    }
+}
+
+let s = sumTo(1000, 0)
+let c = swapCount(1, 2, times: 3)
+write(s, " ", c, "\n")
+stars(3, ">")
+let k = skip(5, 0)
+if k == nil {
+    write("nil\n")
+} else {}
@@ -0,0 +1,107 @@
+#include "../../timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int failures = 0;
+
+#define TEST(cond)                                    \
+    if (!(cond))                                      \
+    {                                                 \
+        printf("FAIL[ln %d]\t%s\n", __LINE__, #cond); \
+        failures++;                                   \
+    }
+
+#define FILE_NAME "timer_test.result"
+#define MAX_LINES 32
+
+char lines[MAX_LINES][128];
+int line_count;
+
+/**
+ * @brief Presmeruje stderr do súboru, vypíše správu a načíta ju po riadkoch do lines
+*/
+void report() {
+    fflush(stderr);
+    if (freopen(FILE_NAME, "w", stderr) == NULL) exit(1);
+    timerReport();
+    fflush(stderr);
+    FILE *f = fopen(FILE_NAME, "r");
+    if (f == NULL) exit(1);
+    line_count = 0;
+    while (line_count < MAX_LINES && fgets(lines[line_count], sizeof(lines[0]), f) != NULL) line_count++;
+    fclose(f);
+    remove(FILE_NAME);
+}
+
+/**
+ * @brief Riadok index začína odsadením level a názvom fázy name, nasleduje počet volaní calls
+*/
+int hasLine(int index, int level, const char *name, unsigned long long calls) {
+    if (index >= line_count) return 0;
+    const char *line = lines[index];
+    for (int i = 0; i < 2 * level; i++) {
+        if (line[i] != ' ') return 0;
+    }
+    line += 2 * level;
+    size_t len = strlen(name);
+    if (strncmp(line, name, len) != 0 || line[len] != ' ') return 0;
+    unsigned long long got;
+    return sscanf(line + len, "%llu", &got) == 1 && got == calls;
+}
+
+int main()
+{
+    // vypnuté meranie nič nezaznamená
+    TIMER_BEGIN(TIMER_COMPILE);
+    TIMER_END();
+    report();
+    TEST(line_count == 0);
+
+    timer_enabled = true;
+    TIMER_BEGIN(TIMER_COMPILE);
+    for (int i = 0; i < 3; i++) {
+        TIMER_BEGIN(TIMER_SCAN);
+        TIMER_END();
+    }
+    // if vnorený v if sa započíta vonkajšiemu, výraz vo vnorenom if patrí pod vonkajší if
+    TIMER_BEGIN(TIMER_STAT_IF);
+    TIMER_BEGIN(TIMER_EXPRESSION);
+    TIMER_BEGIN(TIMER_GEN_CODE);
+    TIMER_END();
+    TIMER_END();
+    TIMER_BEGIN(TIMER_STAT_WHILE);
+    TIMER_BEGIN(TIMER_STAT_IF);
+    TIMER_BEGIN(TIMER_EXPRESSION);
+    TIMER_END();
+    TIMER_END();
+    TIMER_END();
+    TIMER_END();
+    // nedokončená fáza COMPILE sa uzavrie pri výpise
+    report();
+
+    TEST(line_count == 7);
+    TEST(strncmp(lines[0], "phase", 5) == 0);
+    TEST(hasLine(1, 0, "compile", 1));
+    TEST(hasLine(2, 1, "scan", 3));
+    TEST(hasLine(3, 1, "stat if", 2));
+    TEST(hasLine(4, 2, "stat while", 1));
+    TEST(hasLine(5, 2, "expression", 2));
+    TEST(hasLine(6, 3, "genCode", 1));
+
+    // výpis uvoľní strom, ďalšie meranie začína odznova
+    TIMER_BEGIN(TIMER_EMIT);
+    TIMER_END();
+    report();
+    TEST(line_count == 2);
+    TEST(hasLine(1, 0, "emit", 1));
+
+    if(failures != 0)
+    {
+        printf("Total tests failed: %d\n", failures);
+    }
+    else{
+        printf("Everything OK\n");
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+/** Projekt IFJ2023
+ * @file timer.c
+ * @brief Meranie času fáz prekladu (prepínač --time-report)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "timer.h"
+#include "parser.h"
+#include "mem.h"
+
+bool timer_enabled = false;
+
+/// Názvy fáz vo výpise, indexované timerPhase_T
+static const char *timer_names[] = {
+    "compile", "scan", "stat let/var", "stat assign/call", "stat block", "stat func",
+    "stat return", "stat if", "stat while", "expression", "genCode", "symtable", "optimize", "emit"
+};
+
+/**
+ * @brief Uzol stromu ciest, koreň má index 0
+*/
+typedef struct timer_node {
+    timerPhase_T phase;
+    int parent;                     ///< index nadradeného uzla, -1 pri koreni
+    int child[TIMER_PHASES];        ///< index podradeného uzla pre fázu, 0 ak ešte neexistuje
+    uint64_t calls;                 ///< počet začiatkov fázy na tejto ceste
+    uint64_t inclusive;             ///< ns vrátane vnorených fáz
+    uint64_t exclusive;             ///< ns bez vnorených fáz
+} timerNode_T;
+
+/**
+ * @brief Rozpracovaná fáza
+*/
+typedef struct timer_frame {
+    int node;
+    uint64_t start;
+    bool folded;                    ///< fáza bola už na ceste, čas sa počíta vonkajšiemu výskytu
+} timerFrame_T;
+
+static struct {
+    timerNode_T *nodes;
+    int used;
+    timerFrame_T *frames;           ///< zásobník rozpracovaných fáz
+    size_t depth;
+    size_t size;
+    uint64_t last;                  ///< čas posledného začiatku alebo konca fázy
+} timer;
+
+/**
+ * @brief Monotónny čas v ns
+*/
+static uint64_t timerNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Ukončí prekladač pri chybe alokácie
+*/
+static void *timerAlloc(void *ptr, size_t size) {
+    void *new_ptr = memRealloc(MEM_DIAG, ptr, size);
+    if (new_ptr == NULL) {
+        fprintf(stderr, "timer memory allocation error.\n");
+        exit(COMPILER_ERROR);
+    }
+    return new_ptr;
+}
+
+/**
+ * @brief Pridá uzol pre fázu phase pod uzol parent
+*/
+static int timerAddNode(int parent, timerPhase_T phase) {
+    if (timer.nodes == NULL) timer.nodes = timerAlloc(NULL, TIMER_MAX_NODES * sizeof(timerNode_T));
+    timerNode_T *node = &timer.nodes[timer.used];
+    *node = (timerNode_T){phase, parent, {0}, 0, 0, 0};
+    if (parent >= 0) timer.nodes[parent].child[phase] = timer.used;
+    return timer.used++;
+}
+
+void timerBegin(timerPhase_T phase) {
+    uint64_t now = timerNow();
+    int current = -1;
+    if (timer.depth > 0) {
+        current = timer.frames[timer.depth - 1].node;
+        timer.nodes[current].exclusive += now - timer.last;
+    }
+    timer.last = now;
+
+    // fáza už na ceste k aktuálnemu uzlu, alebo nový uzol
+    int node = current;
+    while (node >= 0 && timer.nodes[node].phase != phase) node = timer.nodes[node].parent;
+    bool folded = node >= 0;
+    if (!folded) {
+        if (current < 0 && timer.used > 0) node = 0;
+        else if (current >= 0 && timer.nodes[current].child[phase] != 0) node = timer.nodes[current].child[phase];
+        else if (timer.used < TIMER_MAX_NODES) node = timerAddNode(current, phase);
+        else {
+            node = current; // strom je plný, čas patrí nadradenej fáze
+            folded = true;
+        }
+    }
+    timer.nodes[node].calls++;
+
+    if (timer.depth == timer.size) {
+        timer.size = timer.size == 0 ? 64 : 2 * timer.size;
+        timer.frames = timerAlloc(timer.frames, timer.size * sizeof(timerFrame_T));
+    }
+    timer.frames[timer.depth++] = (timerFrame_T){node, now, folded};
+}
+
+void timerEnd() {
+    if (timer.depth == 0) return;
+    uint64_t now = timerNow();
+    timerFrame_T *frame = &timer.frames[--timer.depth];
+    timerNode_T *node = &timer.nodes[frame->node];
+    node->exclusive += now - timer.last;
+    if (!frame->folded) node->inclusive += now - frame->start;
+    timer.last = now;
+}
+
+/**
+ * @brief Vypíše uzol a jeho podstrom, podradené fázy v poradí timerPhase_T
+*/
+static void timerPrintNode(int index, int level, uint64_t total) {
+    timerNode_T *node = &timer.nodes[index];
+    fprintf(stderr, "%*s%-*s %12llu %12.3f %12.3f %7.1f\n", 2 * level, "", 28 - 2 * level,
+        timer_names[node->phase], (unsigned long long)node->calls, node->inclusive / 1e6,
+        node->exclusive / 1e6, total > 0 ? 100.0 * node->inclusive / total : 0.0);
+    for (int p = 0; p < TIMER_PHASES; p++) {
+        if (node->child[p] != 0) timerPrintNode(node->child[p], level + 1, total);
+    }
+}
+
+void timerReport() {
+    // nedokončené fázy sa uzavrú, aby ich čas nechýbal
+    while (timer.depth > 0) timerEnd();
+    if (timer.used > 0) {
+        fprintf(stderr, "%-28s %12s %12s %12s %7s\n", "phase", "calls", "incl [ms]", "excl [ms]", "incl %");
+        timerPrintNode(0, 0, timer.nodes[0].inclusive);
+    }
+    memFree(MEM_DIAG, timer.nodes);
+    memFree(MEM_DIAG, timer.frames);
+    timer.nodes = NULL;
+    timer.frames = NULL;
+    timer.used = 0;
+    timer.depth = timer.size = 0;
+}
+
+/* Koniec súboru timer.c */
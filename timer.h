@@ -0,0 +1,77 @@
+/** Projekt IFJ2023
+ * @file timer.h
+ * @brief Meranie času fáz prekladu (prepínač --time-report)
+ */
+
+#ifndef _TIMER_H_
+#define _TIMER_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Merané fázy prekladu
+*/
+typedef enum timer_phase {
+    TIMER_COMPILE,      ///< celý preklad
+    TIMER_SCAN,         ///< getToken
+    TIMER_STAT_DECL,    ///< príkaz let/var
+    TIMER_STAT_ID,      ///< priradenie alebo volanie funkcie
+    TIMER_STAT_BLOCK,   ///< blok { }
+    TIMER_STAT_FUNC,    ///< definícia funkcie
+    TIMER_STAT_RETURN,  ///< príkaz return
+    TIMER_STAT_IF,      ///< príkaz if
+    TIMER_STAT_WHILE,   ///< príkaz while
+    TIMER_EXPRESSION,   ///< parseExpression, parseCondition, parseLoopCondition
+    TIMER_GEN_CODE,     ///< genCode
+    TIMER_SYMTAB,       ///< vyhľadávanie a vkladanie v tabuľke symbolov, rozsahy platnosti
+    TIMER_OPTIMIZE,     ///< odstránenie mŕtveho kódu a peephole optimalizácia
+    TIMER_EMIT,         ///< výpis cieľového kódu
+    TIMER_PHASES        ///< počet fáz
+} timerPhase_T;
+
+#define TIMER_MAX_NODES 1024 ///< najväčší počet rôznych ciest vo výpise, ďalšie sa započítajú do nadradenej
+
+/**
+ * @brief Meranie je zapnuté, inak TIMER_BEGIN a TIMER_END iba otestujú túto premennú
+*/
+extern bool timer_enabled;
+
+/**
+ * @brief Začiatok fázy, ak je meranie zapnuté
+*/
+#define TIMER_BEGIN(phase)                  \
+    do {                                    \
+        if (timer_enabled) timerBegin(phase); \
+    } while (0)
+
+/**
+ * @brief Koniec naposledy začatej fázy, ak je meranie zapnuté
+*/
+#define TIMER_END()                         \
+    do {                                    \
+        if (timer_enabled) timerEnd();      \
+    } while (0)
+
+/**
+ * Fázy sa agregujú podľa cesty z vonkajších fáz (napr. while > výraz > genCode). Ak je fáza už na ceste
+ * (rekurzia, napr. if v tele while v tele if), započíta sa do tej vonkajšej, strom ciest je preto konečný.
+ *
+ * @brief Začne meranie fázy phase vnorenej v práve meranej fáze
+*/
+void timerBegin(timerPhase_T phase);
+
+/**
+ * @brief Ukončí meranie naposledy začatej fázy
+*/
+void timerEnd();
+
+/**
+ * Pre každú cestu vypíše počet volaní, inkluzívny čas (vrátane vnorených fáz) a exkluzívny čas
+ * (iba samotná fáza). Súčet exkluzívnych časov je celkový čas.
+ *
+ * @brief Vypíše na stderr strom nameraných fáz a uvoľní zdroje merania
+*/
+void timerReport();
+
+#endif // ifndef _TIMER_H_
+/* Koniec súboru timer.h */